@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   AlignedArray.cpp
+//! \brief  The aligned memory allocation functions used by AlignedArray.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "AlignedArray.hpp"
+#include <malloc.h>
+#include <new>
+
+////////////////////////////////////////////////////////////////////////////////
+// Avoid bringing in <windows.h>.
+
+#if (!defined(__GNUC__)) || (defined(__GNUC__) && !defined(_WINBASE_H))
+
+extern "C" void* __stdcall VirtualAlloc(void* address, size_t size, unsigned long type, unsigned long protect);
+extern "C" int __stdcall VirtualFree(void* address, size_t size, unsigned long type);
+extern "C" size_t __stdcall GetLargePageMinimum();
+
+#define MEM_COMMIT			0x00001000
+#define MEM_RESERVE			0x00002000
+#define MEM_RELEASE			0x00008000
+#define MEM_LARGE_PAGES		0x20000000
+#define PAGE_READWRITE		0x04
+
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Allocate a block of memory with the specified alignment, which must be a
+//! power of two. If large pages are requested they are used when the block is
+//! at least a large page in size and the process has the "Lock pages in memory"
+//! privilege. In that case the size is rounded up to a whole number of pages.
+//! On return the flag indicates whether large pages were used. Throws
+//! std::bad_alloc if the memory cannot be allocated.
+
+void* allocateAligned(size_t& bytes, size_t alignment, bool& largePages)
+{
+	ASSERT((alignment != 0) && ((alignment & (alignment-1)) == 0));
+
+	if (largePages)
+	{
+		const size_t pageSize = ::GetLargePageMinimum();
+
+		largePages = false;
+
+		if ( (pageSize != 0) && (bytes >= pageSize) && (alignment <= pageSize) )
+		{
+			const size_t rounded = (bytes + pageSize - 1) & ~(pageSize - 1);
+			void*        block = ::VirtualAlloc(nullptr, rounded, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE);
+
+			if (block != nullptr)
+			{
+				bytes = rounded;
+				largePages = true;
+				return block;
+			}
+		}
+	}
+
+	void* block = ::_aligned_malloc((bytes != 0) ? bytes : 1, alignment);
+
+	if (block == nullptr)
+		throw std::bad_alloc();
+
+	return block;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Free a block of memory allocated with allocateAligned(). The block can be
+//! null.
+
+void freeAligned(void* block, bool largePages)
+{
+	if (block == nullptr)
+		return;
+
+	if (largePages)
+		::VirtualFree(block, 0, MEM_RELEASE);
+	else
+		::_aligned_free(block);
+}
+
+//namespace Core
+}
@@ -0,0 +1,375 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   AlignedArray.hpp
+//! \brief  The AlignedArray class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_ALIGNEDARRAY_HPP
+#define CORE_ALIGNEDARRAY_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "CacheLine.hpp"
+#include <string.h>
+#include <algorithm>
+
+namespace Core
+{
+
+//! Allocate a block of memory with the specified alignment.
+void* allocateAligned(size_t& bytes, size_t alignment, bool& largePages);
+
+//! Free a block of memory allocated with allocateAligned().
+void freeAligned(void* block, bool largePages);
+
+////////////////////////////////////////////////////////////////////////////////
+//! An array that owns a buffer with a known size and alignment, for use by
+//! vectorised code that relies on the alignment. The elements must be plain
+//! old data as they are never constructed or destroyed, only zeroed, copied or
+//! left uninitialised.
+
+template <typename T>
+class AlignedArray /*: private NotCopyable*/
+{
+public:
+	//! The default alignment, which suits all SIMD registers up to 512 bits.
+	static const size_t DEFAULT_ALIGNMENT = CACHE_LINE_SIZE;
+
+	//! The allocation flags.
+	enum Flags
+	{
+		ZERO_FILL		= 0x0000,	//!< Zero the elements.
+		UNINITIALISED	= 0x0001,	//!< Leave the elements uninitialised.
+		LARGE_PAGES		= 0x0002	//!< Back the array with large pages, if possible.
+	};
+
+	//! Default constructor.
+	AlignedArray();
+
+	//! Construction with the initial size.
+	explicit AlignedArray(size_t size, size_t alignment = DEFAULT_ALIGNMENT, uint flags = ZERO_FILL);
+
+#ifdef CORE_HAS_RVALUE_REFS
+	//! Move constructor.
+	AlignedArray(AlignedArray&& array) CORE_NOEXCEPT;
+#endif
+
+	//! Destructor.
+	~AlignedArray();
+
+	//
+	// Operators.
+	//
+
+	//! Index operator.
+	T& operator[](size_t index);
+
+	//! Index operator.
+	const T& operator[](size_t index) const;
+
+#ifdef CORE_HAS_RVALUE_REFS
+	//! Move assignment operator.
+	AlignedArray& operator=(AlignedArray&& array) CORE_NOEXCEPT;
+#endif
+
+	//
+	// Properties.
+	//
+
+	//! Get the buffer.
+	T* get();
+
+	//! Get the buffer.
+	const T* get() const;
+
+	//! Get the number of elements.
+	size_t size() const;
+
+	//! Get the number of elements that can be held without reallocating.
+	size_t capacity() const;
+
+	//! Get the alignment of the buffer.
+	size_t alignment() const;
+
+	//! Query if the array has no elements.
+	bool empty() const;
+
+	//! Query if the buffer is backed by large pages.
+	bool largePages() const;
+
+	//
+	// Methods.
+	//
+
+	//! Ensure the buffer can hold the number of elements without reallocating.
+	void reserve(size_t capacity);
+
+	//! Change the number of elements.
+	void resize(size_t size);
+
+	//! Free the buffer.
+	void reset();
+
+	//! Swap the contents with another array.
+	void swap(AlignedArray& array);
+
+private:
+	//
+	// Members.
+	//
+	T*		m_buffer;		//!< The buffer.
+	size_t	m_size;			//!< The number of elements.
+	size_t	m_capacity;		//!< The number of elements the buffer can hold.
+	size_t	m_alignment;	//!< The alignment of the buffer.
+	uint	m_flags;		//!< The allocation flags.
+	bool	m_largePages;	//!< Whether the buffer uses large pages.
+
+	// NotCopyable.
+	AlignedArray(const AlignedArray&);
+	AlignedArray& operator=(const AlignedArray&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+template <typename T>
+inline AlignedArray<T>::AlignedArray()
+	: m_buffer(nullptr)
+	, m_size(0)
+	, m_capacity(0)
+	, m_alignment(DEFAULT_ALIGNMENT)
+	, m_flags(ZERO_FILL)
+	, m_largePages(false)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the initial size. The alignment must be a power of two.
+//! Unless UNINITIALISED is specified the elements are zeroed.
+
+template <typename T>
+inline AlignedArray<T>::AlignedArray(size_t size, size_t alignment, uint flags)
+	: m_buffer(nullptr)
+	, m_size(0)
+	, m_capacity(0)
+	, m_alignment(alignment)
+	, m_flags(flags)
+	, m_largePages(false)
+{
+	ASSERT((alignment != 0) && ((alignment & (alignment-1)) == 0));
+
+	reserve(size);
+
+	if ((flags & UNINITIALISED) == 0)
+		memset(m_buffer, 0, size * sizeof(T));
+
+	m_size = size;
+}
+
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move constructor. Takes over ownership from another array, which is left
+//! empty.
+
+template <typename T>
+inline AlignedArray<T>::AlignedArray(AlignedArray&& array) CORE_NOEXCEPT
+	: m_buffer(nullptr)
+	, m_size(0)
+	, m_capacity(0)
+	, m_alignment(array.m_alignment)
+	, m_flags(array.m_flags)
+	, m_largePages(false)
+{
+	swap(array);
+}
+
+#endif // CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+template <typename T>
+inline AlignedArray<T>::~AlignedArray()
+{
+	reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Index operator. The index is only checked in a debug build.
+
+template <typename T>
+inline T& AlignedArray<T>::operator[](size_t index)
+{
+	ASSERT(index < m_size);
+
+	return m_buffer[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Index operator. The index is only checked in a debug build.
+
+template <typename T>
+inline const T& AlignedArray<T>::operator[](size_t index) const
+{
+	ASSERT(index < m_size);
+
+	return m_buffer[index];
+}
+
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move assignment operator. Frees the current buffer and takes over
+//! ownership from another array, which is left empty.
+
+template <typename T>
+inline AlignedArray<T>& AlignedArray<T>::operator=(AlignedArray&& array) CORE_NOEXCEPT
+{
+	// Ignore self-assignment.
+	if (this != &array)
+	{
+		reset();
+		swap(array);
+	}
+
+	return *this;
+}
+
+#endif // CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the buffer.
+
+template <typename T>
+inline T* AlignedArray<T>::get()
+{
+	return m_buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the buffer.
+
+template <typename T>
+inline const T* AlignedArray<T>::get() const
+{
+	return m_buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of elements.
+
+template <typename T>
+inline size_t AlignedArray<T>::size() const
+{
+	return m_size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of elements that can be held without reallocating.
+
+template <typename T>
+inline size_t AlignedArray<T>::capacity() const
+{
+	return m_capacity;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the alignment of the buffer.
+
+template <typename T>
+inline size_t AlignedArray<T>::alignment() const
+{
+	return m_alignment;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the array has no elements.
+
+template <typename T>
+inline bool AlignedArray<T>::empty() const
+{
+	return (m_size == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the buffer is backed by large pages.
+
+template <typename T>
+inline bool AlignedArray<T>::largePages() const
+{
+	return m_largePages;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Ensure the buffer can hold the number of elements without reallocating.
+//! Any existing elements are copied to the new buffer.
+
+template <typename T>
+inline void AlignedArray<T>::reserve(size_t capacity)
+{
+	if (capacity <= m_capacity)
+		return;
+
+	size_t bytes = capacity * sizeof(T);
+	bool   largePages = ((m_flags & LARGE_PAGES) != 0);
+	T*     buffer = static_cast<T*>(allocateAligned(bytes, m_alignment, largePages));
+
+	if (m_size != 0)
+		memcpy(buffer, m_buffer, m_size * sizeof(T));
+
+	freeAligned(m_buffer, m_largePages);
+
+	m_buffer = buffer;
+	m_capacity = bytes / sizeof(T);
+	m_largePages = largePages;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Change the number of elements. Any new elements are left uninitialised and
+//! shrinking the array never reallocates. The capacity is at least doubled when
+//! growing so that growing an element at a time isn't quadratic.
+
+template <typename T>
+inline void AlignedArray<T>::resize(size_t size)
+{
+	if (size > m_capacity)
+		reserve(std::max(size, 2 * m_capacity));
+
+	m_size = size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Free the buffer.
+
+template <typename T>
+inline void AlignedArray<T>::reset()
+{
+	freeAligned(m_buffer, m_largePages);
+
+	m_buffer = nullptr;
+	m_size = 0;
+	m_capacity = 0;
+	m_largePages = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Swap the contents with another array.
+
+template <typename T>
+inline void AlignedArray<T>::swap(AlignedArray& array)
+{
+	std::swap(m_buffer, array.m_buffer);
+	std::swap(m_size, array.m_size);
+	std::swap(m_capacity, array.m_capacity);
+	std::swap(m_alignment, array.m_alignment);
+	std::swap(m_flags, array.m_flags);
+	std::swap(m_largePages, array.m_largePages);
+}
+
+//namespace Core
+}
+
+#endif // CORE_ALIGNEDARRAY_HPP
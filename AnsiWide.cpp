@@ -5,17 +5,336 @@
 
 #include "Common.hpp"
 #include "AnsiWide.hpp"
+#include "Utf.hpp"
 #include <locale>
 
+// SSE2 is always available on x64 and can be requested for x86.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define CORE_ANSIWIDE_SSE2	//!< Use the SSE2 ASCII conversion kernels.
+#endif
+
 namespace Core
 {
 
+namespace
+{
+
+//! The encoding used for ANSI strings.
+AnsiEncoding s_ansiEncoding = LOCALE_ENCODING;
+
 ////////////////////////////////////////////////////////////////////////////////
-//! Convert a string from ANSI to Wide.
+//! Query if the character is in the 7-bit ASCII range, which every supported
+//! code page maps to the same Unicode code points.
+
+inline bool isAscii(char c)
+{
+	return (static_cast<uchar>(c) < 0x80);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the character is in the 7-bit ASCII range.
+
+inline bool isAscii(wchar_t c)
+{
+	return (static_cast<ulong>(c) < 0x80);
+}
+
+#ifdef CORE_ANSIWIDE_SSE2
+
+////////////////////////////////////////////////////////////////////////////////
+//! The SSE2 kernels that depend on the size of wchar_t.
+
+template<size_t N>
+struct WideKernel;
+
+////////////////////////////////////////////////////////////////////////////////
+//! The SSE2 kernels for a 16-bit wchar_t.
+
+template<>
+struct WideKernel<2>
+{
+	//! Widen 16 ASCII characters.
+	static void widen(__m128i chars, wchar_t* dest)
+	{
+		const __m128i zero = _mm_setzero_si128();
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest),   _mm_unpacklo_epi8(chars, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest+8), _mm_unpackhi_epi8(chars, zero));
+	}
+
+	//! Narrow 16 characters, if they're all ASCII.
+	static bool narrow(const wchar_t* begin, char* dest)
+	{
+		const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+		const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin+8));
+		const __m128i high = _mm_and_si128(_mm_or_si128(lo, hi), _mm_set1_epi16(static_cast<short>(0xff80)));
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(high, _mm_setzero_si128())) != 0xffff)
+			return false;
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_packus_epi16(lo, hi));
+
+		return true;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! The SSE2 kernels for a 32-bit wchar_t.
+
+template<>
+struct WideKernel<4>
+{
+	//! Widen 16 ASCII characters.
+	static void widen(__m128i chars, wchar_t* dest)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i lo = _mm_unpacklo_epi8(chars, zero);
+		const __m128i hi = _mm_unpackhi_epi8(chars, zero);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest),    _mm_unpacklo_epi16(lo, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest+4),  _mm_unpackhi_epi16(lo, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest+8),  _mm_unpacklo_epi16(hi, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest+12), _mm_unpackhi_epi16(hi, zero));
+	}
+
+	//! Narrow 16 characters, if they're all ASCII.
+	static bool narrow(const wchar_t* begin, char* dest)
+	{
+		const __m128i* src = reinterpret_cast<const __m128i*>(begin);
+		const __m128i  a = _mm_loadu_si128(src);
+		const __m128i  b = _mm_loadu_si128(src+1);
+		const __m128i  c = _mm_loadu_si128(src+2);
+		const __m128i  d = _mm_loadu_si128(src+3);
+		const __m128i  all = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+		const __m128i  high = _mm_and_si128(all, _mm_set1_epi32(static_cast<int>(0xffffff80)));
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(high, _mm_setzero_si128())) != 0xffff)
+			return false;
+
+		const __m128i lo = _mm_packs_epi32(a, b);
+		const __m128i hi = _mm_packs_epi32(c, d);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_packus_epi16(lo, hi));
+
+		return true;
+	}
+};
+
+#endif // CORE_ANSIWIDE_SSE2
+
+////////////////////////////////////////////////////////////////////////////////
+//! Widen the leading run of ASCII characters without going via the locale.
+//! Returns a pointer to the first non-ASCII character, or end.
+
+const char* widenAscii(const char* begin, const char* end, wchar_t* dest)
+{
+	const char* it = begin;
+
+#ifdef CORE_ANSIWIDE_SSE2
+	// Process 32 characters at a time whilst the block is pure ASCII.
+	while ((end - it) >= 32)
+	{
+		const __m128i first  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+		const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it+16));
+
+		if (_mm_movemask_epi8(_mm_or_si128(first, second)) != 0)
+			break;
+
+		WideKernel<sizeof(wchar_t)>::widen(first,  dest + (it - begin));
+		WideKernel<sizeof(wchar_t)>::widen(second, dest + (it - begin) + 16);
+
+		it += 32;
+	}
+#endif
+
+	// Handle the remainder and any block containing non-ASCII characters.
+	for (; (it != end) && isAscii(*it); ++it)
+		dest[it - begin] = static_cast<wchar_t>(*it);
+
+	return it;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Narrow the leading run of ASCII characters without going via the locale.
+//! Returns a pointer to the first non-ASCII character, or end.
+
+const wchar_t* narrowAscii(const wchar_t* begin, const wchar_t* end, char* dest)
+{
+	const wchar_t* it = begin;
+
+#ifdef CORE_ANSIWIDE_SSE2
+	// Process 32 characters at a time whilst the block is pure ASCII.
+	while ((end - it) >= 32)
+	{
+		if (!WideKernel<sizeof(wchar_t)>::narrow(it, dest + (it - begin)))
+			break;
+
+		if (!WideKernel<sizeof(wchar_t)>::narrow(it+16, dest + (it - begin) + 16))
+		{
+			it += 16;
+			break;
+		}
+
+		it += 32;
+	}
+#endif
+
+	// Handle the remainder and any block containing non-ASCII characters.
+	for (; (it != end) && isAscii(*it); ++it)
+		dest[it - begin] = static_cast<char>(*it);
+
+	return it;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert UTF-8 to Wide, replacing any invalid sequences with U+FFFD. The
+//! destination must be large enough to hold (end - begin) characters. Returns
+//! the number of characters written.
+
+size_t utf8ToWideLossy(const char* begin, const char* end, wchar_t* dest)
+{
+	size_t written = 0;
+
+	while (begin != end)
+	{
+		// Each byte produces at most one character so the remaining space
+		// is never less than the remaining input.
+		const UtfResult result = utf8ToWide(begin, end, dest + written, (end - begin));
+
+		begin   += result.consumed;
+		written += result.written;
+
+		if (result.status == UTF_OK)
+			break;
+
+		ASSERT(result.status != UTF_OUTPUT_FULL);
+
+		dest[written++] = static_cast<wchar_t>(0xfffd);
+		++begin;
+	}
+
+	return written;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert Wide to UTF-8, replacing any invalid characters with a '?'. The
+//! destination must be large enough to hold maxAnsiLength() characters.
+//! Returns the number of characters written.
+
+size_t wideToUtf8Lossy(const wchar_t* begin, const wchar_t* end, char* dest, size_t destSize)
+{
+	size_t written = 0;
+
+	while (begin != end)
+	{
+		const UtfResult result = wideToUtf8(begin, end, dest + written, destSize - written);
+
+		begin   += result.consumed;
+		written += result.written;
+
+		if (result.status == UTF_OK)
+			break;
+
+		ASSERT(result.status != UTF_OUTPUT_FULL);
+
+		dest[written++] = '?';
+		++begin;
+	}
+
+	return written;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert a string from ANSI to Wide using the configured encoding. The
+//! destination must be large enough to hold (end - begin) characters. Returns
+//! the number of characters written.
+
+size_t widen(const char* begin, const char* end, wchar_t* dest)
+{
+	if (s_ansiEncoding == UTF8_ENCODING)
+		return utf8ToWideLossy(begin, end, dest);
+
+	ansiToWide(begin, end, dest);
+
+	return (end - begin);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Calculate the maximum number of ANSI characters required to convert a
+//! string of the given length using the configured encoding.
+
+size_t maxAnsiLength(size_t length)
+{
+	if (s_ansiEncoding == UTF8_ENCODING)
+		return length * ((sizeof(wchar_t) == 2) ? 3 : 4);
+
+	return length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert a string from Wide to ANSI using the configured encoding. The
+//! destination must be large enough to hold maxAnsiLength() characters.
+//! Returns the number of characters written.
+
+size_t narrow(const wchar_t* begin, const wchar_t* end, char* dest)
+{
+	if (s_ansiEncoding == UTF8_ENCODING)
+		return wideToUtf8Lossy(begin, end, dest, maxAnsiLength(end - begin));
+
+	wideToAnsi(begin, end, dest);
+
+	return (end - begin);
+}
+
+//namespace
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Set the encoding used for ANSI strings. This affects all the conversions
+//! except the ones that write into a caller supplied buffer of the same length
+//! as the input, which always use the locale. It should be set during start-up
+//! before any other threads are converting strings.
+
+void setAnsiEncoding(AnsiEncoding encoding)
+{
+	s_ansiEncoding = encoding;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the encoding used for ANSI strings.
+
+AnsiEncoding getAnsiEncoding()
+{
+	return s_ansiEncoding;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert a string from ANSI to Wide. Runs of ASCII characters are converted
+//! directly and only the other characters are mapped via the current locale.
 
 void ansiToWide(const char* begin, const char* end, wchar_t* dest)
 {
-	std::use_facet< std::ctype<wchar_t> >(std::locale()).widen(begin, end, dest);
+	while (begin != end)
+	{
+		const char* ascii = widenAscii(begin, end, dest);
+
+		dest += ascii - begin;
+		begin = ascii;
+
+		const char* other = begin;
+
+		while ( (other != end) && !isAscii(*other) )
+			++other;
+
+		if (other != begin)
+		{
+			std::use_facet< std::ctype<wchar_t> >(std::locale()).widen(begin, other, dest);
+
+			dest += other - begin;
+			begin = other;
+		}
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -33,17 +352,37 @@ std::wstring ansiToWide(const char* begin, const char* end)
 	wchar_t* dest = const_cast<wchar_t*>(string.data());
 
 	// Do the conversion.
-	ansiToWide(begin, end, dest);
+	string.resize(widen(begin, end, dest));
 
 	return string;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//! Convert a string from Wide to ANSI.
+//! Convert a string from Wide to ANSI. Runs of ASCII characters are converted
+//! directly and only the other characters are mapped via the current locale.
 
 void wideToAnsi(const wchar_t* begin, const wchar_t* end, char* dest)
 {
-	std::use_facet< std::ctype<wchar_t> >(std::locale()).narrow(begin, end, '?', dest);
+	while (begin != end)
+	{
+		const wchar_t* ascii = narrowAscii(begin, end, dest);
+
+		dest += ascii - begin;
+		begin = ascii;
+
+		const wchar_t* other = begin;
+
+		while ( (other != end) && !isAscii(*other) )
+			++other;
+
+		if (other != begin)
+		{
+			std::use_facet< std::ctype<wchar_t> >(std::locale()).narrow(begin, other, '?', dest);
+
+			dest += other - begin;
+			begin = other;
+		}
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -53,7 +392,7 @@ std::string wideToAnsi(const wchar_t* begin, const wchar_t* end)
 {
 	std::string str;
 
-	size_t length = end - begin;
+	size_t length = maxAnsiLength(end - begin);
 
 	// Allocate the return value.
 	str.resize(length);
@@ -61,24 +400,47 @@ std::string wideToAnsi(const wchar_t* begin, const wchar_t* end)
 	char* dest = const_cast<char*>(str.data());
 
 	// Do the conversion.
-	wideToAnsi(begin, end, dest);
+	str.resize(narrow(begin, end, dest));
 
 	return str;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! Convert a string from ANSI to Wide using a reusable buffer. The result is
+//! valid until the buffer is next used.
+
+const wchar_t* ansiToWide(const char* begin, const char* end, WideConvertBuffer& buffer)
+{
+	wchar_t* dest = buffer.reserve(end - begin);
+
+	dest[widen(begin, end, dest)] = L'\0';
+
+	return dest;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert a string from Wide to ANSI using a reusable buffer. The result is
+//! valid until the buffer is next used.
+
+const char* wideToAnsi(const wchar_t* begin, const wchar_t* end, AnsiConvertBuffer& buffer)
+{
+	char* dest = buffer.reserve(maxAnsiLength(end - begin));
+
+	dest[narrow(begin, end, dest)] = '\0';
+
+	return dest;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Construct from an ANSI string.
 
 Core::AnsiToWide::AnsiToWide(const char* string)
 	: m_string()
 {
-	size_t length = strlen(string);
+	const size_t length = strlen(string);
 
 	m_string = new wchar_t[length+1];
-
-	ansiToWide(string, string+length, m_string);
-
-	m_string[length] = L'\0';
+	m_string[widen(string, string+length, m_string)] = L'\0';
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -87,45 +449,94 @@ Core::AnsiToWide::AnsiToWide(const char* string)
 Core::AnsiToWide::AnsiToWide(const std::string& str)
 	: m_string()
 {
-	size_t      length = str.length();
-	const char* string = (str.empty()) ? nullptr : &str[0];
+	const size_t length = str.length();
+	const char*  string = str.data();
 
 	m_string = new wchar_t[length+1];
+	m_string[widen(string, string+length, m_string)] = L'\0';
+}
 
-	ansiToWide(string, string+length, m_string);
+////////////////////////////////////////////////////////////////////////////////
+//! Construct from a wide string.
+
+Core::WideToAnsi::WideToAnsi(const wchar_t* string)
+	: m_string()
+{
+	const size_t length = wcslen(string);
 
-	m_string[length] = L'\0';
+	m_string = new char[maxAnsiLength(length)+1];
+	m_string[narrow(string, string+length, m_string)] = '\0';
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //! Construct from a wide string.
 
-Core::WideToAnsi::WideToAnsi(const wchar_t* string)
+Core::WideToAnsi::WideToAnsi(const std::wstring& str)
 	: m_string()
 {
-	size_t length = wcslen(string);
+	const size_t   length = str.length();
+	const wchar_t* string = str.data();
 
-	m_string = new char[length+1];
+	m_string = new char[maxAnsiLength(length)+1];
+	m_string[narrow(string, string+length, m_string)] = '\0';
+}
 
-	wideToAnsi(string, string+length, m_string);
+////////////////////////////////////////////////////////////////////////////////
+//! Construct from an ANSI string.
 
-	m_string[length] = '\0';
+Core::InlineAnsiToWide::InlineAnsiToWide(const char* string)
+	: m_string()
+{
+	convert(string, strlen(string));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construct from an ANSI string.
+
+Core::InlineAnsiToWide::InlineAnsiToWide(const std::string& str)
+	: m_string()
+{
+	convert(str.data(), str.length());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert the string into the inline buffer, if it fits, or a heap buffer.
+
+void Core::InlineAnsiToWide::convert(const char* string, size_t length)
+{
+	m_string = (length < INLINE_SIZE) ? m_buffer : new wchar_t[length+1];
+
+	m_string[widen(string, string+length, m_string)] = L'\0';
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //! Construct from a wide string.
 
-Core::WideToAnsi::WideToAnsi(const std::wstring& str)
+Core::InlineWideToAnsi::InlineWideToAnsi(const wchar_t* string)
 	: m_string()
 {
-	size_t         length = str.length();
-	const wchar_t* string = (str.empty()) ? nullptr : &str[0];
+	convert(string, wcslen(string));
+}
 
-	m_string = new char[length+1];
+////////////////////////////////////////////////////////////////////////////////
+//! Construct from a wide string.
+
+Core::InlineWideToAnsi::InlineWideToAnsi(const std::wstring& str)
+	: m_string()
+{
+	convert(str.data(), str.length());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert the string into the inline buffer, if it fits, or a heap buffer.
+
+void Core::InlineWideToAnsi::convert(const wchar_t* string, size_t length)
+{
+	const size_t maxLength = maxAnsiLength(length);
 
-	wideToAnsi(string, string+length, m_string);
+	m_string = (maxLength < INLINE_SIZE) ? m_buffer : new char[maxLength+1];
 
-	m_string[length] = '\0';
+	m_string[narrow(string, string+length, m_string)] = '\0';
 }
 
 //namespace Core
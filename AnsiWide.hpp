@@ -15,7 +15,26 @@ namespace Core
 {
 
 ////////////////////////////////////////////////////////////////////////////////
-// Convert a string from ANSI to Wide.
+//! The character encodings that can be used for ANSI strings.
+
+enum AnsiEncoding
+{
+	LOCALE_ENCODING	= 0,	//!< The code page of the current locale.
+	UTF8_ENCODING	= 1,	//!< UTF-8, which is lossless.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Set the encoding used for ANSI strings.
+
+void setAnsiEncoding(AnsiEncoding encoding);
+
+////////////////////////////////////////////////////////////////////////////////
+// Get the encoding used for ANSI strings.
+
+AnsiEncoding getAnsiEncoding();
+
+////////////////////////////////////////////////////////////////////////////////
+// Convert a string from ANSI to Wide, one character for one character.
 
 void ansiToWide(const char* begin, const char* end, wchar_t* dest);
 
@@ -44,7 +63,7 @@ inline std::wstring ansiToWide(const std::string& string)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Convert a string from Wide to ANSI.
+// Convert a string from Wide to ANSI, one character for one character.
 
 void wideToAnsi(const wchar_t* begin, const wchar_t* end, char* dest);
 
@@ -73,7 +92,154 @@ inline std::string wideToAnsi(const std::wstring& string)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//! The class used to do the conversion from ANSI to Wide via the X2Y() macros.
+//! A reusable buffer for converting strings in a tight loop. The buffer only
+//! grows so once it has reached the size of the largest string converted no
+//! further allocations are made.
+
+template<typename CharT>
+class ConvertBuffer /*: private NotCopyable*/
+{
+public:
+	//! Default constructor.
+	ConvertBuffer();
+
+	//! Destructor.
+	~ConvertBuffer();
+
+	//
+	// Properties.
+	//
+
+	//! Get the number of characters the buffer can hold, excluding the terminator.
+	size_t capacity() const;
+
+	//
+	// Methods.
+	//
+
+	//! Ensure the buffer can hold a string of the given length and return it.
+	CharT* reserve(size_t length);
+
+private:
+	//
+	// Members.
+	//
+	CharT*	m_buffer;		//!< The buffer.
+	size_t	m_capacity;		//!< The buffer size, excluding the terminator.
+
+	// NotCopyable.
+	ConvertBuffer(const ConvertBuffer&);
+	ConvertBuffer& operator=(const ConvertBuffer&);
+};
+
+//! The buffer type used for repeated conversions to Wide.
+typedef ConvertBuffer<wchar_t> WideConvertBuffer;
+//! The buffer type used for repeated conversions to ANSI.
+typedef ConvertBuffer<char> AnsiConvertBuffer;
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+template<typename CharT>
+inline ConvertBuffer<CharT>::ConvertBuffer()
+	: m_buffer(nullptr)
+	, m_capacity(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+template<typename CharT>
+inline ConvertBuffer<CharT>::~ConvertBuffer()
+{
+	delete[] m_buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of characters the buffer can hold, excluding the terminator.
+
+template<typename CharT>
+inline size_t ConvertBuffer<CharT>::capacity() const
+{
+	return m_capacity;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Ensure the buffer can hold a string of the given length, plus a terminator,
+//! and return it. The existing contents are not preserved when it grows.
+
+template<typename CharT>
+inline CharT* ConvertBuffer<CharT>::reserve(size_t length)
+{
+	if ( (m_buffer == nullptr) || (length > m_capacity) )
+	{
+		size_t capacity = (m_capacity * 2 > length) ? m_capacity * 2 : length;
+		CharT* buffer = new CharT[capacity+1];
+
+		delete[] m_buffer;
+
+		m_buffer = buffer;
+		m_capacity = capacity;
+	}
+
+	return m_buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Convert a string from ANSI to Wide using a reusable buffer.
+
+const wchar_t* ansiToWide(const char* begin, const char* end, WideConvertBuffer& buffer);
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert a string from ANSI to Wide using a reusable buffer. The result is
+//! valid until the buffer is next used.
+
+inline const wchar_t* ansiToWide(const char* string, WideConvertBuffer& buffer)
+{
+	return ansiToWide(string, string + strlen(string), buffer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert a string from ANSI to Wide using a reusable buffer. The result is
+//! valid until the buffer is next used.
+
+inline const wchar_t* ansiToWide(const std::string& string, WideConvertBuffer& buffer)
+{
+	const char* begin = string.data();
+	const char* end   = begin + string.size();
+
+	return ansiToWide(begin, end, buffer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Convert a string from Wide to ANSI using a reusable buffer.
+
+const char* wideToAnsi(const wchar_t* begin, const wchar_t* end, AnsiConvertBuffer& buffer);
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert a string from Wide to ANSI using a reusable buffer. The result is
+//! valid until the buffer is next used.
+
+inline const char* wideToAnsi(const wchar_t* string, AnsiConvertBuffer& buffer)
+{
+	return wideToAnsi(string, string + wcslen(string), buffer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert a string from Wide to ANSI using a reusable buffer. The result is
+//! valid until the buffer is next used.
+
+inline const char* wideToAnsi(const std::wstring& string, AnsiConvertBuffer& buffer)
+{
+	const wchar_t* begin = string.data();
+	const wchar_t* end   = begin + string.size();
+
+	return wideToAnsi(begin, end, buffer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The class used to do the conversion from ANSI to Wide.
 //  NB: The sole member must be a c-style string to work with var_args functions.
 
 class AnsiToWide /*: private NotCopyable*/
@@ -119,7 +285,7 @@ inline AnsiToWide::operator const wchar_t*() const
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//! The class used to do the conversion from Wide to ANSI via the X2Y() macros.
+//! The class used to do the conversion from Wide to ANSI.
 //  NB: The sole member must be a c-style string to work with var_args functions.
 
 class WideToAnsi /*: private NotCopyable*/
@@ -164,6 +330,118 @@ inline WideToAnsi::operator const char*() const
 	return m_string;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! The class used to do the conversion from ANSI to Wide via the X2Y() macros.
+//! Short strings are converted into an inline buffer to avoid a heap allocation.
+//  NB: This is not pointer-sized and so must never be passed to a var_args
+//  function; the macros cast it to the c-style string first.
+
+class InlineAnsiToWide /*: private NotCopyable*/
+{
+public:
+	//! The size of the inline buffer, including the terminator.
+	static const size_t INLINE_SIZE = 256;
+
+	//! Construct from an ANSI string.
+	InlineAnsiToWide(const char* string);
+
+	//! Construct from an ANSI string.
+	explicit InlineAnsiToWide(const std::string& string);
+
+	//! Destructor
+	~InlineAnsiToWide();
+
+	//! Conversion operator for a wide string.
+	operator const wchar_t*() const;
+
+private:
+	//
+	// Members.
+	//
+	wchar_t*	m_string;				//! The converted string.
+	wchar_t		m_buffer[INLINE_SIZE];	//! The inline buffer for short strings.
+
+	//! Convert the string into the inline or a heap buffer.
+	void convert(const char* string, size_t length);
+
+	// NotCopyable.
+	InlineAnsiToWide(const InlineAnsiToWide&);
+	InlineAnsiToWide& operator=(const InlineAnsiToWide&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor
+
+inline InlineAnsiToWide::~InlineAnsiToWide()
+{
+	if (m_string != m_buffer)
+		delete[] m_string;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Conversion operator for a wide string.
+
+inline InlineAnsiToWide::operator const wchar_t*() const
+{
+	return m_string;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The class used to do the conversion from Wide to ANSI via the X2Y() macros.
+//! Short strings are converted into an inline buffer to avoid a heap allocation.
+//  NB: This is not pointer-sized and so must never be passed to a var_args
+//  function; the macros cast it to the c-style string first.
+
+class InlineWideToAnsi /*: private NotCopyable*/
+{
+public:
+	//! The size of the inline buffer, including the terminator.
+	static const size_t INLINE_SIZE = 256;
+
+	//! Construct from a wide string.
+	InlineWideToAnsi(const wchar_t* string);
+
+	//! Construct from a wide string.
+	explicit InlineWideToAnsi(const std::wstring& string);
+
+	//! Destructor.
+	~InlineWideToAnsi();
+
+	//! Conversion operator for an ANSI string.
+	operator const char*() const;
+
+private:
+	//
+	// Members.
+	//
+	char*	m_string;				//! The converted string.
+	char	m_buffer[INLINE_SIZE];	//! The inline buffer for short strings.
+
+	//! Convert the string into the inline or a heap buffer.
+	void convert(const wchar_t* string, size_t length);
+
+	// NotCopyable.
+	InlineWideToAnsi(const InlineWideToAnsi&);
+	InlineWideToAnsi& operator=(const InlineWideToAnsi&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+inline InlineWideToAnsi::~InlineWideToAnsi()
+{
+	if (m_string != m_buffer)
+		delete[] m_string;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Conversion operator for an ANSI string.
+
+inline InlineWideToAnsi::operator const char*() const
+{
+	return m_string;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Compatibility macros and classes to replace use of <atlconv.h>
 
@@ -180,10 +458,10 @@ inline const tchar* getCharPtr(const tstring& string)
 }
 
 //! Convert an ANSI string to Wide.
-#define A2W(string)	static_cast<const wchar_t*>(Core::AnsiToWide(string))
+#define A2W(string)	static_cast<const wchar_t*>(Core::InlineAnsiToWide(string))
 
 //! Convert a Wide string to ANSI.
-#define W2A(string)	static_cast<const char*>(Core::WideToAnsi(string))
+#define W2A(string)	static_cast<const char*>(Core::InlineWideToAnsi(string))
 
 // ANSI build.
 #ifdef ANSI_BUILD
@@ -0,0 +1,294 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   AnsiWideConverter.cpp
+//! \brief  The AnsiToWideConverter and WideToAnsiConverter class definitions.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "AnsiWideConverter.hpp"
+#include "Utf.hpp"
+
+namespace Core
+{
+
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Remove the first unit of a pending sequence.
+
+template<typename UnitT>
+inline void dropFirst(UnitT* pending, size_t& length)
+{
+	ASSERT(length != 0);
+
+	for (size_t i = 1; i != length; ++i)
+		pending[i-1] = pending[i];
+
+	--length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert a chunk of UTF encoded text, carrying any sequence that is split
+//! across the end of the chunk over to the next one. Each invalid unit is
+//! replaced, which matches the behaviour of the one-shot lossy conversions.
+//! Returns false if the output buffer filled up before the input was consumed.
+
+template<typename InT, typename OutT>
+bool convertChunk(UtfResult (*fn)(const InT*, const InT*, OutT*, size_t), InT* pending, size_t& length, size_t maxLength,
+                  const InT*& begin, const InT* end, OutT*& dest, OutT* destEnd, OutT replacement)
+{
+	// Complete the sequence held back from the previous chunk first.
+	while (length != 0)
+	{
+		const size_t available = static_cast<size_t>(end - begin);
+		const size_t extra = ((maxLength - length) < available) ? (maxLength - length) : available;
+		InT          units[8];
+
+		ASSERT((length + extra) <= ARRAY_SIZE(units));
+
+		for (size_t i = 0; i != length; ++i)
+			units[i] = pending[i];
+
+		for (size_t i = 0; i != extra; ++i)
+			units[length+i] = begin[i];
+
+		const UtfResult result = fn(units, units + length + extra, dest, destEnd - dest);
+
+		if (result.consumed != 0)
+		{
+			ASSERT(result.consumed > length);
+
+			begin += result.consumed - length;
+			dest  += result.written;
+			length = 0;
+			break;
+		}
+
+		if (result.status == UTF_OUTPUT_FULL)
+			return false;
+
+		if (result.status == UTF_INCOMPLETE)
+		{
+			ASSERT(extra == available);
+
+			for (size_t i = 0; i != extra; ++i)
+				pending[length++] = *begin++;
+
+			return true;
+		}
+
+		ASSERT(result.status == UTF_INVALID);
+
+		if (dest == destEnd)
+			return false;
+
+		*dest++ = replacement;
+		dropFirst(pending, length);
+	}
+
+	// Convert the rest of the chunk directly.
+	while (begin != end)
+	{
+		const UtfResult result = fn(begin, end, dest, destEnd - dest);
+
+		begin += result.consumed;
+		dest  += result.written;
+
+		if (result.status == UTF_OK)
+			break;
+
+		if (result.status == UTF_OUTPUT_FULL)
+			return false;
+
+		if (result.status == UTF_INCOMPLETE)
+		{
+			ASSERT(static_cast<size_t>(end - begin) < maxLength);
+
+			while (begin != end)
+				pending[length++] = *begin++;
+
+			break;
+		}
+
+		ASSERT(result.status == UTF_INVALID);
+
+		if (dest == destEnd)
+			return false;
+
+		*dest++ = replacement;
+		++begin;
+	}
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Replace the units held back when the input ended mid-sequence. Returns
+//! false if the output buffer filled up before they were all written.
+
+template<typename InT, typename OutT>
+bool flushPending(InT* pending, size_t& length, OutT*& dest, OutT* destEnd, OutT replacement)
+{
+	while (length != 0)
+	{
+		if (dest == destEnd)
+			return false;
+
+		*dest++ = replacement;
+		dropFirst(pending, length);
+	}
+
+	return true;
+}
+
+//namespace
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor, which uses the current ANSI encoding.
+
+AnsiToWideConverter::AnsiToWideConverter()
+	: m_encoding(getAnsiEncoding())
+	, m_length(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction for a specific ANSI encoding.
+
+AnsiToWideConverter::AnsiToWideConverter(AnsiEncoding encoding)
+	: m_encoding(encoding)
+	, m_length(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+AnsiToWideConverter::~AnsiToWideConverter()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert as much of the next chunk as the output buffer will hold. On return
+//! the begin and dest pointers have been advanced past the input consumed and
+//! the output written. A partial sequence at the end of the chunk is consumed
+//! and held back until the next call. Returns true if the entire chunk was
+//! consumed or false if the output buffer is full.
+
+bool AnsiToWideConverter::convert(const char*& begin, const char* end, wchar_t*& dest, wchar_t* destEnd)
+{
+	ASSERT(begin <= end);
+	ASSERT(dest <= destEnd);
+
+	if (m_encoding == UTF8_ENCODING)
+	{
+		return convertChunk<char, wchar_t>(utf8ToWide, m_pending, m_length, MAX_SEQUENCE,
+		                                   begin, end, dest, destEnd, static_cast<wchar_t>(0xfffd));
+	}
+
+	// The locale conversion is one character for one character.
+	const size_t available = static_cast<size_t>(destEnd - dest);
+	const size_t length    = static_cast<size_t>(end - begin);
+	const size_t count     = (length < available) ? length : available;
+
+	ansiToWide(begin, begin + count, dest);
+
+	begin += count;
+	dest  += count;
+
+	return (begin == end);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write out any bytes held back as the input ended mid-sequence. Each one is
+//! replaced by U+FFFD. Returns false if the output buffer filled up first.
+
+bool AnsiToWideConverter::flush(wchar_t*& dest, wchar_t* destEnd)
+{
+	return flushPending(m_pending, m_length, dest, destEnd, static_cast<wchar_t>(0xfffd));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Discard any bytes held back and return to the initial state.
+
+void AnsiToWideConverter::reset()
+{
+	m_length = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor, which uses the current ANSI encoding.
+
+WideToAnsiConverter::WideToAnsiConverter()
+	: m_encoding(getAnsiEncoding())
+	, m_length(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction for a specific ANSI encoding.
+
+WideToAnsiConverter::WideToAnsiConverter(AnsiEncoding encoding)
+	: m_encoding(encoding)
+	, m_length(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+WideToAnsiConverter::~WideToAnsiConverter()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert as much of the next chunk as the output buffer will hold. On return
+//! the begin and dest pointers have been advanced past the input consumed and
+//! the output written. A high surrogate at the end of the chunk is consumed
+//! and held back until the next call. Returns true if the entire chunk was
+//! consumed or false if the output buffer is full.
+
+bool WideToAnsiConverter::convert(const wchar_t*& begin, const wchar_t* end, char*& dest, char* destEnd)
+{
+	ASSERT(begin <= end);
+	ASSERT(dest <= destEnd);
+
+	if (m_encoding == UTF8_ENCODING)
+	{
+		return convertChunk<wchar_t, char>(wideToUtf8, m_pending, m_length, MAX_SEQUENCE,
+		                                   begin, end, dest, destEnd, '?');
+	}
+
+	// The locale conversion is one character for one character.
+	const size_t available = static_cast<size_t>(destEnd - dest);
+	const size_t length    = static_cast<size_t>(end - begin);
+	const size_t count     = (length < available) ? length : available;
+
+	wideToAnsi(begin, begin + count, dest);
+
+	begin += count;
+	dest  += count;
+
+	return (begin == end);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write out any characters held back as the input ended mid-sequence. Each
+//! one is replaced by a '?'. Returns false if the output buffer filled up first.
+
+bool WideToAnsiConverter::flush(char*& dest, char* destEnd)
+{
+	return flushPending(m_pending, m_length, dest, destEnd, '?');
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Discard any characters held back and return to the initial state.
+
+void WideToAnsiConverter::reset()
+{
+	m_length = 0;
+}
+
+//namespace Core
+}
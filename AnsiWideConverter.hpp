@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   AnsiWideConverter.hpp
+//! \brief  The AnsiToWideConverter and WideToAnsiConverter class declarations.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_ANSIWIDECONVERTER_HPP
+#define CORE_ANSIWIDECONVERTER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "AnsiWide.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A streaming converter from ANSI to Wide. The input is supplied in arbitrary
+//! sized chunks and the output is written to a caller supplied buffer, so that
+//! a large buffer or file can be converted in bounded memory. Any multi-byte
+//! sequence that is split across two input chunks is held by the converter
+//! until the rest of it arrives. Invalid sequences are replaced by U+FFFD.
+
+class AnsiToWideConverter /*: private NotCopyable*/
+{
+public:
+	//! Default constructor, which uses the current ANSI encoding.
+	AnsiToWideConverter();
+
+	//! Construction for a specific ANSI encoding.
+	explicit AnsiToWideConverter(AnsiEncoding encoding);
+
+	//! Destructor.
+	~AnsiToWideConverter();
+
+	//
+	// Properties.
+	//
+
+	//! Get the ANSI encoding.
+	AnsiEncoding encoding() const;
+
+	//! Get the number of bytes held back from the previous chunk.
+	size_t pending() const;
+
+	//
+	// Methods.
+	//
+
+	//! Convert as much of the next chunk as the output buffer will hold.
+	bool convert(const char*& begin, const char* end, wchar_t*& dest, wchar_t* destEnd);
+
+	//! Write out any bytes held back as the input ended mid-sequence.
+	bool flush(wchar_t*& dest, wchar_t* destEnd);
+
+	//! Discard any bytes held back and return to the initial state.
+	void reset();
+
+	//
+	// Constants.
+	//
+
+	//! The maximum length of a multi-byte sequence.
+	static const size_t MAX_SEQUENCE = 4;
+
+private:
+	//
+	// Members.
+	//
+	AnsiEncoding	m_encoding;					//!< The ANSI encoding.
+	char			m_pending[MAX_SEQUENCE];	//!< The start of a split sequence.
+	size_t			m_length;					//!< The number of bytes pending.
+
+	// NotCopyable.
+	AnsiToWideConverter(const AnsiToWideConverter&);
+	AnsiToWideConverter& operator=(const AnsiToWideConverter&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the ANSI encoding.
+
+inline AnsiEncoding AnsiToWideConverter::encoding() const
+{
+	return m_encoding;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of bytes held back from the previous chunk.
+
+inline size_t AnsiToWideConverter::pending() const
+{
+	return m_length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! A streaming converter from Wide to ANSI. This is the counterpart to the
+//! AnsiToWideConverter and holds back a UTF-16 surrogate pair that is split
+//! across two input chunks. Invalid characters are replaced by a '?'.
+
+class WideToAnsiConverter /*: private NotCopyable*/
+{
+public:
+	//! Default constructor, which uses the current ANSI encoding.
+	WideToAnsiConverter();
+
+	//! Construction for a specific ANSI encoding.
+	explicit WideToAnsiConverter(AnsiEncoding encoding);
+
+	//! Destructor.
+	~WideToAnsiConverter();
+
+	//
+	// Properties.
+	//
+
+	//! Get the ANSI encoding.
+	AnsiEncoding encoding() const;
+
+	//! Get the number of characters held back from the previous chunk.
+	size_t pending() const;
+
+	//
+	// Methods.
+	//
+
+	//! Convert as much of the next chunk as the output buffer will hold.
+	bool convert(const wchar_t*& begin, const wchar_t* end, char*& dest, char* destEnd);
+
+	//! Write out any characters held back as the input ended mid-sequence.
+	bool flush(char*& dest, char* destEnd);
+
+	//! Discard any characters held back and return to the initial state.
+	void reset();
+
+	//
+	// Constants.
+	//
+
+	//! The maximum length of a surrogate pair.
+	static const size_t MAX_SEQUENCE = 2;
+
+private:
+	//
+	// Members.
+	//
+	AnsiEncoding	m_encoding;					//!< The ANSI encoding.
+	wchar_t			m_pending[MAX_SEQUENCE];	//!< The start of a split sequence.
+	size_t			m_length;					//!< The number of characters pending.
+
+	// NotCopyable.
+	WideToAnsiConverter(const WideToAnsiConverter&);
+	WideToAnsiConverter& operator=(const WideToAnsiConverter&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the ANSI encoding.
+
+inline AnsiEncoding WideToAnsiConverter::encoding() const
+{
+	return m_encoding;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of characters held back from the previous chunk.
+
+inline size_t WideToAnsiConverter::pending() const
+{
+	return m_length;
+}
+
+//namespace Core
+}
+
+#endif // CORE_ANSIWIDECONVERTER_HPP
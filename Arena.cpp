@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Arena.cpp
+//! \brief  The Arena class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "Arena.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A chunk of memory. The header is followed by the memory handed out.
+
+struct Arena::Chunk
+{
+	Chunk*	m_next;		//!< The next chunk.
+	size_t	m_size;		//!< The size of the memory following the header.
+
+	//! Get the start of the memory.
+	byte* begin()
+	{
+		return reinterpret_cast<byte*>(this + 1);
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the size of the chunks. No memory is allocated until the
+//! first call to allocate().
+
+Arena::Arena(size_t chunkSize)
+	: m_chunkSize(chunkSize)
+	, m_chunks(nullptr)
+	, m_current(nullptr)
+	, m_next(nullptr)
+	, m_end(nullptr)
+{
+	ASSERT(chunkSize != 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. All the chunks are freed.
+
+Arena::~Arena()
+{
+	Chunk* chunk = m_chunks;
+
+	while (chunk != nullptr)
+	{
+		Chunk* next = chunk->m_next;
+
+		delete[] reinterpret_cast<byte*>(chunk);
+		chunk = next;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the total size of the chunks allocated.
+
+size_t Arena::capacity() const
+{
+	size_t capacity = 0;
+
+	for (Chunk* chunk = m_chunks; chunk != nullptr; chunk = chunk->m_next)
+		capacity += chunk->m_size;
+
+	return capacity;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Release all the memory allocated since the position was marked. The marks
+//! taken since then are invalidated.
+
+void Arena::rewind(const Mark& mark)
+{
+	if (mark.m_chunk == nullptr)
+	{
+		reset();
+		return;
+	}
+
+	m_current = mark.m_chunk;
+	m_next = mark.m_next;
+	m_end = m_current->begin() + m_current->m_size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Release all the memory allocated. The chunks are kept for reuse.
+
+void Arena::reset()
+{
+	m_current = nullptr;
+	m_next = nullptr;
+	m_end = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Allocate a block of memory from the next chunk. A chunk left over from
+//! before a rewind or reset is reused if it's large enough, otherwise a new
+//! chunk is inserted. Blocks larger than the chunk size get a chunk of their
+//! own.
+
+void* Arena::allocateFromNextChunk(size_t bytes, size_t alignment)
+{
+	const size_t required = bytes + alignment - 1;
+	Chunk*       next = (m_current != nullptr) ? m_current->m_next : m_chunks;
+
+	if ( (next == nullptr) || (next->m_size < required) )
+	{
+		const size_t size = (required > m_chunkSize) ? required : m_chunkSize;
+		Chunk*       chunk = reinterpret_cast<Chunk*>(new byte[sizeof(Chunk) + size]);
+
+		chunk->m_next = next;
+		chunk->m_size = size;
+
+		if (m_current != nullptr)
+			m_current->m_next = chunk;
+		else
+			m_chunks = chunk;
+
+		next = chunk;
+	}
+
+	m_current = next;
+	m_next = next->begin();
+	m_end = m_next + next->m_size;
+
+	return allocate(bytes, alignment);
+}
+
+//namespace Core
+}
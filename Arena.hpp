@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Arena.hpp
+//! \brief  The Arena class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_ARENA_HPP
+#define CORE_ARENA_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A monotonic allocator that hands out memory by bumping a pointer through a
+//! list of chunks. Individual allocations are never freed. Instead, all the
+//! memory allocated since a mark() is released by rewind(), and everything by
+//! reset(). The chunks are kept for reuse until the arena is destroyed, so a
+//! reused arena does not touch the heap in the steady state. An arena is not
+//! thread-safe. See ArenaAllocator for using an arena with the STL containers.
+
+class Arena /*: private NotCopyable*/
+{
+private:
+	//! A chunk of memory.
+	struct Chunk;
+
+public:
+	//! The default size of a chunk.
+	static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+	//! The default alignment, which matches that of the heap.
+	static const size_t DEFAULT_ALIGNMENT = 2 * sizeof(void*);
+
+	//! A position in the arena that can be rewound to.
+	struct Mark
+	{
+		Chunk*	m_chunk;	//!< The current chunk.
+		byte*	m_next;		//!< The next free byte in the chunk.
+	};
+
+	//! Construction with the size of the chunks.
+	explicit Arena(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+	//! Destructor.
+	~Arena();
+
+	//
+	// Properties.
+	//
+
+	//! Get the total size of the chunks allocated.
+	size_t capacity() const;
+
+	//
+	// Methods.
+	//
+
+	//! Allocate a block of memory.
+	void* allocate(size_t bytes, size_t alignment = DEFAULT_ALIGNMENT);
+
+	//! Get the current position, to rewind to later.
+	Mark mark() const;
+
+	//! Release all the memory allocated since the position was marked.
+	void rewind(const Mark& mark);
+
+	//! Release all the memory allocated.
+	void reset();
+
+private:
+	//
+	// Members.
+	//
+	size_t	m_chunkSize;	//!< The size of new chunks.
+	Chunk*	m_chunks;		//!< The list of chunks.
+	Chunk*	m_current;		//!< The chunk being allocated from.
+	byte*	m_next;			//!< The next free byte in the current chunk.
+	byte*	m_end;			//!< The end of the current chunk.
+
+	//
+	// Internal methods.
+	//
+
+	//! Allocate a block of memory from the next chunk.
+	void* allocateFromNextChunk(size_t bytes, size_t alignment);
+
+	// NotCopyable.
+	Arena(const Arena&);
+	Arena& operator=(const Arena&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Allocate a block of memory. The alignment must be a power of two. The
+//! memory is valid until the arena is rewound past it, reset or destroyed.
+
+inline void* Arena::allocate(size_t bytes, size_t alignment)
+{
+	ASSERT((alignment != 0) && ((alignment & (alignment-1)) == 0));
+
+	const size_t padding = (0 - reinterpret_cast<size_t>(m_next)) & (alignment-1);
+
+	if ( (m_next == nullptr) || ((padding + bytes) > static_cast<size_t>(m_end - m_next)) )
+		return allocateFromNextChunk(bytes, alignment);
+
+	byte* block = m_next + padding;
+
+	m_next = block + bytes;
+
+	return block;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the current position, to rewind to later.
+
+inline Arena::Mark Arena::mark() const
+{
+	const Mark mark = { m_current, m_next };
+
+	return mark;
+}
+
+//namespace Core
+}
+
+#endif // CORE_ARENA_HPP
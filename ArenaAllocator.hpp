@@ -0,0 +1,241 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ArenaAllocator.hpp
+//! \brief  The ArenaAllocator class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_ARENAALLOCATOR_HPP
+#define CORE_ARENAALLOCATOR_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Arena.hpp"
+#include <new>
+
+// The debug CRT version of 'new' doesn't support placement new.
+#ifdef _MSC_VER
+#pragma push_macro("new")
+#undef new
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! An STL allocator that allocates from an Arena, so that containers and
+//! strings can be released in one go by resetting the arena, e.g.
+//! std::vector<int, ArenaAllocator<int> > values(ArenaAllocator<int>(arena)).
+//! Deallocation does nothing. The arena must outlive the containers that use
+//! it, and the containers must not be used after the arena is rewound past
+//! their memory.
+
+template <typename T>
+class ArenaAllocator
+{
+public:
+	//
+	// STL types.
+	//
+	typedef T			value_type;
+	typedef T*			pointer;
+	typedef const T*	const_pointer;
+	typedef T&			reference;
+	typedef const T&	const_reference;
+	typedef size_t		size_type;
+	typedef ptrdiff_t	difference_type;
+
+	//! Get the allocator type for another type.
+	template <typename U>
+	struct rebind
+	{
+		typedef ArenaAllocator<U> other;
+	};
+
+	//! Construction with the arena to allocate from.
+	explicit ArenaAllocator(Arena& arena);
+
+	//! Conversion from an allocator for another type.
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U>& allocator);
+
+	//
+	// Properties.
+	//
+
+	//! Get the arena allocated from.
+	Arena& arena() const;
+
+	//
+	// STL methods.
+	//
+
+	//! Get the address of a value.
+	pointer address(reference value) const;
+
+	//! Get the address of a value.
+	const_pointer address(const_reference value) const;
+
+	//! Allocate memory for a number of values.
+	pointer allocate(size_type count, const void* hint = 0);
+
+	//! Free the memory for a number of values.
+	void deallocate(pointer values, size_type count);
+
+	//! Get the maximum number of values that can be allocated.
+	size_type max_size() const;
+
+	//! Construct a value.
+	void construct(pointer value, const T& initial);
+
+	//! Destroy a value.
+	void destroy(pointer value);
+
+private:
+	//
+	// Members.
+	//
+	Arena*	m_arena;	//!< The arena to allocate from.
+
+	//
+	// Internal methods.
+	//
+
+	//! Get the alignment of the values.
+	static size_t alignment();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the arena to allocate from.
+
+template <typename T>
+inline ArenaAllocator<T>::ArenaAllocator(Arena& arena)
+	: m_arena(&arena)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Conversion from an allocator for another type.
+
+template <typename T>
+template <typename U>
+inline ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator<U>& allocator)
+	: m_arena(&allocator.arena())
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the arena allocated from.
+
+template <typename T>
+inline Arena& ArenaAllocator<T>::arena() const
+{
+	return *m_arena;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the address of a value.
+
+template <typename T>
+inline typename ArenaAllocator<T>::pointer ArenaAllocator<T>::address(reference value) const
+{
+	return &value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the address of a value.
+
+template <typename T>
+inline typename ArenaAllocator<T>::const_pointer ArenaAllocator<T>::address(const_reference value) const
+{
+	return &value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Allocate memory for a number of values.
+
+template <typename T>
+inline typename ArenaAllocator<T>::pointer ArenaAllocator<T>::allocate(size_type count, const void* /*hint*/)
+{
+	if (count > max_size())
+		throw std::bad_alloc();
+
+	return static_cast<pointer>(m_arena->allocate(count * sizeof(T), alignment()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Free the memory for a number of values. The memory is only released when
+//! the arena is rewound or reset.
+
+template <typename T>
+inline void ArenaAllocator<T>::deallocate(pointer /*values*/, size_type /*count*/)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the maximum number of values that can be allocated.
+
+template <typename T>
+inline typename ArenaAllocator<T>::size_type ArenaAllocator<T>::max_size() const
+{
+	return static_cast<size_type>(-1) / sizeof(T);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construct a value.
+
+template <typename T>
+inline void ArenaAllocator<T>::construct(pointer value, const T& initial)
+{
+	new(value) T(initial);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy a value.
+
+template <typename T>
+inline void ArenaAllocator<T>::destroy(pointer value)
+{
+	value->~T();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the alignment of the values. This is the largest power of two that
+//! divides the size of the type, up to the arena's default alignment, which
+//! is never less than the type's real alignment.
+
+template <typename T>
+inline size_t ArenaAllocator<T>::alignment()
+{
+	const size_t lowestBit = sizeof(T) & (0 - sizeof(T));
+
+	return (lowestBit < Arena::DEFAULT_ALIGNMENT) ? lowestBit : Arena::DEFAULT_ALIGNMENT;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Allocators are equal if they allocate from the same arena.
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+	return (&lhs.arena() == &rhs.arena());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Allocators are not equal if they allocate from different arenas.
+
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs)
+{
+	return !(lhs == rhs);
+}
+
+//namespace Core
+}
+
+#ifdef _MSC_VER
+#pragma pop_macro("new")
+#endif
+
+#endif // CORE_ARENAALLOCATOR_HPP
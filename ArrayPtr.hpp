@@ -36,6 +36,11 @@ public:
 	//! Construction from a raw pointer.
 	explicit ArrayPtr(T* ptr);
 
+#ifdef CORE_HAS_RVALUE_REFS
+	//! Move constructor.
+	ArrayPtr(ArrayPtr&& arrayPtr) CORE_NOEXCEPT;
+#endif
+
 	//! Destructor.
 	~ArrayPtr();
 
@@ -49,6 +54,11 @@ public:
 	//! Index operator.
 	const T& operator[](size_t index) const;
 
+#ifdef CORE_HAS_RVALUE_REFS
+	//! Move assignment operator.
+	ArrayPtr& operator=(ArrayPtr&& arrayPtr) CORE_NOEXCEPT;
+#endif
+
 	//
 	// Methods.
 	//
@@ -88,6 +98,21 @@ inline ArrayPtr<T>::ArrayPtr(T* ptr)
 {
 }
 
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move constructor. Takes over ownership from another pointer, which is left
+//! empty.
+
+template <typename T>
+inline ArrayPtr<T>::ArrayPtr(ArrayPtr&& arrayPtr) CORE_NOEXCEPT
+	: SmartPtr<T>(arrayPtr.m_ptr)
+{
+	arrayPtr.m_ptr = nullptr;
+}
+
+#endif // CORE_HAS_RVALUE_REFS
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Destructor.
 
@@ -121,6 +146,24 @@ inline const T& ArrayPtr<T>::operator[](size_t index) const
 	return this->m_ptr[index];
 }
 
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move assignment operator. Frees the current pointer and takes over
+//! ownership from another pointer, which is left empty.
+
+template <typename T>
+inline ArrayPtr<T>& ArrayPtr<T>::operator=(ArrayPtr&& arrayPtr) CORE_NOEXCEPT
+{
+	// Ignore self-assignment.
+	if (this != &arrayPtr)
+		reset(arrayPtr.detach());
+
+	return *this;
+}
+
+#endif // CORE_HAS_RVALUE_REFS
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Change pointer ownership. Frees the current pointer and takes ownership of
 //! another pointer, if provided.
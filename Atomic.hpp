@@ -0,0 +1,654 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Atomic.hpp
+//! \brief  The atomic operations and the Atomic template class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_ATOMIC_HPP
+#define CORE_ATOMIC_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The memory ordering constraints for an atomic operation. The values match
+//! the GCC __ATOMIC_* constants so that they can be passed straight through.
+
+enum MemoryOrder
+{
+	MEMORY_ORDER_RELAXED = 0,	//!< Atomicity only, no ordering of other accesses.
+	MEMORY_ORDER_ACQUIRE = 2,	//!< Later accesses cannot be moved before it.
+	MEMORY_ORDER_RELEASE = 3,	//!< Earlier accesses cannot be moved after it.
+	MEMORY_ORDER_ACQ_REL = 4,	//!< Both acquire and release.
+	MEMORY_ORDER_SEQ_CST = 5	//!< Acquire and release plus a single total order.
+};
+
+//namespace Core
+}
+
+// Visual C++
+#ifdef _MSC_VER
+
+////////////////////////////////////////////////////////////////////////////////
+// Manually define the intrinsic forms of the _Interlocked*() functions to avoid
+// bringing in <windows.h>.
+
+extern "C" long __cdecl _InterlockedExchange(volatile long* lpTarget, long lValue);
+extern "C" long __cdecl _InterlockedExchangeAdd(volatile long* lpAddend, long lValue);
+extern "C" long __cdecl _InterlockedCompareExchange(volatile long* lpDest, long lExchange, long lComparand);
+extern "C" long __cdecl _InterlockedOr(volatile long* lpValue, long lMask);
+extern "C" long __cdecl _InterlockedAnd(volatile long* lpValue, long lMask);
+extern "C" __int64 __cdecl _InterlockedCompareExchange64(volatile __int64* lpDest, __int64 lExchange, __int64 lComparand);
+extern "C" void __cdecl _ReadWriteBarrier();
+
+#ifdef _WIN64
+extern "C" __int64 __cdecl _InterlockedExchange64(volatile __int64* lpTarget, __int64 lValue);
+extern "C" __int64 __cdecl _InterlockedExchangeAdd64(volatile __int64* lpAddend, __int64 lValue);
+extern "C" __int64 __cdecl _InterlockedOr64(volatile __int64* lpValue, __int64 lMask);
+extern "C" __int64 __cdecl _InterlockedAnd64(volatile __int64* lpValue, __int64 lMask);
+#endif
+
+#pragma intrinsic(_InterlockedExchange)
+#pragma intrinsic(_InterlockedExchangeAdd)
+#pragma intrinsic(_InterlockedCompareExchange)
+#pragma intrinsic(_InterlockedOr)
+#pragma intrinsic(_InterlockedAnd)
+#pragma intrinsic(_InterlockedCompareExchange64)
+#pragma intrinsic(_ReadWriteBarrier)
+
+#ifdef _WIN64
+#pragma intrinsic(_InterlockedExchange64)
+#pragma intrinsic(_InterlockedExchangeAdd64)
+#pragma intrinsic(_InterlockedOr64)
+#pragma intrinsic(_InterlockedAnd64)
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The atomic operations for a value of a specific size. The Interlocked
+//! intrinsics are all full barriers on x86 and x64, so only the compiler has
+//! to be stopped from reordering the plain loads and stores.
+
+template <size_t S>
+struct AtomicOps;
+
+////////////////////////////////////////////////////////////////////////////////
+//! The atomic operations for a 32-bit value.
+
+template <>
+struct AtomicOps<4>
+{
+	//! The underlying type.
+	typedef long Type;
+
+	//! Read the value.
+	static Type load(const volatile Type* value)
+	{
+		const Type result = *value;
+		_ReadWriteBarrier();
+		return result;
+	}
+
+	//! Write the value.
+	static void store(volatile Type* value, Type newValue, MemoryOrder order)
+	{
+		if (order == MEMORY_ORDER_SEQ_CST)
+		{
+			_InterlockedExchange(value, newValue);
+		}
+		else
+		{
+			_ReadWriteBarrier();
+			*value = newValue;
+		}
+	}
+
+	//! Replace the value and return the previous one.
+	static Type exchange(volatile Type* value, Type newValue)
+	{
+		return _InterlockedExchange(value, newValue);
+	}
+
+	//! Replace the value if it matches the comparand and return the previous one.
+	static Type compareExchange(volatile Type* value, Type exchange, Type comparand)
+	{
+		return _InterlockedCompareExchange(value, exchange, comparand);
+	}
+
+	//! Add to the value and return the previous one.
+	static Type fetchAdd(volatile Type* value, Type operand)
+	{
+		return _InterlockedExchangeAdd(value, operand);
+	}
+
+	//! Bitwise OR the value and return the previous one.
+	static Type fetchOr(volatile Type* value, Type operand)
+	{
+		return _InterlockedOr(value, operand);
+	}
+
+	//! Bitwise AND the value and return the previous one.
+	static Type fetchAnd(volatile Type* value, Type operand)
+	{
+		return _InterlockedAnd(value, operand);
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! The atomic operations for a 64-bit value. Only the compare-exchange is an
+//! intrinsic on x86, so the others are built on top of it there; x64 has the
+//! full set of intrinsics.
+
+template <>
+struct AtomicOps<8>
+{
+	//! The underlying type.
+	typedef __int64 Type;
+
+	//! Read the value.
+	static Type load(const volatile Type* value)
+	{
+#ifdef _WIN64
+		const Type result = *value;
+		_ReadWriteBarrier();
+		return result;
+#else
+		return _InterlockedCompareExchange64(const_cast<volatile Type*>(value), 0, 0);
+#endif
+	}
+
+	//! Write the value.
+	static void store(volatile Type* value, Type newValue, MemoryOrder order)
+	{
+#ifdef _WIN64
+		if (order != MEMORY_ORDER_SEQ_CST)
+		{
+			_ReadWriteBarrier();
+			*value = newValue;
+			return;
+		}
+#else
+		UNUSED_VARIABLE(order);
+#endif
+		exchange(value, newValue);
+	}
+
+	//! Replace the value and return the previous one.
+	static Type exchange(volatile Type* value, Type newValue)
+	{
+#ifdef _WIN64
+		return _InterlockedExchange64(value, newValue);
+#else
+		Type current = *value;
+		Type previous;
+
+		while ((previous = compareExchange(value, newValue, current)) != current)
+			current = previous;
+
+		return previous;
+#endif
+	}
+
+	//! Replace the value if it matches the comparand and return the previous one.
+	static Type compareExchange(volatile Type* value, Type exchange, Type comparand)
+	{
+		return _InterlockedCompareExchange64(value, exchange, comparand);
+	}
+
+	//! Add to the value and return the previous one.
+	static Type fetchAdd(volatile Type* value, Type operand)
+	{
+#ifdef _WIN64
+		return _InterlockedExchangeAdd64(value, operand);
+#else
+		Type current = *value;
+		Type previous;
+
+		while ((previous = compareExchange(value, current + operand, current)) != current)
+			current = previous;
+
+		return previous;
+#endif
+	}
+
+	//! Bitwise OR the value and return the previous one.
+	static Type fetchOr(volatile Type* value, Type operand)
+	{
+#ifdef _WIN64
+		return _InterlockedOr64(value, operand);
+#else
+		Type current = *value;
+		Type previous;
+
+		while ((previous = compareExchange(value, current | operand, current)) != current)
+			current = previous;
+
+		return previous;
+#endif
+	}
+
+	//! Bitwise AND the value and return the previous one.
+	static Type fetchAnd(volatile Type* value, Type operand)
+	{
+#ifdef _WIN64
+		return _InterlockedAnd64(value, operand);
+#else
+		Type current = *value;
+		Type previous;
+
+		while ((previous = compareExchange(value, current & operand, current)) != current)
+			current = previous;
+
+		return previous;
+#endif
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the address of a value as its underlying atomic type.
+
+template <typename T>
+inline volatile typename AtomicOps<sizeof(T)>::Type* atomicAddress(const T& value)
+{
+	typedef typename AtomicOps<sizeof(T)>::Type Type;
+
+	return reinterpret_cast<volatile Type*>(const_cast<T*>(&value));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically read the value. A C-style cast is used when converting between
+//! T and the underlying type as T may be either an integer or a pointer.
+
+template <typename T>
+inline T atomicLoad(const T& value, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	UNUSED_VARIABLE(order);
+
+	return (T)(AtomicOps<sizeof(T)>::load(atomicAddress(value)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically write the value.
+
+template <typename T>
+inline void atomicStore(T& value, T newValue, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	typedef typename AtomicOps<sizeof(T)>::Type Type;
+
+	AtomicOps<sizeof(T)>::store(atomicAddress(value), (Type)(newValue), order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically replace the value and return the previous one.
+
+template <typename T>
+inline T atomicExchange(T& value, T newValue, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	typedef typename AtomicOps<sizeof(T)>::Type Type;
+
+	UNUSED_VARIABLE(order);
+
+	return (T)(AtomicOps<sizeof(T)>::exchange(atomicAddress(value), (Type)(newValue)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically replace the value if it matches the expected one. Returns true
+//! if the value was replaced, otherwise the expected value is updated.
+
+template <typename T>
+inline bool atomicCompareSwap(T& value, T& expected, T desired, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	typedef typename AtomicOps<sizeof(T)>::Type Type;
+
+	UNUSED_VARIABLE(order);
+
+	const Type comparand = (Type)(expected);
+	const Type previous = AtomicOps<sizeof(T)>::compareExchange(atomicAddress(value), (Type)(desired), comparand);
+
+	if (previous == comparand)
+		return true;
+
+	expected = (T)(previous);
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically add to the integer value and return the previous one.
+
+template <typename T>
+inline T atomicFetchAdd(T& value, T operand, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	typedef typename AtomicOps<sizeof(T)>::Type Type;
+
+	UNUSED_VARIABLE(order);
+
+	return (T)(AtomicOps<sizeof(T)>::fetchAdd(atomicAddress(value), (Type)(operand)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically subtract from the integer value and return the previous one.
+
+template <typename T>
+inline T atomicFetchSub(T& value, T operand, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	typedef typename AtomicOps<sizeof(T)>::Type Type;
+
+	UNUSED_VARIABLE(order);
+
+	return (T)(AtomicOps<sizeof(T)>::fetchAdd(atomicAddress(value), -(Type)(operand)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically bitwise OR the integer value and return the previous one.
+
+template <typename T>
+inline T atomicFetchOr(T& value, T operand, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	typedef typename AtomicOps<sizeof(T)>::Type Type;
+
+	UNUSED_VARIABLE(order);
+
+	return (T)(AtomicOps<sizeof(T)>::fetchOr(atomicAddress(value), (Type)(operand)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically bitwise AND the integer value and return the previous one.
+
+template <typename T>
+inline T atomicFetchAnd(T& value, T operand, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	typedef typename AtomicOps<sizeof(T)>::Type Type;
+
+	UNUSED_VARIABLE(order);
+
+	return (T)(AtomicOps<sizeof(T)>::fetchAnd(atomicAddress(value), (Type)(operand)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Stop memory accesses being reordered across the fence. Only a sequentially
+//! consistent fence needs a real barrier on x86 and x64.
+
+inline void atomicThreadFence(MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	if (order == MEMORY_ORDER_SEQ_CST)
+	{
+		volatile long barrier = 0;
+
+		_InterlockedExchange(&barrier, 0);
+	}
+	else
+	{
+		_ReadWriteBarrier();
+	}
+}
+
+//namespace Core
+}
+
+// Not Visual C++
+#else
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the ordering for the failure case of a compare-exchange, which cannot
+//! include a release.
+
+inline int atomicFailureOrder(MemoryOrder order)
+{
+	if (order == MEMORY_ORDER_ACQ_REL)
+		return MEMORY_ORDER_ACQUIRE;
+
+	if (order == MEMORY_ORDER_RELEASE)
+		return MEMORY_ORDER_RELAXED;
+
+	return order;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically read the value.
+
+template <typename T>
+inline T atomicLoad(const T& value, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	return __atomic_load_n(&value, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically write the value.
+
+template <typename T>
+inline void atomicStore(T& value, T newValue, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	__atomic_store_n(&value, newValue, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically replace the value and return the previous one.
+
+template <typename T>
+inline T atomicExchange(T& value, T newValue, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	return __atomic_exchange_n(&value, newValue, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically replace the value if it matches the expected one. Returns true
+//! if the value was replaced, otherwise the expected value is updated.
+
+template <typename T>
+inline bool atomicCompareSwap(T& value, T& expected, T desired, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	return __atomic_compare_exchange_n(&value, &expected, desired, false, order, atomicFailureOrder(order));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically add to the integer value and return the previous one.
+
+template <typename T>
+inline T atomicFetchAdd(T& value, T operand, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	return __atomic_fetch_add(&value, operand, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically subtract from the integer value and return the previous one.
+
+template <typename T>
+inline T atomicFetchSub(T& value, T operand, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	return __atomic_fetch_sub(&value, operand, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically bitwise OR the integer value and return the previous one.
+
+template <typename T>
+inline T atomicFetchOr(T& value, T operand, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	return __atomic_fetch_or(&value, operand, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Atomically bitwise AND the integer value and return the previous one.
+
+template <typename T>
+inline T atomicFetchAnd(T& value, T operand, MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	return __atomic_fetch_and(&value, operand, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Stop memory accesses being reordered across the fence.
+
+inline void atomicThreadFence(MemoryOrder order = MEMORY_ORDER_SEQ_CST)
+{
+	__atomic_thread_fence(order);
+}
+
+//namespace Core
+}
+
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A 32 or 64-bit integer or a pointer that can be accessed by many threads
+//! at once. Every operation takes an optional memory ordering, which defaults
+//! to the strongest, sequentially consistent, one. The arithmetic and bitwise
+//! operations are only for integers.
+
+template <typename T>
+class Atomic /*: private NotCopyable*/
+{
+public:
+	//! Default constructor.
+	Atomic();
+
+	//! Construction from an initial value.
+	explicit Atomic(T value);
+
+	//
+	// Methods.
+	//
+
+	//! Read the value.
+	T load(MemoryOrder order = MEMORY_ORDER_SEQ_CST) const;
+
+	//! Write the value.
+	void store(T value, MemoryOrder order = MEMORY_ORDER_SEQ_CST);
+
+	//! Replace the value and return the previous one.
+	T exchange(T value, MemoryOrder order = MEMORY_ORDER_SEQ_CST);
+
+	//! Replace the value only if it matches the expected one.
+	bool compareExchange(T& expected, T desired, MemoryOrder order = MEMORY_ORDER_SEQ_CST);
+
+	//! Add to the value and return the previous one.
+	T fetchAdd(T operand, MemoryOrder order = MEMORY_ORDER_SEQ_CST);
+
+	//! Subtract from the value and return the previous one.
+	T fetchSub(T operand, MemoryOrder order = MEMORY_ORDER_SEQ_CST);
+
+	//! Bitwise OR the value and return the previous one.
+	T fetchOr(T operand, MemoryOrder order = MEMORY_ORDER_SEQ_CST);
+
+	//! Bitwise AND the value and return the previous one.
+	T fetchAnd(T operand, MemoryOrder order = MEMORY_ORDER_SEQ_CST);
+
+private:
+	//
+	// Members.
+	//
+	T	m_value;	//!< The value.
+
+	// NotCopyable.
+	Atomic(const Atomic&);
+	Atomic& operator=(const Atomic&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor. The value is zero, or null.
+
+template <typename T>
+inline Atomic<T>::Atomic()
+	: m_value()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from an initial value.
+
+template <typename T>
+inline Atomic<T>::Atomic(T value)
+	: m_value(value)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the value.
+
+template <typename T>
+inline T Atomic<T>::load(MemoryOrder order) const
+{
+	return atomicLoad(m_value, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Write the value.
+
+template <typename T>
+inline void Atomic<T>::store(T value, MemoryOrder order)
+{
+	atomicStore(m_value, value, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Replace the value and return the previous one.
+
+template <typename T>
+inline T Atomic<T>::exchange(T value, MemoryOrder order)
+{
+	return atomicExchange(m_value, value, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Replace the value only if it matches the expected one. Returns true if the
+//! value was replaced, otherwise the expected value is updated with the
+//! current one.
+
+template <typename T>
+inline bool Atomic<T>::compareExchange(T& expected, T desired, MemoryOrder order)
+{
+	return atomicCompareSwap(m_value, expected, desired, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Add to the value and return the previous one.
+
+template <typename T>
+inline T Atomic<T>::fetchAdd(T operand, MemoryOrder order)
+{
+	return atomicFetchAdd(m_value, operand, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Subtract from the value and return the previous one.
+
+template <typename T>
+inline T Atomic<T>::fetchSub(T operand, MemoryOrder order)
+{
+	return atomicFetchSub(m_value, operand, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Bitwise OR the value and return the previous one.
+
+template <typename T>
+inline T Atomic<T>::fetchOr(T operand, MemoryOrder order)
+{
+	return atomicFetchOr(m_value, operand, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Bitwise AND the value and return the previous one.
+
+template <typename T>
+inline T Atomic<T>::fetchAnd(T operand, MemoryOrder order)
+{
+	return atomicFetchAnd(m_value, operand, order);
+}
+
+//namespace Core
+}
+
+#endif // CORE_ATOMIC_HPP
@@ -0,0 +1,384 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   AtomicSharedPtr.hpp
+//! \brief  The AtomicSharedPtr template class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_ATOMICSHAREDPTR_HPP
+#define CORE_ATOMICSHAREDPTR_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "SharedPtr.hpp"
+#include "Interlocked.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A SharedPtr that can be read and replaced by many threads at once without a
+//! lock, e.g. to publish immutable snapshots of configuration data.
+//!
+//! The implementation uses a split reference count. The pointer is held in a
+//! small node and the slot packs the node's address together with a count of
+//! the readers that are in the middle of copying its value into a single
+//! 64-bit word. A reader bumps that local count to pin the node, copies the
+//! value and then gives the local count back. A writer that swaps the node out
+//! converts any outstanding local counts into references on the node itself,
+//! so a reader that finds its node has gone releases one of those instead.
+//! A load is therefore a fetch-and-add, the copy and usually a single compare
+//! and swap, and never waits for a writer.
+//!
+//! The slot's own reference to a node is worth SLOT_REFS, rather than one, so
+//! that readers who release their converted references before the writer has
+//! accounted for them can never take the node's count to zero.
+//!
+//! On a 64-bit platform the address lives in the bottom 48 bits, which limits
+//! the number of threads that can be inside a load at the same time to 32,767.
+
+template <typename T>
+class AtomicSharedPtr /*: private NotCopyable*/
+{
+public:
+	//! Default constructor.
+	AtomicSharedPtr();
+
+	//! Construction from an initial value.
+	explicit AtomicSharedPtr(const SharedPtr<T>& value);
+
+	//! Destructor.
+	~AtomicSharedPtr();
+
+	//
+	// Methods.
+	//
+
+	//! Get a copy of the current value.
+	SharedPtr<T> load() const;
+
+	//! Replace the current value.
+	void store(const SharedPtr<T>& value);
+
+	//! Replace the current value and return the previous one.
+	SharedPtr<T> exchange(const SharedPtr<T>& value);
+
+	//! Replace the current value only if it matches the expected one.
+	bool compareExchange(SharedPtr<T>& expected, const SharedPtr<T>& value);
+
+private:
+	//! The node that holds the current value.
+	struct Node
+	{
+		//! Construction from the value to hold.
+		explicit Node(const SharedPtr<T>& value);
+
+		//
+		// Members.
+		//
+		SharedPtr<T>	m_value;	//!< The value.
+		long			m_count;	//!< The number of references to the node.
+	};
+
+	//
+	// Constants.
+	//
+
+	//! The shift of the reader count in the slot.
+	static const int COUNT_SHIFT = (sizeof(void*) == 8) ? 48 : 32;
+
+	//! The number of node references held by the slot.
+	static const long SLOT_REFS = 0x40000000;
+
+	//
+	// Members.
+	//
+	mutable longlong	m_slot;		//!< The node address and the reader count.
+
+	//
+	// Internal methods.
+	//
+
+	//! Allocate a node for the value, if not empty.
+	static Node* createNode(const SharedPtr<T>& value);
+
+	//! Pack a node address and reader count into a slot value.
+	static longlong pack(Node* node, longlong readers);
+
+	//! Extract the node address from a slot value.
+	static Node* node(longlong slot);
+
+	//! Extract the reader count from a slot value.
+	static longlong readers(longlong slot);
+
+	//! Release references to a node.
+	static void release(Node* node, long count);
+
+	//! Pin the current node by adding a reader.
+	Node* acquire(longlong& slot) const;
+
+	//! Remove a reader added by acquire().
+	void unacquire(Node* node) const;
+
+	// NotCopyable.
+	AtomicSharedPtr(const AtomicSharedPtr&);
+	AtomicSharedPtr& operator=(const AtomicSharedPtr&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the value to hold. The slot holds the initial references.
+
+template <typename T>
+inline AtomicSharedPtr<T>::Node::Node(const SharedPtr<T>& value)
+	: m_value(value)
+	, m_count(SLOT_REFS)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor. The initial value is empty.
+
+template <typename T>
+inline AtomicSharedPtr<T>::AtomicSharedPtr()
+	: m_slot(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from an initial value.
+
+template <typename T>
+inline AtomicSharedPtr<T>::AtomicSharedPtr(const SharedPtr<T>& value)
+	: m_slot(pack(createNode(value), 0))
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. There must be no other threads still using the pointer.
+
+template <typename T>
+inline AtomicSharedPtr<T>::~AtomicSharedPtr()
+{
+	ASSERT(readers(m_slot) == 0);
+
+	release(node(m_slot), SLOT_REFS);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get a copy of the current value.
+
+template <typename T>
+inline SharedPtr<T> AtomicSharedPtr<T>::load() const
+{
+	longlong slot;
+	Node*    current = acquire(slot);
+
+	SharedPtr<T> value;
+
+	if (current != nullptr)
+		value = current->m_value;
+
+	unacquire(current);
+
+	return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Replace the current value.
+
+template <typename T>
+inline void AtomicSharedPtr<T>::store(const SharedPtr<T>& value)
+{
+	exchange(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Replace the current value and return the previous one.
+
+template <typename T>
+inline SharedPtr<T> AtomicSharedPtr<T>::exchange(const SharedPtr<T>& value)
+{
+	const longlong replacement = pack(createNode(value), 0);
+	longlong       slot = atomicLoad(m_slot, MEMORY_ORDER_RELAXED);
+
+	for (;;)
+	{
+		const longlong previous = atomicCompareExchange64(m_slot, replacement, slot);
+
+		if (previous == slot)
+			break;
+
+		slot = previous;
+	}
+
+	Node* old = node(slot);
+
+	if (old == nullptr)
+		return SharedPtr<T>();
+
+	SharedPtr<T> result(old->m_value);
+
+	// Hand the readers still pinning the old node a reference each.
+	release(old, SLOT_REFS - static_cast<long>(readers(slot)));
+
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Replace the current value only if it matches the expected one. Values match
+//! if they refer to the same object. Returns true if the value was replaced,
+//! otherwise the expected value is updated with the current one.
+
+template <typename T>
+inline bool AtomicSharedPtr<T>::compareExchange(SharedPtr<T>& expected, const SharedPtr<T>& value)
+{
+	Node* const    replacementNode = createNode(value);
+	const longlong replacement = pack(replacementNode, 0);
+
+	for (;;)
+	{
+		longlong slot;
+		Node*    current = acquire(slot);
+		T*       currentPtr = (current != nullptr) ? current->m_value.get() : nullptr;
+
+		if (currentPtr != expected.get())
+		{
+			expected = (current != nullptr) ? current->m_value : SharedPtr<T>();
+
+			unacquire(current);
+			release(replacementNode, SLOT_REFS);
+
+			return false;
+		}
+
+		// Swap the node out, as long as it hasn't been replaced already.
+		bool swapped = false;
+
+		while (!swapped)
+		{
+			const longlong previous = atomicCompareExchange64(m_slot, replacement, slot);
+
+			if (previous == slot)
+				swapped = true;
+			else if (node(previous) == current)
+				slot = previous;
+			else
+				break;
+		}
+
+		if (swapped)
+		{
+			// Convert the other readers' pins, our own is simply dropped.
+			if (current != nullptr)
+				release(current, SLOT_REFS - static_cast<long>(readers(slot) - 1));
+
+			return true;
+		}
+
+		// Another writer got there first and converted our pin.
+		release(current, 1);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Allocate a node for the value. An empty value is represented by a null node.
+
+template <typename T>
+inline typename AtomicSharedPtr<T>::Node* AtomicSharedPtr<T>::createNode(const SharedPtr<T>& value)
+{
+	return (value.get() != nullptr) ? new Node(value) : nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Pack a node address and reader count into a slot value.
+
+template <typename T>
+inline longlong AtomicSharedPtr<T>::pack(Node* node, longlong readers)
+{
+	const longlong address = static_cast<longlong>(reinterpret_cast<size_t>(node));
+
+	ASSERT((address >> COUNT_SHIFT) == 0);
+
+	return address | (readers << COUNT_SHIFT);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Extract the node address from a slot value.
+
+template <typename T>
+inline typename AtomicSharedPtr<T>::Node* AtomicSharedPtr<T>::node(longlong slot)
+{
+	const longlong mask = (static_cast<longlong>(1) << COUNT_SHIFT) - 1;
+
+	return reinterpret_cast<Node*>(static_cast<size_t>(slot & mask));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Extract the reader count from a slot value.
+
+template <typename T>
+inline longlong AtomicSharedPtr<T>::readers(longlong slot)
+{
+	return static_cast<longlong>(static_cast<ulonglong>(slot) >> COUNT_SHIFT);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Release references to a node, destroying it when they were the last ones.
+
+template <typename T>
+inline void AtomicSharedPtr<T>::release(Node* node, long count)
+{
+	if ( (node != nullptr) && (atomicFetchSub(node->m_count, count, MEMORY_ORDER_ACQ_REL) == count) )
+		delete node;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Pin the current node by adding a reader to the slot. The node cannot be
+//! destroyed until the reader is removed again by unacquire(). The reader is
+//! added with a single fetch-and-add, so readers never retry, even when the
+//! slot is empty; the reader must still be removed by unacquire(). The slot
+//! value that includes the reader is returned via the argument.
+
+template <typename T>
+inline typename AtomicSharedPtr<T>::Node* AtomicSharedPtr<T>::acquire(longlong& slot) const
+{
+	const longlong reader = static_cast<longlong>(1) << COUNT_SHIFT;
+	const longlong value = atomicFetchAdd(m_slot, reader, MEMORY_ORDER_ACQUIRE);
+
+	ASSERT(readers(value) < (static_cast<longlong>(1) << (63 - COUNT_SHIFT)) - 1);
+	ASSERT(readers(value) < SLOT_REFS);
+
+	slot = value + reader;
+
+	return node(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Remove a reader added by acquire(). If the node has been swapped out since
+//! then the writer converted the reader into a reference, which is released.
+//! A reader of an empty slot has nothing to release.
+
+template <typename T>
+inline void AtomicSharedPtr<T>::unacquire(Node* current) const
+{
+	const longlong reader = static_cast<longlong>(1) << COUNT_SHIFT;
+	longlong       value = atomicLoad(m_slot, MEMORY_ORDER_RELAXED);
+
+	while ( (node(value) == current) && (readers(value) != 0) )
+	{
+		const longlong previous = atomicCompareExchange64(m_slot, value - reader, value);
+
+		if (previous == value)
+			return;
+
+		value = previous;
+	}
+
+	release(current, 1);
+}
+
+//namespace Core
+}
+
+#endif // CORE_ATOMICSHAREDPTR_HPP
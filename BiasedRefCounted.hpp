@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   BiasedRefCounted.hpp
+//! \brief  The BiasedRefCounted class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_BIASEDREFCOUNTED_HPP
+#define CORE_BIASEDREFCOUNTED_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Atomic.hpp"
+#include "CacheLine.hpp"
+#include "ThreadUtils.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The reference count of a BiasedRefCounted object and the state used to
+//! decide how it's updated.
+
+struct BiasedRefCount
+{
+	//! Default constructor.
+	BiasedRefCount();
+
+	//
+	// Members.
+	//
+	long	m_refCount;	//!< The reference count.
+	bool	m_shared;	//!< Has the object been shared?
+#ifdef _DEBUG
+	ulong	m_owner;	//!< The thread that created the object.
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! An alternative to RefCounted for objects that are mostly used by the thread
+//! that created them. The count is biased towards that thread: until share() is
+//! called the object is confined to it and the count is updated with plain
+//! arithmetic. Once shared the count is updated atomically, with a relaxed
+//! increment and an acquire/release decrement. The object must be handed over
+//! to other threads through something that synchronises, such as a queue or a
+//! lock, after share() has been called. In a Debug build the thread is checked
+//! on every change whilst the object is still confined.
+//!
+//! If the Padded template argument is true the count is placed on its own
+//! cache line, so that updating it from many threads does not slow down access
+//! to the rest of the object, including the vtable pointer. The padding on both
+//! sides comes from empty base classes when disabled, so it takes no space.
+
+template <bool Padded = false>
+class BiasedRefCounted : private CachePadding<Padded>, private BiasedRefCount, private CachePadding<Padded, 1> /*, private NotCopyable*/
+{
+public:
+	//
+	// Properties.
+	//
+
+	//! Get the reference count.
+	long refCount() const;
+
+	//! Query if the object can be shared between threads.
+	bool isShared() const;
+
+	//
+	// Methods.
+	//
+
+	//! Increase the reference count by one.
+	long incRefCount();
+
+	//! Decrease the reference count by one.
+	long decRefCount();
+
+	//! Allow the object to be shared with other threads.
+	void share();
+
+protected:
+	//! Default constructor.
+	BiasedRefCounted();
+
+	//! Destructor.
+	virtual ~BiasedRefCounted();
+
+private:
+	//
+	// Internal methods.
+	//
+
+	//! Check that the calling thread owns the object.
+	void checkOwner() const;
+
+	// NotCopyable.
+	BiasedRefCounted(const BiasedRefCounted&);
+	BiasedRefCounted& operator=(const BiasedRefCounted&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor. The object starts confined to the calling thread.
+
+inline BiasedRefCount::BiasedRefCount()
+	: m_refCount(1)
+	, m_shared(false)
+#ifdef _DEBUG
+	, m_owner(Core::currentThreadId())
+#endif
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+template <bool Padded>
+inline BiasedRefCounted<Padded>::BiasedRefCounted()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+template <bool Padded>
+inline BiasedRefCounted<Padded>::~BiasedRefCounted()
+{
+	ASSERT(m_refCount == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the reference count.
+
+template <bool Padded>
+inline long BiasedRefCounted<Padded>::refCount() const
+{
+	if (!m_shared)
+		return m_refCount;
+
+	return Core::atomicLoad(m_refCount, MEMORY_ORDER_RELAXED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the object can be shared between threads.
+
+template <bool Padded>
+inline bool BiasedRefCounted<Padded>::isShared() const
+{
+	return m_shared;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Increase the reference count by one.
+
+template <bool Padded>
+inline long BiasedRefCounted<Padded>::incRefCount()
+{
+	ASSERT(refCount() > 0);
+
+	if (!m_shared)
+	{
+		checkOwner();
+
+		return ++m_refCount;
+	}
+
+	return Core::atomicFetchAdd(m_refCount, 1L, MEMORY_ORDER_RELAXED) + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Decrease the reference count by one. The object is destroyed when the last
+//! reference is released.
+
+template <bool Padded>
+inline long BiasedRefCounted<Padded>::decRefCount()
+{
+	ASSERT(refCount() > 0);
+
+	long newCount;
+
+	if (!m_shared)
+	{
+		checkOwner();
+
+		newCount = --m_refCount;
+	}
+	else
+	{
+		newCount = Core::atomicFetchSub(m_refCount, 1L, MEMORY_ORDER_ACQ_REL) - 1;
+	}
+
+	if (newCount == 0)
+		delete this;
+
+	return newCount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Allow the object to be shared with other threads. This must be called by
+//! the thread that created the object before it is handed over. From then on
+//! the count is updated atomically.
+
+template <bool Padded>
+inline void BiasedRefCounted<Padded>::share()
+{
+	checkOwner();
+
+	m_shared = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Check that the calling thread owns the object.
+
+template <bool Padded>
+inline void BiasedRefCounted<Padded>::checkOwner() const
+{
+	ASSERT(m_owner == Core::currentThreadId());
+}
+
+//namespace Core
+}
+
+#endif // CORE_BIASEDREFCOUNTED_HPP
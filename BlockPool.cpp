@@ -0,0 +1,262 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   BlockPool.cpp
+//! \brief  The BlockPool class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "BlockPool.hpp"
+#include "Atomic.hpp"
+#include "CacheLine.hpp"
+#include <new>
+
+////////////////////////////////////////////////////////////////////////////////
+// Avoid bringing in <windows.h>.
+
+#if (!defined(__GNUC__)) || (defined(__GNUC__) && !defined(_WINBASE_H))
+
+extern "C" void* __stdcall VirtualAlloc(void* address, size_t size, unsigned long type, unsigned long protect);
+extern "C" int __stdcall VirtualFree(void* address, size_t size, unsigned long type);
+
+#define MEM_COMMIT			0x00001000
+#define MEM_RESERVE			0x00002000
+#define MEM_RELEASE			0x00008000
+#define PAGE_READWRITE		0x04
+
+#endif
+
+namespace Core
+{
+
+namespace
+{
+
+//! The alignment of the blocks, which matches that of the heap.
+const size_t ALIGNMENT = 2 * sizeof(void*);
+
+//! The size of the slab header, rounded up to the block alignment.
+const size_t HEADER_SIZE = ALIGNMENT;
+
+//namespace
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! A free block. The link to the next free block is stored in the block.
+
+struct BlockPool::Block
+{
+	Block*	m_next;		//!< The next free block.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! The header at the start of each slab. Slabs are aligned to their size so
+//! the header can be found from any of its blocks.
+
+struct BlockPool::Slab
+{
+	Cache*	m_owner;	//!< The cache the slab belongs to.
+	Slab*	m_next;		//!< The cache's next slab.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! The state of a thread that uses the pool. The return list is written by
+//! other threads so it is kept apart from the owner's state. The counters are
+//! only written by the owner, but are read by other threads for statistics.
+
+struct BlockPool::Cache : public ThreadRecord
+{
+	//! Default constructor.
+	Cache()
+		: m_free(nullptr)
+		, m_carve(nullptr)
+		, m_end(nullptr)
+		, m_slabs(nullptr)
+		, m_allocated(0)
+		, m_freed(0)
+		, m_returned(nullptr)
+	{
+	}
+
+	CachePadding<>	m_before;	//!< Padding to avoid false sharing.
+	Block*			m_free;		//!< The free list.
+	byte*			m_carve;	//!< The next unused block in the current slab.
+	byte*			m_end;		//!< The end of the current slab's blocks.
+	Slab*			m_slabs;	//!< The slabs owned by the cache.
+	size_t			m_allocated;//!< The number of blocks allocated by the thread.
+	size_t			m_freed;	//!< The number of blocks freed by the thread.
+	CachePadding<>	m_middle;	//!< Padding to avoid false sharing.
+	Block*			m_returned;	//!< The blocks freed by other threads.
+	CachePadding<>	m_after;	//!< Padding to avoid false sharing.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the size of the blocks. The size is rounded up to keep
+//! the blocks aligned.
+
+BlockPool::BlockPool(size_t blockSize)
+	: m_blockSize((((blockSize != 0) ? blockSize : 1) + ALIGNMENT - 1) & ~(ALIGNMENT - 1))
+	, m_caches()
+	, m_slabs(0)
+{
+	ASSERT(m_blockSize <= MAX_BLOCK_SIZE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. All the slabs are freed, so no blocks can still be in use.
+
+BlockPool::~BlockPool()
+{
+	for (Cache* cache = m_caches.first<Cache>(); cache != nullptr; cache = ThreadRecords::next(cache))
+	{
+		Slab* slab = cache->m_slabs;
+
+		while (slab != nullptr)
+		{
+			Slab* next = slab->m_next;
+
+			::VirtualFree(slab, 0, MEM_RELEASE);
+			slab = next;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of slabs allocated.
+
+size_t BlockPool::slabs() const
+{
+	return atomicLoad(m_slabs, MEMORY_ORDER_RELAXED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of blocks in use. The value may be stale by the time it's
+//! used.
+
+size_t BlockPool::blocksInUse() const
+{
+	size_t allocated = 0;
+	size_t freed = 0;
+
+	for (Cache* cache = m_caches.first<Cache>(); cache != nullptr; cache = ThreadRecords::next(cache))
+	{
+		allocated += atomicLoad(cache->m_allocated, MEMORY_ORDER_RELAXED);
+		freed += atomicLoad(cache->m_freed, MEMORY_ORDER_RELAXED);
+	}
+
+	return (allocated > freed) ? (allocated - freed) : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Allocate a block. Throws std::bad_alloc if a new slab cannot be allocated.
+
+void* BlockPool::allocate()
+{
+	Cache* cache = m_caches.threadRecord<Cache>();
+	void*  block = cache->m_free;
+
+	if (block != nullptr)
+		cache->m_free = cache->m_free->m_next;
+	else
+		block = refill(cache);
+
+	atomicStore(cache->m_allocated, cache->m_allocated + 1, MEMORY_ORDER_RELAXED);
+
+	return block;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Free a block. The block is returned to the cache that owns its slab. The
+//! block can be null.
+
+void BlockPool::deallocate(void* block)
+{
+	if (block == nullptr)
+		return;
+
+	Cache* cache = m_caches.threadRecord<Cache>();
+	Slab*  slab = reinterpret_cast<Slab*>(reinterpret_cast<size_t>(block) & ~(SLAB_SIZE - 1));
+	Block* freed = static_cast<Block*>(block);
+
+	atomicStore(cache->m_freed, cache->m_freed + 1, MEMORY_ORDER_RELAXED);
+
+	if (slab->m_owner == cache)
+	{
+		freed->m_next = cache->m_free;
+		cache->m_free = freed;
+	}
+	else
+	{
+		Cache* owner = slab->m_owner;
+		Block* head = atomicLoad(owner->m_returned, MEMORY_ORDER_RELAXED);
+
+		do
+		{
+			freed->m_next = head;
+		}
+		while (!atomicCompareSwap(owner->m_returned, head, freed, MEMORY_ORDER_RELEASE));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if a block was allocated from the pool by the calling thread, e.g.
+//! to tell a pooled block from one allocated elsewhere. This searches the
+//! thread's slabs, so it's only meant for rare paths.
+
+bool BlockPool::isOwnBlock(const void* block)
+{
+	const Slab* slab = reinterpret_cast<const Slab*>(reinterpret_cast<size_t>(block) & ~(SLAB_SIZE - 1));
+
+	for (const Slab* own = m_caches.threadRecord<Cache>()->m_slabs; own != nullptr; own = own->m_next)
+	{
+		if (own == slab)
+			return true;
+	}
+
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Allocate a block when the calling thread's free list is empty. The blocks
+//! returned by other threads are used first, then the unused part of the
+//! current slab, and finally a new slab.
+
+void* BlockPool::refill(Cache* cache)
+{
+	Block* const null = nullptr;
+	Block*       returned = atomicExchange(cache->m_returned, null, MEMORY_ORDER_ACQUIRE);
+
+	if (returned != nullptr)
+	{
+		cache->m_free = returned->m_next;
+		return returned;
+	}
+
+	if (cache->m_carve == cache->m_end)
+	{
+		Slab* slab = static_cast<Slab*>(::VirtualAlloc(nullptr, SLAB_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+
+		if (slab == nullptr)
+			throw std::bad_alloc();
+
+		ASSERT((reinterpret_cast<size_t>(slab) & (SLAB_SIZE - 1)) == 0);
+
+		slab->m_owner = cache;
+		slab->m_next = cache->m_slabs;
+		cache->m_slabs = slab;
+
+		const size_t blocks = (SLAB_SIZE - HEADER_SIZE) / m_blockSize;
+
+		cache->m_carve = reinterpret_cast<byte*>(slab) + HEADER_SIZE;
+		cache->m_end = cache->m_carve + (blocks * m_blockSize);
+
+		atomicFetchAdd(m_slabs, static_cast<size_t>(1), MEMORY_ORDER_RELAXED);
+	}
+
+	void* block = cache->m_carve;
+
+	cache->m_carve += m_blockSize;
+
+	return block;
+}
+
+//namespace Core
+}
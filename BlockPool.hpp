@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   BlockPool.hpp
+//! \brief  The BlockPool class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_BLOCKPOOL_HPP
+#define CORE_BLOCKPOOL_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "ThreadRecords.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! An allocator for fixed-size blocks of memory that avoids the heap in the
+//! steady state.
+//!
+//! Each thread has its own cache with a private free list, so allocating and
+//! freeing a block on the same thread is a couple of loads and stores. Blocks
+//! are carved from 64K slabs that belong to the cache of the thread that
+//! allocated them. A block freed by another thread is pushed on to the owning
+//! cache's lock-free return list, which the owner takes in one go when its
+//! free list is empty. New slabs are only allocated when both lists are empty.
+//!
+//! A thread's cache is kept until the pool is destroyed, and is handed to a
+//! later thread once its thread has exited. Destroying the pool frees all the
+//! slabs.
+
+class BlockPool /*: private NotCopyable*/
+{
+public:
+	//! The size of a slab, which is the Windows allocation granularity.
+	static const size_t SLAB_SIZE = 64 * 1024;
+
+	//! The largest block size supported.
+	static const size_t MAX_BLOCK_SIZE = SLAB_SIZE / 16;
+
+	//! Construction with the size of the blocks.
+	explicit BlockPool(size_t blockSize);
+
+	//! Destructor.
+	~BlockPool();
+
+	//
+	// Properties.
+	//
+
+	//! Get the size of the blocks.
+	size_t blockSize() const;
+
+	//! Get the number of slabs allocated.
+	size_t slabs() const;
+
+	//! Get the number of blocks in use.
+	size_t blocksInUse() const;
+
+	//
+	// Methods.
+	//
+
+	//! Allocate a block.
+	void* allocate();
+
+	//! Free a block.
+	void deallocate(void* block);
+
+	//! Query if a block was allocated from the pool by the calling thread.
+	bool isOwnBlock(const void* block);
+
+private:
+	//! A free block.
+	struct Block;
+
+	//! The header at the start of each slab.
+	struct Slab;
+
+	//! The state of a thread that uses the pool.
+	struct Cache;
+
+	//
+	// Members.
+	//
+	size_t			m_blockSize;	//!< The size of the blocks.
+	ThreadRecords	m_caches;		//!< The thread caches.
+	size_t			m_slabs;		//!< The number of slabs allocated.
+
+	//
+	// Internal methods.
+	//
+
+	//! Allocate a block when the calling thread's free list is empty.
+	void* refill(Cache* cache);
+
+	// NotCopyable.
+	BlockPool(const BlockPool&);
+	BlockPool& operator=(const BlockPool&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the size of the blocks.
+
+inline size_t BlockPool::blockSize() const
+{
+	return m_blockSize;
+}
+
+//namespace Core
+}
+
+#endif // CORE_BLOCKPOOL_HPP
@@ -49,6 +49,36 @@
 #define ANSI_BUILD
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+// Detect the C++11 language features we make use of. VC++ doesn't report the
+// language version via __cplusplus so it's detected by compiler version.
+
+#if (__cplusplus >= 201103L) || (_MSC_VER >= 1600)
+#define CORE_HAS_RVALUE_REFS		//!< Rvalue references and std::move are supported.
+#endif
+
+#if (__cplusplus >= 201103L) || (_MSC_VER >= 1900)
+#define CORE_NOEXCEPT noexcept		//!< The function does not throw.
+#else
+#define CORE_NOEXCEPT throw()		//!< The function does not throw.
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Declare a variable that has a separate instance for each thread. Only plain
+// types can be used as there is no construction or destruction.
+
+#ifdef _MSC_VER
+#define CORE_THREAD_LOCAL __declspec(thread)	//!< A variable per thread.
+#else
+#define CORE_THREAD_LOCAL __thread				//!< A variable per thread.
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Route the library's small internal allocations, such as the SharedPtr control
+// blocks, through the shared SmallObjectAllocator.
+
+//#define CORE_SMALL_OBJECT_ALLOCATOR			//!< Use the size-class allocator.
+
 ////////////////////////////////////////////////////////////////////////////////
 // Disable VC++ 8.0 warnings about potentially unsafe CRT and STL functions.
 
@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   CacheLine.hpp
+//! \brief  The processor cache line size and the CachePadding class.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_CACHELINE_HPP
+#define CORE_CACHELINE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+namespace Core
+{
+
+//! The size of a processor cache line. This is correct for all current x86
+//! and x64 processors, though some prefetch cache lines in pairs.
+static const size_t CACHE_LINE_SIZE = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+//! A cache line's worth of padding, used to stop data that is written by one
+//! thread from sharing a cache line with data that is used by another, known
+//! as false sharing. The padding can be disabled through the template argument,
+//! in which case it is an empty class. The tag allows a class to derive from it
+//! more than once, e.g. to pad both before and after its own members.
+
+template <bool Enabled = true, int Tag = 0>
+struct CachePadding
+{
+	char	m_bytes[CACHE_LINE_SIZE];	//!< The padding.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! The specialisation for when the padding is disabled.
+
+template <int Tag>
+struct CachePadding<false, Tag>
+{
+};
+
+//namespace Core
+}
+
+#endif // CORE_CACHELINE_HPP
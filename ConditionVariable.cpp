@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ConditionVariable.cpp
+//! \brief  The ConditionVariable class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "ConditionVariable.hpp"
+#include "ScopedLock.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+ConditionVariable::ConditionVariable()
+	: m_lock()
+	, m_waiters(0)
+	, m_wakeup()
+	, m_handshake()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. No threads can still be waiting.
+
+ConditionVariable::~ConditionVariable()
+{
+	ASSERT(m_waiters == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Release the mutex, wait to be notified and re-acquire the mutex. The mutex
+//! must be held by the calling thread.
+
+void ConditionVariable::wait(Mutex& mutex)
+{
+	addWaiter();
+
+	mutex.unlock();
+
+	m_wakeup.wait();
+	m_handshake.release();
+
+	mutex.lock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Release the mutex, wait for no longer than a timeout in milliseconds to be
+//! notified and re-acquire the mutex. The mutex must be held by the calling
+//! thread. If the wait times out the thread stops counting as a waiter, unless
+//! a notifier has already counted it as woken, in which case the wake-up is
+//! taken. Returns false if the timeout expired.
+
+bool ConditionVariable::wait(Mutex& mutex, ulong timeout)
+{
+	addWaiter();
+
+	mutex.unlock();
+
+	bool notified = m_wakeup.wait(timeout);
+
+	if (!notified)
+	{
+		if (!removeWaiter())
+		{
+			m_wakeup.wait();
+			notified = true;
+		}
+	}
+
+	if (notified)
+		m_handshake.release();
+
+	mutex.lock();
+
+	return notified;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wake one waiting thread, if there are any.
+
+void ConditionVariable::notifyOne()
+{
+	if (atomicLoad(m_waiters, MEMORY_ORDER_ACQUIRE) == 0)
+		return;
+
+	ScopedLock<Mutex> lock(m_lock);
+
+	if (removeWaiter())
+	{
+		m_wakeup.release();
+		m_handshake.wait();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wake all the waiting threads, if there are any.
+
+void ConditionVariable::notifyAll()
+{
+	if (atomicLoad(m_waiters, MEMORY_ORDER_ACQUIRE) == 0)
+		return;
+
+	ScopedLock<Mutex> lock(m_lock);
+
+	const long waiters = atomicExchange(m_waiters, 0L);
+
+	if (waiters > 0)
+	{
+		m_wakeup.release(waiters);
+
+		for (long i = 0; i != waiters; ++i)
+			m_handshake.wait();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Count the calling thread as a waiter. This waits for a notifier that is
+//! waking the existing waiters, so that the thread can't take their wake-ups.
+
+void ConditionVariable::addWaiter()
+{
+	ScopedLock<Mutex> lock(m_lock);
+
+	atomicFetchAdd(m_waiters, 1L);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Stop counting a waiter, unless all of them have been counted as woken.
+//! Returns false if there were no waiters left.
+
+bool ConditionVariable::removeWaiter()
+{
+	long waiters = atomicLoad(m_waiters, MEMORY_ORDER_RELAXED);
+
+	while (waiters > 0)
+	{
+		if (atomicCompareSwap(m_waiters, waiters, waiters-1))
+			return true;
+	}
+
+	return false;
+}
+
+//namespace Core
+}
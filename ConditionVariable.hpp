@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ConditionVariable.hpp
+//! \brief  The ConditionVariable class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_CONDITIONVARIABLE_HPP
+#define CORE_CONDITIONVARIABLE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Mutex.hpp"
+#include "Semaphore.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A condition variable for use with a Mutex, or a SpinMutex, as the Win32
+//! CONDITION_VARIABLE isn't available on every version of Windows supported.
+//!
+//! A waiter is counted while it still holds the mutex, so a notification made
+//! after changing the state under the mutex cannot be missed. The notifier
+//! waits for each thread it wakes to take its wake-up, so a thread that starts
+//! waiting later cannot take it instead. Notifying when there are no waiters
+//! doesn't enter the kernel. As usual, waiters must check their condition in a
+//! loop, as a wake-up does not mean the condition still holds.
+
+class ConditionVariable /*: private NotCopyable*/
+{
+public:
+	//! Default constructor.
+	ConditionVariable();
+
+	//! Destructor.
+	~ConditionVariable();
+
+	//
+	// Methods.
+	//
+
+	//! Release the mutex, wait to be notified and re-acquire the mutex.
+	void wait(Mutex& mutex);
+
+	//! Release the mutex, wait for no longer than a timeout to be notified and
+	//! re-acquire the mutex.
+	bool wait(Mutex& mutex, ulong timeout);
+
+	//! Wake one waiting thread.
+	void notifyOne();
+
+	//! Wake all the waiting threads.
+	void notifyAll();
+
+private:
+	//
+	// Members.
+	//
+	Mutex		m_lock;			//!< Serialises the registering and waking of waiters.
+	long		m_waiters;		//!< The number of waiters not yet woken.
+	Semaphore	m_wakeup;		//!< The semaphore waiters block on.
+	Semaphore	m_handshake;	//!< The semaphore woken waiters acknowledge on.
+
+	//
+	// Internal methods.
+	//
+
+	//! Count the calling thread as a waiter.
+	void addWaiter();
+
+	//! Stop counting a waiter.
+	bool removeWaiter();
+
+	// NotCopyable.
+	ConditionVariable(const ConditionVariable&);
+	ConditionVariable& operator=(const ConditionVariable&);
+};
+
+//namespace Core
+}
+
+#endif // CORE_CONDITIONVARIABLE_HPP
@@ -0,0 +1,183 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   CountingPolicy.hpp
+//! \brief  The reference counting policy classes.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_COUNTINGPOLICY_HPP
+#define CORE_COUNTINGPOLICY_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Atomic.hpp"
+#include "ThreadUtils.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The reference counting policy for objects that are shared between threads.
+//! The count is manipulated with atomic operations using the weakest ordering
+//! that is still correct. Taking a new reference needs no ordering as it is
+//! always made from an existing one. Dropping a reference must release any
+//! writes made through it and the final one must acquire all of those before
+//! the object is destroyed.
+
+class AtomicCount
+{
+public:
+	//! Read the count.
+	long load(const long& count) const;
+
+	//! Increment the count.
+	void increment(long& count);
+
+	//! Decrement the count and return the new value.
+	long decrement(long& count);
+
+	//! Replace the count if it matches the comparand and return the old value.
+	long compareExchange(long& count, long exchange, long comparand);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the count. The value may be stale by the time it's used if other
+//! threads hold references.
+
+inline long AtomicCount::load(const long& count) const
+{
+	return Core::atomicLoad(count, MEMORY_ORDER_RELAXED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Increment the count.
+
+inline void AtomicCount::increment(long& count)
+{
+	Core::atomicFetchAdd(count, 1L, MEMORY_ORDER_RELAXED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Decrement the count and return the new value.
+
+inline long AtomicCount::decrement(long& count)
+{
+	return Core::atomicFetchSub(count, 1L, MEMORY_ORDER_ACQ_REL) - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Replace the count if it matches the comparand and return the old value.
+
+inline long AtomicCount::compareExchange(long& count, long exchange, long comparand)
+{
+	Core::atomicCompareSwap(count, comparand, exchange, MEMORY_ORDER_ACQ_REL);
+
+	return comparand;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The reference counting policy for objects that are confined to a single
+//! thread. The count is manipulated with plain arithmetic, which avoids the
+//! cost of a locked instruction. In a Debug build the thread that created the
+//! count is recorded and every change is checked to be made on that thread.
+
+class LocalCount
+{
+public:
+	//! Default constructor.
+	LocalCount();
+
+	//! Read the count.
+	long load(const long& count) const;
+
+	//! Increment the count.
+	void increment(long& count);
+
+	//! Decrement the count and return the new value.
+	long decrement(long& count);
+
+	//! Replace the count if it matches the comparand and return the old value.
+	long compareExchange(long& count, long exchange, long comparand);
+
+private:
+#ifdef _DEBUG
+	//
+	// Members.
+	//
+	ulong	m_owner;	//!< The thread that owns the count.
+#endif
+
+	//
+	// Internal methods.
+	//
+
+	//! Check that the calling thread owns the count.
+	void checkOwner() const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+inline LocalCount::LocalCount()
+#ifdef _DEBUG
+	: m_owner(Core::currentThreadId())
+#endif
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the count.
+
+inline long LocalCount::load(const long& count) const
+{
+	return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Increment the count.
+
+inline void LocalCount::increment(long& count)
+{
+	checkOwner();
+
+	++count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Decrement the count and return the new value.
+
+inline long LocalCount::decrement(long& count)
+{
+	checkOwner();
+
+	return --count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Replace the count if it matches the comparand and return the old value.
+
+inline long LocalCount::compareExchange(long& count, long exchange, long comparand)
+{
+	checkOwner();
+
+	const long previous = count;
+
+	if (previous == comparand)
+		count = exchange;
+
+	return previous;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Check that the calling thread owns the count.
+
+inline void LocalCount::checkOwner() const
+{
+	ASSERT(m_owner == Core::currentThreadId());
+}
+
+//namespace Core
+}
+
+#endif // CORE_COUNTINGPOLICY_HPP
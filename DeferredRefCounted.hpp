@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   DeferredRefCounted.hpp
+//! \brief  The DeferredRefCounted class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_DEFERREDREFCOUNTED_HPP
+#define CORE_DEFERREDREFCOUNTED_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "RefCounted.hpp"
+#include "EpochReclaimer.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A RefCounted object that is not destroyed by the thread that releases the
+//! last reference. Instead it is retired to an EpochReclaimer and destroyed
+//! later by the thread that calls EpochReclaimer::reclaim(). This also means
+//! the object can be safely read without a reference inside an EpochGuard.
+
+class DeferredRefCounted : public RefCounted
+{
+protected:
+	//! Construction with the reclaimer to retire the object to.
+	explicit DeferredRefCounted(EpochReclaimer& reclaimer);
+
+	//! Destructor.
+	virtual ~DeferredRefCounted();
+
+	//
+	// RefCounted methods.
+	//
+
+	//! Retire the object once the last reference has been released.
+	virtual void destroy();
+
+private:
+	//
+	// Members.
+	//
+	EpochReclaimer&	m_reclaimer;	//!< The reclaimer to retire the object to.
+
+	//
+	// Internal methods.
+	//
+
+	//! Destroy a retired object.
+	static void deleteObject(void* object);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the reclaimer to retire the object to.
+
+inline DeferredRefCounted::DeferredRefCounted(EpochReclaimer& reclaimer)
+	: m_reclaimer(reclaimer)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+inline DeferredRefCounted::~DeferredRefCounted()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Retire the object once the last reference has been released.
+
+inline void DeferredRefCounted::destroy()
+{
+	m_reclaimer.retire(this, &DeferredRefCounted::deleteObject);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy a retired object.
+
+inline void DeferredRefCounted::deleteObject(void* object)
+{
+	delete static_cast<DeferredRefCounted*>(object);
+}
+
+//namespace Core
+}
+
+#endif // CORE_DEFERREDREFCOUNTED_HPP
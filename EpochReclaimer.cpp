@@ -0,0 +1,250 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   EpochReclaimer.cpp
+//! \brief  The EpochReclaimer class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "EpochReclaimer.hpp"
+#include "Atomic.hpp"
+#include "CacheLine.hpp"
+#include <vector>
+
+namespace Core
+{
+
+namespace
+{
+
+//! The flag in a thread's state that marks it as being inside a region.
+const ulong ACTIVE = 1;
+
+////////////////////////////////////////////////////////////////////////////////
+//! An object waiting to be destroyed.
+
+struct Retired
+{
+	void*					m_object;	//!< The object.
+	EpochReclaimer::Deleter	m_deleter;	//!< The function to destroy it.
+	ulong					m_epoch;	//!< The epoch it was retired in.
+};
+
+//! The list of objects waiting to be destroyed.
+typedef std::vector<Retired> RetiredList;
+
+////////////////////////////////////////////////////////////////////////////////
+//! A minimal spin lock used to guard a thread's list of retired objects. It is
+//! only contended when the list is being reclaimed.
+
+class ListLock /*: private NotCopyable*/
+{
+public:
+	//! Acquire the lock.
+	explicit ListLock(long& lock)
+		: m_lock(lock)
+	{
+		while (atomicExchange(m_lock, 1L, MEMORY_ORDER_ACQUIRE) != 0)
+			;
+	}
+
+	//! Release the lock.
+	~ListLock()
+	{
+		atomicStore(m_lock, 0L, MEMORY_ORDER_RELEASE);
+	}
+
+private:
+	//
+	// Members.
+	//
+	long&	m_lock;		//!< The lock.
+
+	// NotCopyable.
+	ListLock(const ListLock&);
+	ListLock& operator=(const ListLock&);
+};
+
+//namespace
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The state of a thread that uses the reclaimer. The state is padded so that
+//! entering and exiting a region doesn't disturb other threads' caches.
+
+struct EpochReclaimer::Record : public ThreadRecord
+{
+	//! Default constructor.
+	Record()
+		: m_state(0)
+		, m_depth(0)
+		, m_lock(0)
+		, m_retired()
+	{
+	}
+
+	//! Leave any region the previous thread didn't exit, e.g. because it was
+	//! terminated, so that it can't stop the epoch advancing. The objects it
+	//! retired are kept.
+	virtual void reset()
+	{
+		m_depth = 0;
+		atomicStore(m_state, 0UL, MEMORY_ORDER_RELEASE);
+	}
+
+	CachePadding<>	m_before;	//!< Padding to avoid false sharing.
+	ulong			m_state;	//!< The epoch seen by the thread, shifted, plus the active flag.
+	ulong			m_depth;	//!< The region nesting depth.
+	long			m_lock;		//!< The lock for the retired list.
+	RetiredList		m_retired;	//!< The objects retired by the thread.
+	CachePadding<>	m_after;	//!< Padding to avoid false sharing.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+EpochReclaimer::EpochReclaimer()
+	: m_epoch(0)
+	, m_records()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. Any objects still waiting are destroyed, so no other thread can
+//! be using the reclaimer.
+
+EpochReclaimer::~EpochReclaimer()
+{
+	for (Record* record = m_records.first<Record>(); record != nullptr; record = ThreadRecords::next(record))
+	{
+		ASSERT(record->m_depth == 0);
+
+		for (RetiredList::const_iterator it = record->m_retired.begin(); it != record->m_retired.end(); ++it)
+			it->m_deleter(it->m_object);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the current global epoch.
+
+ulong EpochReclaimer::epoch() const
+{
+	return atomicLoad(m_epoch, MEMORY_ORDER_RELAXED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of objects waiting to be destroyed. The value may be stale by
+//! the time it's used.
+
+size_t EpochReclaimer::pending() const
+{
+	size_t count = 0;
+
+	for (Record* record = m_records.first<Record>(); record != nullptr; record = ThreadRecords::next(record))
+	{
+		ListLock lock(record->m_lock);
+
+		count += record->m_retired.size();
+	}
+
+	return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Mark the start of a region where shared objects are accessed. The fence
+//! makes the thread's epoch visible to reclaim() before any shared object is
+//! read.
+
+void EpochReclaimer::enter()
+{
+	Record* record = m_records.threadRecord<Record>();
+
+	if (record->m_depth++ == 0)
+	{
+		atomicStore(record->m_state, (atomicLoad(m_epoch, MEMORY_ORDER_RELAXED) << 1) | ACTIVE, MEMORY_ORDER_RELAXED);
+		atomicThreadFence(MEMORY_ORDER_SEQ_CST);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Mark the end of a region where shared objects are accessed.
+
+void EpochReclaimer::exit()
+{
+	Record* record = m_records.threadRecord<Record>();
+
+	ASSERT(record->m_depth != 0);
+
+	if (--record->m_depth == 0)
+		atomicStore(record->m_state, 0UL, MEMORY_ORDER_RELEASE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy the object when no thread can still be accessing it. The object
+//! must already have been made unreachable by other threads.
+
+void EpochReclaimer::retire(void* object, Deleter deleter)
+{
+	ASSERT(object != nullptr);
+	ASSERT(deleter != nullptr);
+
+	Record*       record = m_records.threadRecord<Record>();
+	const Retired retired = { object, deleter, atomicLoad(m_epoch) };
+
+	ListLock lock(record->m_lock);
+
+	record->m_retired.push_back(retired);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Try to advance the epoch and then destroy the objects that are now safe to.
+//! The epoch can only advance when every thread inside a region has seen the
+//! current one. Returns the number of objects destroyed.
+
+size_t EpochReclaimer::reclaim()
+{
+	ulong epoch = atomicLoad(m_epoch);
+	bool  advance = true;
+
+	atomicThreadFence(MEMORY_ORDER_SEQ_CST);
+
+	Record* const records = m_records.first<Record>();
+
+	for (Record* record = records; (record != nullptr) && advance; record = ThreadRecords::next(record))
+	{
+		const ulong state = atomicLoad(record->m_state, MEMORY_ORDER_ACQUIRE);
+
+		if ( ((state & ACTIVE) != 0) && ((state >> 1) != epoch) )
+			advance = false;
+	}
+
+	if (advance && atomicCompareSwap(m_epoch, epoch, epoch+1))
+		++epoch;
+
+	// Take the objects retired at least two epochs ago.
+	RetiredList safe;
+
+	for (Record* record = records; record != nullptr; record = ThreadRecords::next(record))
+	{
+		ListLock lock(record->m_lock);
+
+		RetiredList::iterator end = record->m_retired.begin();
+
+		for (RetiredList::iterator it = record->m_retired.begin(); it != record->m_retired.end(); ++it)
+		{
+			if ((epoch - it->m_epoch) >= 2)
+				safe.push_back(*it);
+			else
+				*end++ = *it;
+		}
+
+		record->m_retired.erase(end, record->m_retired.end());
+	}
+
+	// Destroy them outside the locks as they may retire others.
+	for (RetiredList::const_iterator it = safe.begin(); it != safe.end(); ++it)
+		it->m_deleter(it->m_object);
+
+	return safe.size();
+}
+
+//namespace Core
+}
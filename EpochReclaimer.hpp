@@ -0,0 +1,163 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   EpochReclaimer.hpp
+//! \brief  The EpochReclaimer and EpochGuard class declarations.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_EPOCHRECLAIMER_HPP
+#define CORE_EPOCHRECLAIMER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "ThreadRecords.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Defers the destruction of objects that may still be in use by other threads
+//! until it is safe, using epoch-based reclamation.
+//!
+//! A thread that reads shared objects marks the region with an EpochGuard.
+//! Entering a region records the current global epoch for the thread, which
+//! is a store and a fence. An object that is no longer reachable is handed to
+//! retire(), which appends it to the calling thread's own list, tagged with
+//! the epoch. Some other thread, typically a background one, calls reclaim()
+//! periodically. This advances the global epoch once every thread inside a
+//! region has seen the current one, and then destroys the objects retired at
+//! least two epochs earlier, as no thread can still be using them.
+//!
+//! The thread that destroys the objects is the one that calls reclaim(), not
+//! the one that dropped the last reference, so destructor cascades are kept
+//! off latency sensitive threads.
+
+class EpochReclaimer /*: private NotCopyable*/
+{
+public:
+	//! The function used to destroy a retired object.
+	typedef void (*Deleter)(void* object);
+
+	//! Default constructor.
+	EpochReclaimer();
+
+	//! Destructor.
+	~EpochReclaimer();
+
+	//
+	// Properties.
+	//
+
+	//! Get the current global epoch.
+	ulong epoch() const;
+
+	//! Get the number of objects waiting to be destroyed.
+	size_t pending() const;
+
+	//
+	// Methods.
+	//
+
+	//! Mark the start of a region where shared objects are accessed.
+	void enter();
+
+	//! Mark the end of a region where shared objects are accessed.
+	void exit();
+
+	//! Destroy the object when no thread can still be accessing it.
+	void retire(void* object, Deleter deleter);
+
+	//! Destroy the object, using delete, when no thread can still be accessing it.
+	template <typename T>
+	void retire(T* object);
+
+	//! Try to advance the epoch and destroy the objects that are now safe to.
+	size_t reclaim();
+
+private:
+	//! The state of a thread that uses the reclaimer.
+	struct Record;
+
+	//
+	// Members.
+	//
+	ulong			m_epoch;		//!< The global epoch.
+	ThreadRecords	m_records;		//!< The thread states.
+
+	//
+	// Internal methods.
+	//
+
+	//! Destroy an object using delete.
+	template <typename T>
+	static void deleteObject(void* object);
+
+	// NotCopyable.
+	EpochReclaimer(const EpochReclaimer&);
+	EpochReclaimer& operator=(const EpochReclaimer&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy the object, using delete, when no thread can still be accessing it.
+
+template <typename T>
+inline void EpochReclaimer::retire(T* object)
+{
+	retire(object, &EpochReclaimer::deleteObject<T>);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy an object using delete.
+
+template <typename T>
+inline void EpochReclaimer::deleteObject(void* object)
+{
+	delete static_cast<T*>(object);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The guard used to mark a region where shared objects are accessed. Regions
+//! can be nested.
+
+class EpochGuard /*: private NotCopyable*/
+{
+public:
+	//! Enter a region.
+	explicit EpochGuard(EpochReclaimer& reclaimer);
+
+	//! Exit the region.
+	~EpochGuard();
+
+private:
+	//
+	// Members.
+	//
+	EpochReclaimer&	m_reclaimer;	//!< The reclaimer.
+
+	// NotCopyable.
+	EpochGuard(const EpochGuard&);
+	EpochGuard& operator=(const EpochGuard&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Enter a region.
+
+inline EpochGuard::EpochGuard(EpochReclaimer& reclaimer)
+	: m_reclaimer(reclaimer)
+{
+	m_reclaimer.enter();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Exit the region.
+
+inline EpochGuard::~EpochGuard()
+{
+	m_reclaimer.exit();
+}
+
+//namespace Core
+}
+
+#endif // CORE_EPOCHRECLAIMER_HPP
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Event.cpp
+//! \brief  The Event class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "Event.hpp"
+#include "ThreadUtils.hpp"
+#include "RuntimeException.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Avoid bringing in <windows.h>.
+
+#if (!defined(__GNUC__)) || (defined(__GNUC__) && !defined(_WINBASE_H))
+
+extern "C" void* __stdcall CreateSemaphoreA(void* attributes, long initialCount, long maximumCount, const char* name);
+extern "C" int __stdcall ReleaseSemaphore(void* semaphore, long releaseCount, long* previousCount);
+extern "C" void* __stdcall CreateEventA(void* attributes, int manualReset, int initialState, const char* name);
+extern "C" int __stdcall SetEvent(void* event);
+extern "C" int __stdcall ResetEvent(void* event);
+extern "C" unsigned long __stdcall WaitForSingleObject(void* handle, unsigned long milliseconds);
+extern "C" int __stdcall CloseHandle(void* handle);
+
+#define INFINITE		0xFFFFFFFF
+#define WAIT_OBJECT_0	0x00000000
+
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the reset mode and the initial state. An auto reset event
+//! blocks its waiters on a kernel semaphore, so that each set releases exactly
+//! one of them, and a manual reset event on a manual reset kernel event.
+
+Event::Event(ResetMode mode, bool signalled)
+	: m_mode(mode)
+	, m_state(signalled ? SIGNALLED : RESET)
+	, m_waiters(0)
+	, m_raised(false)
+	, m_handle(nullptr)
+{
+	if (mode == AUTO_RESET)
+		m_handle = ::CreateSemaphoreA(nullptr, 0, LONG_MAX, nullptr);
+	else
+		m_handle = ::CreateEventA(nullptr, true, false, nullptr);
+
+	if (m_handle == nullptr)
+		throw RuntimeException(TXT("Failed to create an event"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+Event::~Event()
+{
+	::CloseHandle(m_handle);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Signal the event. The kernel is only entered if a thread is blocked on it.
+
+void Event::set()
+{
+	if (m_mode == AUTO_RESET)
+	{
+		long state = atomicLoad(m_state, MEMORY_ORDER_RELAXED);
+
+		do
+		{
+			if (state == SIGNALLED)
+				return;
+		}
+		while (!atomicCompareSwap(m_state, state, state+1, MEMORY_ORDER_RELEASE));
+
+		if (state < 0)
+			::ReleaseSemaphore(m_handle, 1, nullptr);
+
+		return;
+	}
+
+	for (long state = RESET; !atomicCompareSwap(m_state, state, static_cast<long>(CHANGING)); state = RESET)
+	{
+		if (state == SIGNALLED)
+			return;
+
+		yieldThread();
+	}
+
+	if (atomicLoad(m_waiters) != 0)
+	{
+		::SetEvent(m_handle);
+		m_raised = true;
+	}
+
+	atomicStore(m_state, static_cast<long>(SIGNALLED), MEMORY_ORDER_RELEASE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Reset the event. The kernel is only entered if a thread was woken by the
+//! event being set.
+
+void Event::reset()
+{
+	if (m_mode == AUTO_RESET)
+	{
+		long state = SIGNALLED;
+
+		atomicCompareSwap(m_state, state, static_cast<long>(RESET), MEMORY_ORDER_RELAXED);
+		return;
+	}
+
+	for (long state = SIGNALLED; !atomicCompareSwap(m_state, state, static_cast<long>(CHANGING)); state = SIGNALLED)
+	{
+		if (state == RESET)
+			return;
+
+		yieldThread();
+	}
+
+	if (m_raised)
+	{
+		::ResetEvent(m_handle);
+		m_raised = false;
+	}
+
+	atomicStore(m_state, static_cast<long>(RESET), MEMORY_ORDER_RELEASE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Block until an auto reset event is set, or the timeout expires. The caller
+//! has already been counted as a waiter. If the wait times out the thread
+//! stops counting as a waiter, unless a set has already released it, in which
+//! case the release is taken. Returns false if the timeout expired.
+
+bool Event::blockAuto(ulong timeout)
+{
+	const ulong milliseconds = (timeout == ULONG_MAX) ? INFINITE : timeout;
+
+	if (::WaitForSingleObject(m_handle, milliseconds) == WAIT_OBJECT_0)
+		return true;
+
+	long state = atomicLoad(m_state, MEMORY_ORDER_RELAXED);
+
+	while (state < 0)
+	{
+		if (atomicCompareSwap(m_state, state, state+1, MEMORY_ORDER_RELAXED))
+			return false;
+	}
+
+	::WaitForSingleObject(m_handle, INFINITE);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Block until a manual reset event is set, or the timeout expires. The thread
+//! registers as a waiter before checking the state again, so that either it
+//! sees the event being set, or the setter sees it waiting and sets the kernel
+//! event. Returns false if the timeout expired.
+
+bool Event::blockManual(ulong timeout)
+{
+	const ulong milliseconds = (timeout == ULONG_MAX) ? INFINITE : timeout;
+
+	atomicFetchAdd(m_waiters, 1L);
+
+	long state;
+
+	while ((state = atomicLoad(m_state)) == CHANGING)
+		yieldThread();
+
+	bool signalled = true;
+
+	if (state == RESET)
+		signalled = (::WaitForSingleObject(m_handle, milliseconds) == WAIT_OBJECT_0);
+
+	atomicFetchSub(m_waiters, 1L, MEMORY_ORDER_RELAXED);
+
+	return signalled;
+}
+
+//namespace Core
+}
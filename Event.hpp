@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Event.hpp
+//! \brief  The Event class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_EVENT_HPP
+#define CORE_EVENT_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Atomic.hpp"
+#include <limits.h>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! An event with the semantics of the Win32 auto and manual reset events, that
+//! only enters the kernel when a thread has to block, or be woken.
+//!
+//! Setting an auto reset event releases a single waiting thread, or if none are
+//! waiting, the next thread to wait. Setting a manual reset event releases all
+//! waiting threads, and any that wait until the event is reset. Waiting on a
+//! signalled event, or setting or resetting an event no thread is waiting on,
+//! is a single atomic operation.
+
+class Event /*: private NotCopyable*/
+{
+public:
+	//! How the event is reset.
+	enum ResetMode
+	{
+		AUTO_RESET,		//!< Reset when a waiting thread is released.
+		MANUAL_RESET,	//!< Reset by calling reset().
+	};
+
+public:
+	//! Construction with the reset mode and the initial state.
+	explicit Event(ResetMode mode = AUTO_RESET, bool signalled = false);
+
+	//! Destructor.
+	~Event();
+
+	//
+	// Properties.
+	//
+
+	//! Get the reset mode.
+	ResetMode mode() const;
+
+	//! Query if the event is signalled.
+	bool isSignalled() const;
+
+	//
+	// Methods.
+	//
+
+	//! Signal the event.
+	void set();
+
+	//! Reset the event.
+	void reset();
+
+	//! Wait until the event is signalled.
+	void wait();
+
+	//! Wait, for no longer than a timeout, until the event is signalled.
+	bool wait(ulong timeout);
+
+private:
+	//! The user mode states of a manual reset event. The state of an auto reset
+	//! event is SIGNALLED or RESET, or minus the number of waiters.
+	enum State
+	{
+		RESET = 0,		//!< Not signalled.
+		SIGNALLED = 1,	//!< Signalled.
+		CHANGING = 2,	//!< Being set or reset.
+	};
+
+	//
+	// Members.
+	//
+	ResetMode	m_mode;		//!< How the event is reset.
+	long		m_state;	//!< The user mode state of the event.
+	long		m_waiters;	//!< The number of threads blocking on a manual reset event.
+	bool		m_raised;	//!< Whether the kernel event of a manual reset event is set.
+	void*		m_handle;	//!< The kernel object the waiters block on.
+
+	//
+	// Internal methods.
+	//
+
+	//! Block until an auto reset event is set, or the timeout expires.
+	bool blockAuto(ulong timeout);
+
+	//! Block until a manual reset event is set, or the timeout expires.
+	bool blockManual(ulong timeout);
+
+	// NotCopyable.
+	Event(const Event&);
+	Event& operator=(const Event&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the reset mode.
+
+inline Event::ResetMode Event::mode() const
+{
+	return m_mode;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the event is signalled. The state may be stale by the time it's
+//! used.
+
+inline bool Event::isSignalled() const
+{
+	return (atomicLoad(m_state, MEMORY_ORDER_ACQUIRE) == SIGNALLED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait until the event is signalled.
+
+inline void Event::wait()
+{
+	wait(ULONG_MAX);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait, for no longer than a timeout in milliseconds, until the event is
+//! signalled. Returns false if the timeout expired.
+
+inline bool Event::wait(ulong timeout)
+{
+	if (m_mode == AUTO_RESET)
+	{
+		if (atomicFetchSub(m_state, 1L, MEMORY_ORDER_ACQUIRE) == SIGNALLED)
+			return true;
+
+		return blockAuto(timeout);
+	}
+
+	if (atomicLoad(m_state, MEMORY_ORDER_ACQUIRE) == SIGNALLED)
+		return true;
+
+	return blockManual(timeout);
+}
+
+//namespace Core
+}
+
+#endif // CORE_EVENT_HPP
@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Future.cpp
+//! \brief  The FutureState class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "Future.hpp"
+#include "ThreadPool.hpp"
+#include "RuntimeException.hpp"
+#include "ThreadUtils.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Avoid bringing in <windows.h>.
+
+#if (!defined(__GNUC__)) || (defined(__GNUC__) && !defined(_WINBASE_H))
+
+extern "C" void* __stdcall CreateEventA(void* attributes, int manualReset, int initialState, const char* name);
+extern "C" int __stdcall SetEvent(void* event);
+extern "C" unsigned long __stdcall WaitForSingleObject(void* handle, unsigned long milliseconds);
+extern "C" int __stdcall CloseHandle(void* handle);
+
+#define INFINITE	0xFFFFFFFF
+
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the pool that runs the task.
+
+FutureState::FutureState(ThreadPool& pool)
+	: m_pool(&pool)
+	, m_ready(0)
+	, m_event(nullptr)
+	, m_failed(false)
+	, m_error()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+FutureState::~FutureState()
+{
+	if (m_event != nullptr)
+		::CloseHandle(m_event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait for the task to finish. Other queued tasks are run in the meantime, as
+//! this one may be among them. Only if there are none left is an event created
+//! to block on.
+
+void FutureState::wait()
+{
+	while (!ready())
+	{
+		if (!m_pool->runPendingTask())
+			break;
+	}
+
+	if (ready())
+		return;
+
+	void* event = atomicLoad(m_event);
+
+	if (event == nullptr)
+	{
+		void* created = ::CreateEventA(nullptr, true, false, nullptr);
+
+		// Fall back to polling if we can't block.
+		if (created == nullptr)
+		{
+			while (!ready())
+				yieldThread();
+
+			return;
+		}
+
+		// Use the event of any thread that got there first.
+		if (atomicCompareSwap(m_event, event, created))
+			event = created;
+		else
+			::CloseHandle(created);
+	}
+
+	// The event must be published before checking the flag one last time, as
+	// the task sets the flag before checking for an event to signal.
+	if (atomicLoad(m_ready) == 0)
+		::WaitForSingleObject(event, INFINITE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Throw the exception the task failed with, if it did, as a RuntimeException.
+
+void FutureState::rethrow() const
+{
+	ASSERT(ready());
+
+	if (m_failed)
+		throw RuntimeException(m_error);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Mark the task as finished and wake any waiting threads.
+
+void FutureState::completed()
+{
+	atomicStore(m_ready, 1L);
+
+	void* event = atomicLoad(m_event);
+
+	if (event != nullptr)
+		::SetEvent(event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Handle the work failing with an exception.
+
+void FutureState::failed(const tstring& message)
+{
+	m_failed = true;
+	m_error = message;
+
+	completed();
+}
+
+//namespace Core
+}
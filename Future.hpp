@@ -0,0 +1,333 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Future.hpp
+//! \brief  The Future class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_FUTURE_HPP
+#define CORE_FUTURE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Task.hpp"
+#include "RefCntPtr.hpp"
+
+namespace Core
+{
+
+// Forward declarations.
+class ThreadPool;
+
+////////////////////////////////////////////////////////////////////////////////
+//! The state shared between a task submitted to a ThreadPool and the Future
+//! for its result. It doesn't need a kernel object unless a thread actually
+//! has to block waiting for the result.
+
+class FutureState : public Task
+{
+public:
+	//
+	// Properties.
+	//
+
+	//! Query if the task has finished.
+	bool ready() const;
+
+	//
+	// Methods.
+	//
+
+	//! Wait for the task to finish.
+	void wait();
+
+	//! Throw the exception the task failed with, if it did.
+	void rethrow() const;
+
+protected:
+	//! Construction with the pool that runs the task.
+	explicit FutureState(ThreadPool& pool);
+
+	//! Destructor.
+	virtual ~FutureState();
+
+	//
+	// Internal methods.
+	//
+
+	//! Mark the task as finished and wake any waiting threads.
+	void completed();
+
+	//! Handle the work failing with an exception.
+	virtual void failed(const tstring& message);
+
+private:
+	//
+	// Members.
+	//
+	ThreadPool*	m_pool;		//!< The pool that runs the task.
+	long		m_ready;	//!< Set when the task has finished.
+	void*		m_event;	//!< The event waited on, created on demand.
+	bool		m_failed;	//!< Set if the task threw an exception.
+	tstring		m_error;	//!< The message of the exception thrown.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! The result of a task. The result type must be default constructible and
+//! assignable.
+
+template <typename R>
+class FutureResult : public FutureState
+{
+public:
+	//! Get the result.
+	R& value();
+
+protected:
+	//! Construction with the pool that runs the task.
+	explicit FutureResult(ThreadPool& pool);
+
+	//! Call the function and save its result.
+	template <typename F>
+	void invoke(const F& function);
+
+private:
+	//
+	// Members.
+	//
+	R		m_value;	//!< The result.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! The specialisation for a task with no result.
+
+template <>
+class FutureResult<void> : public FutureState
+{
+public:
+	//! Get the result.
+	void value();
+
+protected:
+	//! Construction with the pool that runs the task.
+	explicit FutureResult(ThreadPool& pool);
+
+	//! Call the function.
+	template <typename F>
+	void invoke(const F& function);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! A task that calls a function, or function object, with no arguments.
+
+template <typename R, typename F>
+class FutureTask : public FutureResult<R>
+{
+public:
+	//! Construction with the pool that runs the task and the function.
+	FutureTask(ThreadPool& pool, const F& function);
+
+protected:
+	//! Do the work.
+	virtual void execute();
+
+private:
+	//
+	// Members.
+	//
+	F		m_function;	//!< The function to call.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! A handle to the result of a task submitted to a ThreadPool. Waiting for the
+//! result on a pool thread runs other queued tasks in the meantime.
+
+template <typename R>
+class Future
+{
+public:
+	//! Default constructor.
+	Future();
+
+	//! Construction from the task's shared state.
+	explicit Future(FutureResult<R>* state);
+
+	//
+	// Properties.
+	//
+
+	//! Query if the future refers to a task.
+	bool valid() const;
+
+	//! Query if the task has finished.
+	bool ready() const;
+
+	//
+	// Methods.
+	//
+
+	//! Wait for the task to finish.
+	void wait() const;
+
+	//! Wait for the task to finish and get its result.
+	R get() const;
+
+private:
+	//
+	// Members.
+	//
+	RefCntPtr< FutureResult<R> >	m_state;	//!< The task's shared state.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the task has finished.
+
+inline bool FutureState::ready() const
+{
+	return (atomicLoad(m_ready, MEMORY_ORDER_ACQUIRE) != 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the pool that runs the task.
+
+template <typename R>
+inline FutureResult<R>::FutureResult(ThreadPool& pool)
+	: FutureState(pool)
+	, m_value()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the result.
+
+template <typename R>
+inline R& FutureResult<R>::value()
+{
+	return m_value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Call the function and save its result.
+
+template <typename R>
+template <typename F>
+inline void FutureResult<R>::invoke(const F& function)
+{
+	m_value = function();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the pool that runs the task.
+
+inline FutureResult<void>::FutureResult(ThreadPool& pool)
+	: FutureState(pool)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the result.
+
+inline void FutureResult<void>::value()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Call the function.
+
+template <typename F>
+inline void FutureResult<void>::invoke(const F& function)
+{
+	function();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the pool that runs the task and the function.
+
+template <typename R, typename F>
+inline FutureTask<R, F>::FutureTask(ThreadPool& pool, const F& function)
+	: FutureResult<R>(pool)
+	, m_function(function)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Do the work.
+
+template <typename R, typename F>
+inline void FutureTask<R, F>::execute()
+{
+	this->invoke(m_function);
+	this->completed();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+template <typename R>
+inline Future<R>::Future()
+	: m_state()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the task's shared state. A reference is added.
+
+template <typename R>
+inline Future<R>::Future(FutureResult<R>* state)
+	: m_state(state, true)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the future refers to a task.
+
+template <typename R>
+inline bool Future<R>::valid() const
+{
+	return !m_state.empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the task has finished.
+
+template <typename R>
+inline bool Future<R>::ready() const
+{
+	ASSERT(valid());
+
+	return m_state->ready();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait for the task to finish.
+
+template <typename R>
+inline void Future<R>::wait() const
+{
+	ASSERT(valid());
+
+	m_state.get()->wait();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait for the task to finish and get its result. If the task threw an
+//! exception a RuntimeException is thrown with the same message.
+
+template <typename R>
+inline R Future<R>::get() const
+{
+	ASSERT(valid());
+
+	FutureResult<R>* state = m_state.get();
+
+	state->wait();
+	state->rethrow();
+
+	return state->value();
+}
+
+//namespace Core
+}
+
+#endif // CORE_FUTURE_HPP
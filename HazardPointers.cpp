@@ -0,0 +1,217 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   HazardPointers.cpp
+//! \brief  The HazardPointers class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "HazardPointers.hpp"
+#include "CacheLine.hpp"
+#include "BadLogicException.hpp"
+#include <vector>
+#include <algorithm>
+
+namespace Core
+{
+
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! An object waiting to be destroyed.
+
+struct Retired
+{
+	void*						m_object;	//!< The object.
+	HazardPointers::Deleter		m_deleter;	//!< The function to destroy it.
+};
+
+//! The list of objects waiting to be destroyed.
+typedef std::vector<Retired> RetiredList;
+
+//! The set of protected objects.
+typedef std::vector<const void*> Hazards;
+
+//namespace
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The state of a thread that uses the domain. Only the hazard slots are read
+//! by other threads, the remainder is private to the owning thread. The state
+//! is padded so that publishing a hazard doesn't disturb other threads' caches.
+
+struct HazardPointers::Record : public ThreadRecord
+{
+	//! Default constructor.
+	Record()
+		: m_used(0)
+		, m_count(0)
+		, m_retired()
+	{
+		for (size_t i = 0; i != SLOTS_PER_THREAD; ++i)
+			m_hazards[i] = nullptr;
+	}
+
+	//! Release the slots the previous thread didn't, e.g. because it was
+	//! terminated. The objects it retired are kept.
+	virtual void reset()
+	{
+		const void* null = nullptr;
+
+		for (size_t i = 0; i != SLOTS_PER_THREAD; ++i)
+			atomicStore(m_hazards[i], null, MEMORY_ORDER_RELEASE);
+
+		m_used = 0;
+	}
+
+	CachePadding<>	m_before;						//!< Padding to avoid false sharing.
+	const void*		m_hazards[SLOTS_PER_THREAD];	//!< The hazard slots.
+	ulong			m_used;							//!< The mask of slots in use.
+	size_t			m_count;						//!< The number of retired objects.
+	RetiredList		m_retired;						//!< The objects retired by the thread.
+	CachePadding<>	m_after;						//!< Padding to avoid false sharing.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+HazardPointers::HazardPointers()
+	: m_records()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. Any objects still waiting are destroyed, so no other thread can
+//! be using the domain.
+
+HazardPointers::~HazardPointers()
+{
+	for (Record* record = m_records.first<Record>(); record != nullptr; record = ThreadRecords::next(record))
+	{
+		ASSERT(record->m_used == 0);
+
+		for (RetiredList::const_iterator it = record->m_retired.begin(); it != record->m_retired.end(); ++it)
+			it->m_deleter(it->m_object);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of objects waiting to be destroyed. The value may be stale by
+//! the time it's used.
+
+size_t HazardPointers::pending() const
+{
+	size_t count = 0;
+
+	for (Record* record = m_records.first<Record>(); record != nullptr; record = ThreadRecords::next(record))
+		count += atomicLoad(record->m_count, MEMORY_ORDER_RELAXED);
+
+	return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Acquire one of the calling thread's hazard slots. Throws if all the slots
+//! are already in use.
+
+const void** HazardPointers::acquireSlot()
+{
+	Record* record = m_records.threadRecord<Record>();
+
+	for (size_t i = 0; i != SLOTS_PER_THREAD; ++i)
+	{
+		const ulong mask = 1UL << i;
+
+		if ((record->m_used & mask) == 0)
+		{
+			record->m_used |= mask;
+			return &record->m_hazards[i];
+		}
+	}
+
+	throw BadLogicException(TXT("All the thread's hazard pointers are in use"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Clear and release one of the calling thread's hazard slots.
+
+void HazardPointers::releaseSlot(const void** slot)
+{
+	Record*      record = m_records.threadRecord<Record>();
+	const size_t index = slot - record->m_hazards;
+	const void*  null = nullptr;
+
+	ASSERT(index < SLOTS_PER_THREAD);
+
+	atomicStore(*slot, null, MEMORY_ORDER_RELEASE);
+	record->m_used &= ~(1UL << index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy the object when no hazard pointer still refers to it. The object
+//! must already have been made unreachable by other threads. When the calling
+//! thread's list reaches the threshold it is scanned.
+
+void HazardPointers::retire(void* object, Deleter deleter)
+{
+	ASSERT(object != nullptr);
+	ASSERT(deleter != nullptr);
+
+	Record*       record = m_records.threadRecord<Record>();
+	const Retired retired = { object, deleter };
+
+	record->m_retired.push_back(retired);
+	atomicStore(record->m_count, record->m_retired.size(), MEMORY_ORDER_RELAXED);
+
+	const size_t threshold = 2 * SLOTS_PER_THREAD * m_records.count();
+
+	if (record->m_retired.size() >= threshold)
+		scan();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy the calling thread's retired objects that are not protected by any
+//! thread's hazard pointers. Returns the number of objects destroyed.
+
+size_t HazardPointers::scan()
+{
+	Record* record = m_records.threadRecord<Record>();
+	Hazards hazards;
+
+	// Pairs with the fence in HazardPtr::protect().
+	atomicThreadFence(MEMORY_ORDER_SEQ_CST);
+
+	for (Record* other = m_records.first<Record>(); other != nullptr; other = ThreadRecords::next(other))
+	{
+		for (size_t i = 0; i != SLOTS_PER_THREAD; ++i)
+		{
+			const void* hazard = atomicLoad(other->m_hazards[i], MEMORY_ORDER_ACQUIRE);
+
+			if (hazard != nullptr)
+				hazards.push_back(hazard);
+		}
+	}
+
+	std::sort(hazards.begin(), hazards.end());
+
+	RetiredList           safe;
+	RetiredList::iterator end = record->m_retired.begin();
+
+	for (RetiredList::iterator it = record->m_retired.begin(); it != record->m_retired.end(); ++it)
+	{
+		if (std::binary_search(hazards.begin(), hazards.end(), static_cast<const void*>(it->m_object)))
+			*end++ = *it;
+		else
+			safe.push_back(*it);
+	}
+
+	record->m_retired.erase(end, record->m_retired.end());
+	atomicStore(record->m_count, record->m_retired.size(), MEMORY_ORDER_RELAXED);
+
+	// Destroy them last as they may retire others.
+	for (RetiredList::const_iterator it = safe.begin(); it != safe.end(); ++it)
+		it->m_deleter(it->m_object);
+
+	return safe.size();
+}
+
+//namespace Core
+}
@@ -0,0 +1,246 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   HazardPointers.hpp
+//! \brief  The HazardPointers and HazardPtr class declarations.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_HAZARDPOINTERS_HPP
+#define CORE_HAZARDPOINTERS_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Atomic.hpp"
+#include "UniquePtr.hpp"
+#include "ThreadRecords.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Defers the destruction of the nodes of a lock-free data structure until no
+//! thread can still be reading them, using hazard pointers.
+//!
+//! Before dereferencing a shared pointer a thread publishes it in one of its
+//! hazard slots, using a HazardPtr, and then re-reads the source to check it
+//! is still reachable. A node that has been unlinked is passed to retire(),
+//! which appends it to the calling thread's own list. Once that list grows to
+//! twice the number of hazard slots the thread scans every thread's slots and
+//! destroys the nodes that are not protected. The cost of a scan is therefore
+//! amortised over many retirements and there are no global pauses.
+//!
+//! A thread's state is kept until the domain is destroyed, and is handed to a
+//! later thread once its thread has exited.
+
+class HazardPointers /*: private NotCopyable*/
+{
+public:
+	//! The function used to destroy a retired object.
+	typedef void (*Deleter)(void* object);
+
+	//! The number of hazard slots each thread has.
+	static const size_t SLOTS_PER_THREAD = 4;
+
+	//! Default constructor.
+	HazardPointers();
+
+	//! Destructor.
+	~HazardPointers();
+
+	//
+	// Properties.
+	//
+
+	//! Get the number of objects waiting to be destroyed.
+	size_t pending() const;
+
+	//
+	// Methods.
+	//
+
+	//! Acquire one of the calling thread's hazard slots.
+	const void** acquireSlot();
+
+	//! Clear and release one of the calling thread's hazard slots.
+	void releaseSlot(const void** slot);
+
+	//! Destroy the object when no hazard pointer still refers to it.
+	void retire(void* object, Deleter deleter);
+
+	//! Destroy the object, using delete, when no hazard pointer still refers to it.
+	template <typename T>
+	void retire(T* object);
+
+	//! Take ownership of the object and destroy it, using delete, when no hazard
+	//! pointer still refers to it.
+	template <typename T>
+	void retire(UniquePtr<T>& object);
+
+	//! Destroy the calling thread's retired objects that are not protected.
+	size_t scan();
+
+private:
+	//! The state of a thread that uses the domain.
+	struct Record;
+
+	//
+	// Members.
+	//
+	ThreadRecords	m_records;		//!< The thread states.
+
+	//
+	// Internal methods.
+	//
+
+	//! Destroy an object using delete.
+	template <typename T>
+	static void deleteObject(void* object);
+
+	// NotCopyable.
+	HazardPointers(const HazardPointers&);
+	HazardPointers& operator=(const HazardPointers&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy the object, using delete, when no hazard pointer still refers to it.
+
+template <typename T>
+inline void HazardPointers::retire(T* object)
+{
+	retire(object, &HazardPointers::deleteObject<T>);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Take ownership of the object and destroy it, using delete, when no hazard
+//! pointer still refers to it.
+
+template <typename T>
+inline void HazardPointers::retire(UniquePtr<T>& object)
+{
+	retire(object.get(), &HazardPointers::deleteObject<T>);
+	object.detach();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy an object using delete.
+
+template <typename T>
+inline void HazardPointers::deleteObject(void* object)
+{
+	delete static_cast<T*>(object);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! A hazard pointer that protects a single object of a lock-free data structure
+//! from being destroyed while it is being read. It owns one of the calling
+//! thread's hazard slots for its lifetime, and so must not be shared with, or
+//! destroyed by, another thread.
+
+template <typename T>
+class HazardPtr /*: private NotCopyable*/
+{
+public:
+	//! Construction with the domain to acquire the slot from.
+	explicit HazardPtr(HazardPointers& domain);
+
+	//! Destructor.
+	~HazardPtr();
+
+	//
+	// Properties.
+	//
+
+	//! Get the protected object.
+	T* get() const;
+
+	//
+	// Methods.
+	//
+
+	//! Read the pointer and protect the object it refers to.
+	T* protect(T* const& source);
+
+	//! Stop protecting the object.
+	void reset();
+
+private:
+	//
+	// Members.
+	//
+	HazardPointers&	m_domain;	//!< The domain the slot belongs to.
+	const void**	m_slot;		//!< The hazard slot.
+
+	// NotCopyable.
+	HazardPtr(const HazardPtr&);
+	HazardPtr& operator=(const HazardPtr&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the domain to acquire the slot from.
+
+template <typename T>
+inline HazardPtr<T>::HazardPtr(HazardPointers& domain)
+	: m_domain(domain)
+	, m_slot(domain.acquireSlot())
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+template <typename T>
+inline HazardPtr<T>::~HazardPtr()
+{
+	m_domain.releaseSlot(m_slot);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the protected object.
+
+template <typename T>
+inline T* HazardPtr<T>::get() const
+{
+	return static_cast<T*>(const_cast<void*>(atomicLoad(*m_slot, MEMORY_ORDER_RELAXED)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the pointer and protect the object it refers to. The pointer is read
+//! again after publishing the hazard, as the object may have been retired in
+//! between; the fence orders the publication before the re-read so that a
+//! concurrent scan either sees the hazard or the object is still reachable.
+
+template <typename T>
+inline T* HazardPtr<T>::protect(T* const& source)
+{
+	T* object = atomicLoad(source, MEMORY_ORDER_RELAXED);
+
+	for (;;)
+	{
+		atomicStore(*m_slot, static_cast<const void*>(object), MEMORY_ORDER_RELAXED);
+		atomicThreadFence(MEMORY_ORDER_SEQ_CST);
+
+		T* current = atomicLoad(source, MEMORY_ORDER_ACQUIRE);
+
+		if (current == object)
+			return object;
+
+		object = current;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Stop protecting the object.
+
+template <typename T>
+inline void HazardPtr<T>::reset()
+{
+	const void* null = nullptr;
+
+	atomicStore(*m_slot, null, MEMORY_ORDER_RELEASE);
+}
+
+//namespace Core
+}
+
+#endif // CORE_HAZARDPOINTERS_HPP
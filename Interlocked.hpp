@@ -1,6 +1,6 @@
 ////////////////////////////////////////////////////////////////////////////////
 //! \file   Interlocked.hpp
-//! \brief  Define the intrinsic forms of the Interlocked* functions.
+//! \brief  Define the Interlocked* style functions.
 //! \author Chris Oldwood
 
 // Check for previous inclusion
@@ -11,90 +11,88 @@
 #pragma once
 #endif
 
-// Visual C++
-#ifdef _MSC_VER
+#include "Atomic.hpp"
+
+namespace Core
+{
 
 ////////////////////////////////////////////////////////////////////////////////
-// Manually define the intrinsic forms of the _Interlocked*() functions to avoid
-// bringing in <windows.h>.
+//! Thread-safe function for incrementing the value by one. Returns the new
+//! value.
 
-extern "C" long __cdecl _InterlockedIncrement(volatile long* lpValue);
-extern "C" long __cdecl _InterlockedDecrement(volatile long* lpValue);
+inline long atomicIncrement(long& value)
+{
+	return atomicFetchAdd(value, 1L) + 1;
+}
 
-#pragma intrinsic(_InterlockedIncrement)
-#pragma intrinsic(_InterlockedDecrement)
+////////////////////////////////////////////////////////////////////////////////
+//! Thread-safe function for incrementing a volatile value by one. Returns the
+//! new value. The Visual C++ build used to only accept volatile values.
 
-namespace Core
+inline long atomicIncrement(volatile long& value)
 {
+	return atomicIncrement(const_cast<long&>(value));
+}
 
 ////////////////////////////////////////////////////////////////////////////////
-//! Thread-safe function for incrementing the value by one.
+//! Thread-safe function for decrementing the value by one. Returns the new
+//! value.
 
-inline long atomicIncrement(volatile long& value)
+inline long atomicDecrement(long& value)
 {
-	return _InterlockedIncrement(&value);
+	return atomicFetchSub(value, 1L) - 1;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//! Thread-safe function for decrementing the value by one.
+//! Thread-safe function for decrementing a volatile value by one. Returns the
+//! new value.
 
 inline long atomicDecrement(volatile long& value)
 {
-	return _InterlockedDecrement(&value);
+	return atomicDecrement(const_cast<long&>(value));
 }
 
-//namespace Core
-}
+////////////////////////////////////////////////////////////////////////////////
+//! Thread-safe function for replacing the value if it matches the comparand.
+//! Returns the initial value.
+
+inline long atomicCompareExchange(long& value, long exchange, long comparand)
+{
+	atomicCompareSwap(value, comparand, exchange);
 
-// Not Visual C++
-#else
+	return comparand;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
-// Manually define the exported Windows SDK Interlocked*() functions to avoid
-// bringing in <windows.h>.
-
-#ifndef _WIN64
-#if (__GNUC__ >= 4)
-extern "C" long __stdcall InterlockedIncrement(volatile long* lpValue);
-extern "C" long __stdcall InterlockedDecrement(volatile long* lpValue);
-#else
-extern "C" long __stdcall InterlockedIncrement(long* lpValue);
-extern "C" long __stdcall InterlockedDecrement(long* lpValue);
-#endif
-#else
-#if defined __BORLANDC__
-extern "C" long __cdecl InterlockedIncrement(volatile long* lpValue);
-extern "C" long __cdecl InterlockedDecrement(volatile long* lpValue);
-#else
-extern "C" long __cdecl _InterlockedIncrement(volatile long* lpValue);
-extern "C" long __cdecl _InterlockedDecrement(volatile long* lpValue);
-#define InterlockedIncrement _InterlockedIncrement
-#define InterlockedDecrement _InterlockedDecrement
-#endif
-#endif
+//! Thread-safe function for replacing a volatile value if it matches the
+//! comparand. Returns the initial value.
 
-namespace Core
+inline long atomicCompareExchange(volatile long& value, long exchange, long comparand)
 {
+	return atomicCompareExchange(const_cast<long&>(value), exchange, comparand);
+}
 
 ////////////////////////////////////////////////////////////////////////////////
-//! Thread-safe function for incrementing the value by one.
+//! Thread-safe function for replacing the 64-bit value if it matches the
+//! comparand. Returns the initial value.
 
-inline long atomicIncrement(long& value)
+inline longlong atomicCompareExchange64(longlong& value, longlong exchange, longlong comparand)
 {
-	return InterlockedIncrement(&value);
+	atomicCompareSwap(value, comparand, exchange);
+
+	return comparand;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//! Thread-safe function for decrementing the value by one.
+//! Thread-safe function for replacing a volatile 64-bit value if it matches the
+//! comparand. Returns the initial value.
 
-inline long atomicDecrement(long& value)
+inline longlong atomicCompareExchange64(volatile longlong& value, longlong exchange, longlong comparand)
 {
-	return InterlockedDecrement(&value);
+	return atomicCompareExchange64(const_cast<longlong&>(value), exchange, comparand);
 }
 
 //namespace Core
 }
 
-#endif
-
 #endif // CORE_INTERLOCKED_HPP
@@ -0,0 +1,312 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   MpmcQueue.hpp
+//! \brief  The MpmcQueue class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_MPMCQUEUE_HPP
+#define CORE_MPMCQUEUE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Atomic.hpp"
+#include "AlignedArray.hpp"
+#include "CacheLine.hpp"
+#include "InvalidArgException.hpp"
+#include "ThreadUtils.hpp"
+#include <new>
+#ifdef CORE_HAS_RVALUE_REFS
+#include <utility>
+#endif
+
+// The debug CRT version of 'new' doesn't support placement new.
+#ifdef _MSC_VER
+#pragma push_macro("new")
+#undef new
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A bounded, lock-free queue that any number of threads can push on to and
+//! pop from at the same time.
+//!
+//! The values are held in a ring buffer where each slot has a sequence number
+//! that says whether it's ready to be written or read for the current lap of
+//! the ring. A push or pop claims its position with a single compare-exchange
+//! on the tail or head, which are on separate cache lines, and then publishes
+//! the slot by advancing its sequence number. Producers and consumers only
+//! contend with each other when the queue is nearly full or empty.
+//!
+//! The copy constructor and assignment operator of T must not throw, as a
+//! slot cannot be given back once it's been claimed.
+
+template <typename T>
+class MpmcQueue /*: private NotCopyable*/
+{
+public:
+	//! Construction with the capacity, which must be a power of two.
+	explicit MpmcQueue(size_t capacity);
+
+	//! Destructor.
+	~MpmcQueue();
+
+	//
+	// Properties.
+	//
+
+	//! Get the maximum number of values the queue can hold.
+	size_t capacity() const;
+
+	//! Get the number of values in the queue.
+	size_t size() const;
+
+	//! Query if the queue is empty.
+	bool empty() const;
+
+	//
+	// Methods.
+	//
+
+	//! Push a value on to the tail of the queue, unless it's full.
+	bool tryPush(const T& value);
+
+	//! Pop the value at the head of the queue, unless it's empty.
+	bool tryPop(T& value);
+
+	//! Push a value on to the tail of the queue, waiting until there is space.
+	void push(const T& value);
+
+	//! Pop the value at the head of the queue, waiting until there is one.
+	void pop(T& value);
+
+private:
+	//! A slot in the ring buffer.
+	struct Slot
+	{
+		//! The storage for a value.
+		union Storage
+		{
+			char		m_bytes[sizeof(T)];
+			double		m_double;
+			long double	m_longDouble;
+			long		m_long;
+			void*		m_pointer;
+		};
+
+		size_t	m_sequence;		//!< The position the slot is ready for.
+		Storage	m_storage;		//!< The storage for the value.
+	};
+
+	//! The ring buffer type.
+	typedef AlignedArray<Slot> Slots;
+
+	//
+	// Members.
+	//
+	Slots			m_slots;		//!< The ring buffer.
+	size_t			m_mask;			//!< The mask to map a position to a slot.
+	CachePadding<>	m_padding1;		//!< Keep the tail off the read-only members.
+	size_t			m_tail;			//!< The position of the next push.
+	CachePadding<>	m_padding2;		//!< Keep the head off the tail.
+	size_t			m_head;			//!< The position of the next pop.
+	CachePadding<>	m_padding3;		//!< Keep the head off whatever follows.
+
+	//
+	// Internal methods.
+	//
+
+	//! Get the value held in a slot.
+	static T* slotValue(Slot& slot);
+
+	// NotCopyable.
+	MpmcQueue(const MpmcQueue&);
+	MpmcQueue& operator=(const MpmcQueue&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the capacity, which must be a power of two no less than 2.
+
+template <typename T>
+inline MpmcQueue<T>::MpmcQueue(size_t capacity)
+	: m_slots(capacity, Slots::DEFAULT_ALIGNMENT, Slots::UNINITIALISED)
+	, m_mask(capacity - 1)
+	, m_tail(0)
+	, m_head(0)
+{
+	if ( (capacity < 2) || ((capacity & m_mask) != 0) )
+		throw InvalidArgException(TXT("The queue capacity must be a power of two"));
+
+	for (size_t i = 0; i != capacity; ++i)
+		m_slots[i].m_sequence = i;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. Any values still in the queue are destroyed.
+
+template <typename T>
+inline MpmcQueue<T>::~MpmcQueue()
+{
+	for (size_t position = m_head; position != m_tail; ++position)
+		slotValue(m_slots[position & m_mask])->~T();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the maximum number of values the queue can hold.
+
+template <typename T>
+inline size_t MpmcQueue<T>::capacity() const
+{
+	return m_mask + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of values in the queue. The value may be stale by the time
+//! it's used.
+
+template <typename T>
+inline size_t MpmcQueue<T>::size() const
+{
+	const size_t head = atomicLoad(m_head, MEMORY_ORDER_ACQUIRE);
+	const size_t tail = atomicLoad(m_tail, MEMORY_ORDER_ACQUIRE);
+	const size_t count = tail - head;
+
+	return (count < capacity()) ? count : capacity();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the queue is empty. The value may be stale by the time it's used.
+
+template <typename T>
+inline bool MpmcQueue<T>::empty() const
+{
+	return (size() == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Push a value on to the tail of the queue, unless it's full. Returns false
+//! if the queue is full.
+
+template <typename T>
+inline bool MpmcQueue<T>::tryPush(const T& value)
+{
+	size_t position = atomicLoad(m_tail, MEMORY_ORDER_RELAXED);
+
+	for (;;)
+	{
+		Slot&           slot = m_slots[position & m_mask];
+		const size_t    sequence = atomicLoad(slot.m_sequence, MEMORY_ORDER_ACQUIRE);
+		const ptrdiff_t lap = static_cast<ptrdiff_t>(sequence - position);
+
+		if (lap == 0)
+		{
+			// Claim the slot, or discover the new tail if another producer won.
+			if (atomicCompareSwap(m_tail, position, position+1, MEMORY_ORDER_RELAXED))
+			{
+				new(slot.m_storage.m_bytes) T(value);
+				atomicStore(slot.m_sequence, position+1, MEMORY_ORDER_RELEASE);
+				return true;
+			}
+		}
+		else if (lap < 0)
+		{
+			// The slot still holds the value from the previous lap.
+			return false;
+		}
+		else
+		{
+			position = atomicLoad(m_tail, MEMORY_ORDER_RELAXED);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Pop the value at the head of the queue, unless it's empty. Returns false if
+//! the queue is empty.
+
+template <typename T>
+inline bool MpmcQueue<T>::tryPop(T& value)
+{
+	size_t position = atomicLoad(m_head, MEMORY_ORDER_RELAXED);
+
+	for (;;)
+	{
+		Slot&           slot = m_slots[position & m_mask];
+		const size_t    sequence = atomicLoad(slot.m_sequence, MEMORY_ORDER_ACQUIRE);
+		const ptrdiff_t lap = static_cast<ptrdiff_t>(sequence - (position+1));
+
+		if (lap == 0)
+		{
+			// Claim the slot, or discover the new head if another consumer won.
+			if (atomicCompareSwap(m_head, position, position+1, MEMORY_ORDER_RELAXED))
+			{
+				T* stored = slotValue(slot);
+
+#ifdef CORE_HAS_RVALUE_REFS
+				value = std::move(*stored);
+#else
+				value = *stored;
+#endif
+				stored->~T();
+
+				// Make the slot ready for the next lap.
+				atomicStore(slot.m_sequence, position+m_mask+1, MEMORY_ORDER_RELEASE);
+				return true;
+			}
+		}
+		else if (lap < 0)
+		{
+			// The slot hasn't been written for this lap yet.
+			return false;
+		}
+		else
+		{
+			position = atomicLoad(m_head, MEMORY_ORDER_RELAXED);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Push a value on to the tail of the queue, waiting until there is space. The
+//! calling thread yields while it waits, so this is only suitable when the
+//! consumers are expected to keep up.
+
+template <typename T>
+inline void MpmcQueue<T>::push(const T& value)
+{
+	while (!tryPush(value))
+		yieldThread();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Pop the value at the head of the queue, waiting until there is one. The
+//! calling thread yields while it waits, so this is only suitable when the
+//! producers are expected to keep up.
+
+template <typename T>
+inline void MpmcQueue<T>::pop(T& value)
+{
+	while (!tryPop(value))
+		yieldThread();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the value held in a slot.
+
+template <typename T>
+inline T* MpmcQueue<T>::slotValue(Slot& slot)
+{
+	return reinterpret_cast<T*>(slot.m_storage.m_bytes);
+}
+
+//namespace Core
+}
+
+#ifdef _MSC_VER
+#pragma pop_macro("new")
+#endif
+
+#endif // CORE_MPMCQUEUE_HPP
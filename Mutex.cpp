@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Mutex.cpp
+//! \brief  The Mutex class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "Mutex.hpp"
+#include "RuntimeException.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Avoid bringing in <windows.h>.
+
+#if (!defined(__GNUC__)) || (defined(__GNUC__) && !defined(_WINBASE_H))
+
+extern "C" void* __stdcall CreateEventA(void* attributes, int manualReset, int initialState, const char* name);
+extern "C" int __stdcall SetEvent(void* event);
+extern "C" unsigned long __stdcall WaitForSingleObject(void* handle, unsigned long milliseconds);
+extern "C" int __stdcall CloseHandle(void* handle);
+
+#define INFINITE	0xFFFFFFFF
+
+#endif
+
+#ifdef _MSC_VER
+extern "C" void __cdecl _mm_pause();
+#pragma intrinsic(_mm_pause)
+#endif
+
+namespace Core
+{
+
+namespace
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Tell the processor the thread is spinning, so that it yields to the other
+//! hardware thread on the core and doesn't mis-speculate the loop's exit.
+
+inline void cpuPause()
+{
+#ifdef _MSC_VER
+	_mm_pause();
+#else
+	__builtin_ia32_pause();
+#endif
+}
+
+//namespace
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor. The mutex never spins.
+
+Mutex::Mutex()
+	: m_state(UNLOCKED)
+	, m_spinLimit(0)
+	, m_spinEstimate(0)
+	, m_event(::CreateEventA(nullptr, false, false, nullptr))
+{
+	if (m_event == nullptr)
+		throw RuntimeException(TXT("Failed to create a mutex"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the maximum number of times to spin before blocking.
+
+Mutex::Mutex(uint spinLimit)
+	: m_state(UNLOCKED)
+	, m_spinLimit(spinLimit)
+	, m_spinEstimate(0)
+	, m_event(::CreateEventA(nullptr, false, false, nullptr))
+{
+	if (m_event == nullptr)
+		throw RuntimeException(TXT("Failed to create a mutex"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. The lock must not be held.
+
+Mutex::~Mutex()
+{
+	ASSERT(m_state == UNLOCKED);
+
+	::CloseHandle(m_event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Acquire the lock when another thread holds it.
+//!
+//! If the mutex spins, it polls the lock for a while first, in the hope the
+//! holder is running and about to release it. The number of polls adapts to
+//! a running average of the number that succeeded, limited to the spin limit.
+//! A thread that then blocks marks the lock as contended, so that the thread
+//! that releases it knows to wake a waiter. A woken thread also marks it as
+//! contended, as it can't know whether there are other waiters.
+
+void Mutex::lockContended()
+{
+	if (m_spinLimit != 0)
+	{
+		const long estimate = atomicLoad(m_spinEstimate, MEMORY_ORDER_RELAXED);
+		const long maximum = (estimate * 2) + 10;
+		const long limit = (maximum < static_cast<long>(m_spinLimit)) ? maximum : static_cast<long>(m_spinLimit);
+		long spins = 0;
+		bool acquired = false;
+
+		for (; (spins != limit) && !acquired; ++spins)
+		{
+			long state = atomicLoad(m_state, MEMORY_ORDER_RELAXED);
+
+			if (state == UNLOCKED)
+				acquired = atomicCompareSwap(m_state, state, static_cast<long>(LOCKED), MEMORY_ORDER_ACQUIRE);
+			else
+				cpuPause();
+		}
+
+		atomicStore(m_spinEstimate, estimate + ((spins - estimate) / 8), MEMORY_ORDER_RELAXED);
+
+		if (acquired)
+			return;
+	}
+
+	while (atomicExchange(m_state, static_cast<long>(CONTENDED), MEMORY_ORDER_ACQUIRE) != UNLOCKED)
+		::WaitForSingleObject(m_event, INFINITE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wake a waiting thread. The kernel event is auto reset, so if no thread is
+//! blocked on it yet, the next one to wait returns immediately.
+
+void Mutex::wakeWaiter()
+{
+	::SetEvent(m_event);
+}
+
+//namespace Core
+}
@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Mutex.hpp
+//! \brief  The Mutex class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_MUTEX_HPP
+#define CORE_MUTEX_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Atomic.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A non-recursive mutex that only enters the kernel when a thread has to
+//! block, or be woken.
+//!
+//! The lock is a single word that is unlocked, locked, or locked with threads
+//! waiting. Locking an unlocked mutex is a single compare-and-swap and
+//! unlocking it a single exchange; the kernel event a waiting thread blocks on
+//! is only signalled when the exchange shows there may be a waiter. Use it
+//! with ScopedLock.
+
+class Mutex /*: private NotCopyable*/
+{
+public:
+	//! Default constructor.
+	Mutex();
+
+	//! Destructor.
+	~Mutex();
+
+	//
+	// Methods.
+	//
+
+	//! Acquire the lock, waiting until it's available.
+	void lock();
+
+	//! Acquire the lock, unless another thread holds it.
+	bool tryLock();
+
+	//! Release the lock.
+	void unlock();
+
+protected:
+	//! Construction with the maximum number of times to spin before blocking.
+	explicit Mutex(uint spinLimit);
+
+private:
+	//! The states of the lock.
+	enum State
+	{
+		UNLOCKED = 0,	//!< Not held.
+		LOCKED = 1,		//!< Held, with no waiters.
+		CONTENDED = 2,	//!< Held, with possible waiters.
+	};
+
+	//
+	// Members.
+	//
+	long	m_state;		//!< The state of the lock.
+	uint	m_spinLimit;	//!< The maximum number of times to spin before blocking.
+	long	m_spinEstimate;	//!< The average number of spins that acquired the lock.
+	void*	m_event;		//!< The kernel event waiting threads block on.
+
+	//
+	// Internal methods.
+	//
+
+	//! Acquire the lock when another thread holds it.
+	void lockContended();
+
+	//! Wake a waiting thread.
+	void wakeWaiter();
+
+	// NotCopyable.
+	Mutex(const Mutex&);
+	Mutex& operator=(const Mutex&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Acquire the lock, waiting until it's available. The lock is not recursive.
+
+inline void Mutex::lock()
+{
+	long state = UNLOCKED;
+
+	if (!atomicCompareSwap(m_state, state, static_cast<long>(LOCKED), MEMORY_ORDER_ACQUIRE))
+		lockContended();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Acquire the lock, unless another thread holds it. Returns false if the lock
+//! is held.
+
+inline bool Mutex::tryLock()
+{
+	long state = UNLOCKED;
+
+	return atomicCompareSwap(m_state, state, static_cast<long>(LOCKED), MEMORY_ORDER_ACQUIRE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Release the lock, which must be held by the calling thread.
+
+inline void Mutex::unlock()
+{
+	if (atomicExchange(m_state, static_cast<long>(UNLOCKED), MEMORY_ORDER_RELEASE) == CONTENDED)
+		wakeWaiter();
+}
+
+//namespace Core
+}
+
+#endif // CORE_MUTEX_HPP
@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ObjectPool.hpp
+//! \brief  The ObjectPool class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_OBJECTPOOL_HPP
+#define CORE_OBJECTPOOL_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "BlockPool.hpp"
+#include <new>
+
+// The debug CRT version of 'new' doesn't support placement new.
+#ifdef _MSC_VER
+#pragma push_macro("new")
+#undef new
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A pool of objects of a single type. The objects are constructed in blocks
+//! allocated from a BlockPool and so, in the steady state, creating and
+//! destroying them does not touch the heap. An object can be destroyed by any
+//! thread. See PooledObject for a type that is always allocated from a pool.
+
+template <typename T>
+class ObjectPool /*: private NotCopyable*/
+{
+public:
+	//! Default constructor.
+	ObjectPool();
+
+	//
+	// Properties.
+	//
+
+	//! Get the underlying pool of blocks.
+	BlockPool& blocks();
+
+	//
+	// Methods.
+	//
+
+	//! Create an object using its default constructor.
+	T* create();
+
+	//! Create an object using a single argument constructor.
+	template <typename A1>
+	T* create(const A1& a1);
+
+	//! Create an object using a two argument constructor.
+	template <typename A1, typename A2>
+	T* create(const A1& a1, const A2& a2);
+
+	//! Destroy an object.
+	void destroy(T* object);
+
+private:
+	//
+	// Members.
+	//
+	BlockPool	m_blocks;	//!< The pool of blocks.
+
+	// NotCopyable.
+	ObjectPool(const ObjectPool&);
+	ObjectPool& operator=(const ObjectPool&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+template <typename T>
+inline ObjectPool<T>::ObjectPool()
+	: m_blocks(sizeof(T))
+{
+	STATIC_ASSERT(sizeof(T) <= BlockPool::MAX_BLOCK_SIZE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the underlying pool of blocks.
+
+template <typename T>
+inline BlockPool& ObjectPool<T>::blocks()
+{
+	return m_blocks;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create an object using its default constructor.
+
+template <typename T>
+inline T* ObjectPool<T>::create()
+{
+	void* block = m_blocks.allocate();
+
+	try
+	{
+		return ::new(block) T();
+	}
+	catch (...)
+	{
+		m_blocks.deallocate(block);
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create an object using a single argument constructor.
+
+template <typename T>
+template <typename A1>
+inline T* ObjectPool<T>::create(const A1& a1)
+{
+	void* block = m_blocks.allocate();
+
+	try
+	{
+		return ::new(block) T(a1);
+	}
+	catch (...)
+	{
+		m_blocks.deallocate(block);
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create an object using a two argument constructor.
+
+template <typename T>
+template <typename A1, typename A2>
+inline T* ObjectPool<T>::create(const A1& a1, const A2& a2)
+{
+	void* block = m_blocks.allocate();
+
+	try
+	{
+		return ::new(block) T(a1, a2);
+	}
+	catch (...)
+	{
+		m_blocks.deallocate(block);
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy an object. The object can be null.
+
+template <typename T>
+inline void ObjectPool<T>::destroy(T* object)
+{
+	if (object == nullptr)
+		return;
+
+	object->~T();
+	m_blocks.deallocate(object);
+}
+
+//namespace Core
+}
+
+#ifdef _MSC_VER
+#pragma pop_macro("new")
+#endif
+
+#endif // CORE_OBJECTPOOL_HPP
@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   PooledObject.hpp
+//! \brief  The PooledObject class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_POOLEDOBJECT_HPP
+#define CORE_POOLEDOBJECT_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "BlockPool.hpp"
+#include <new>
+
+// The class-specific operators can't be declared whilst 'new' is remapped.
+#ifdef _MSC_VER
+#pragma push_macro("new")
+#undef new
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A base class for types whose instances are always allocated from a pool,
+//! e.g. class Message : public PooledObject<Message>. The class-specific new
+//! and delete operators mean that objects returned by 'new' are taken from the
+//! pool and that the 'delete' done by UniquePtr, SharedPtr and RefCounted puts
+//! them back, without any changes to the smart pointers. An object of a class
+//! derived from T that is larger than the pool's blocks is allocated from the
+//! heap instead. The size passed to 'delete' decides where the memory goes
+//! back to, so if an object of a derived class is deleted through a pointer
+//! to a base class that base class must have a virtual destructor.
+//!
+//! There is one pool per type, which is constructed during static
+//! initialisation, so objects must not be created by other static objects.
+
+template <typename T>
+class PooledObject
+{
+public:
+	//! Allocate the memory for an object.
+	static void* operator new(size_t size);
+
+	//! Free the memory for an object.
+	static void operator delete(void* object, size_t size);
+
+	//! Construct an object in existing memory.
+	static void* operator new(size_t size, void* place);
+
+	//! Called if the constructor of an object in existing memory throws.
+	static void operator delete(void* object, void* place);
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+	//! Allocate the memory for an object, via the debug CRT 'new'.
+	static void* operator new(size_t size, int blockType, const char* file, int line);
+
+	//! Free the memory for an object whose constructor threw, via the debug CRT 'new'.
+	static void operator delete(void* object, int blockType, const char* file, int line);
+#endif
+
+	//
+	// Class methods.
+	//
+
+	//! Get the pool the objects are allocated from.
+	static BlockPool& pool();
+
+protected:
+	//! Default constructor.
+	PooledObject();
+
+	//! Destructor.
+	~PooledObject();
+
+private:
+	//
+	// Class members.
+	//
+	static BlockPool	s_pool;		//!< The pool of objects.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! The pool of objects.
+
+template <typename T>
+BlockPool PooledObject<T>::s_pool(sizeof(T));
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+template <typename T>
+inline PooledObject<T>::PooledObject()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+template <typename T>
+inline PooledObject<T>::~PooledObject()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Allocate the memory for an object. An object too large for the pool's
+//! blocks, i.e. of a larger derived class, is allocated from the heap.
+
+template <typename T>
+inline void* PooledObject<T>::operator new(size_t size)
+{
+	if (size > s_pool.blockSize())
+		return ::operator new(size);
+
+	return s_pool.allocate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Free the memory for an object, which goes back to where the size says it
+//! was allocated from.
+
+template <typename T>
+inline void PooledObject<T>::operator delete(void* object, size_t size)
+{
+	if (size > s_pool.blockSize())
+		::operator delete(object);
+	else
+		s_pool.deallocate(object);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construct an object in existing memory, e.g. a block from an ObjectPool or
+//! the control block of makeShared(). This is needed because the class-specific
+//! 'new' hides the global placement form.
+
+template <typename T>
+inline void* PooledObject<T>::operator new(size_t size, void* place)
+{
+	return ::operator new(size, place);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Called if the constructor of an object in existing memory throws. The
+//! memory belongs to the caller so there is nothing to free.
+
+template <typename T>
+inline void PooledObject<T>::operator delete(void* object, void* place)
+{
+	::operator delete(object, place);
+}
+
+#if defined(_MSC_VER) && defined(_DEBUG)
+
+////////////////////////////////////////////////////////////////////////////////
+//! Allocate the memory for an object, via the debug CRT 'new'. Pooled objects
+//! are not tracked by the debug CRT.
+
+template <typename T>
+inline void* PooledObject<T>::operator new(size_t size, int /*blockType*/, const char* /*file*/, int /*line*/)
+{
+	return operator new(size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Free the memory for an object whose constructor threw, via the debug CRT
+//! 'new'. The size isn't passed, so the pool is asked whether it allocated the
+//! block instead.
+
+template <typename T>
+inline void PooledObject<T>::operator delete(void* object, int /*blockType*/, const char* /*file*/, int /*line*/)
+{
+	if (s_pool.isOwnBlock(object))
+		s_pool.deallocate(object);
+	else
+		::operator delete(object);
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the pool the objects are allocated from.
+
+template <typename T>
+inline BlockPool& PooledObject<T>::pool()
+{
+	return s_pool;
+}
+
+//namespace Core
+}
+
+#ifdef _MSC_VER
+#pragma pop_macro("new")
+#endif
+
+#endif // CORE_POOLEDOBJECT_HPP
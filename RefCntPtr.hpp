@@ -45,6 +45,15 @@ public:
 	template <typename U>
 	RefCntPtr(const RefCntPtr<U>& refCnfPtr);
 
+#ifdef CORE_HAS_RVALUE_REFS
+	//! Move constructor.
+	RefCntPtr(RefCntPtr&& refCnfPtr) CORE_NOEXCEPT;
+
+	//! Move constructor for sub-types of T.
+	template <typename U>
+	RefCntPtr(RefCntPtr<U>&& refCnfPtr) CORE_NOEXCEPT;
+#endif
+
 	//! Destructor.
 	~RefCntPtr();
 
@@ -59,6 +68,15 @@ public:
 	template <typename U>
 	RefCntPtr& operator=(const RefCntPtr<U>& refCnfPtr);
 
+#ifdef CORE_HAS_RVALUE_REFS
+	//! Move assignment operator.
+	RefCntPtr& operator=(RefCntPtr&& refCnfPtr) CORE_NOEXCEPT;
+
+	//! Move assignment operator for sub-types of T.
+	template <typename U>
+	RefCntPtr& operator=(RefCntPtr<U>&& refCnfPtr) CORE_NOEXCEPT;
+#endif
+
 	//
 	// Methods.
 	//
@@ -136,6 +154,33 @@ inline RefCntPtr<T>::RefCntPtr(const RefCntPtr<U>& refCnfPtr)
 		this->m_ptr->incRefCount();
 }
 
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move constructor. Takes over ownership from another pointer, which is left
+//! empty, without changing the reference count.
+
+template <typename T>
+inline RefCntPtr<T>::RefCntPtr(RefCntPtr&& refCnfPtr) CORE_NOEXCEPT
+	: SmartPtr<T>(refCnfPtr.m_ptr)
+{
+	refCnfPtr.m_ptr = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move constructor for sub-types of T. Takes over ownership from another
+//! pointer, which is left empty, without changing the reference count.
+
+template <typename T>
+template <typename U>
+inline RefCntPtr<T>::RefCntPtr(RefCntPtr<U>&& refCnfPtr) CORE_NOEXCEPT
+	: SmartPtr<T>(refCnfPtr.m_ptr)
+{
+	refCnfPtr.m_ptr = nullptr;
+}
+
+#endif // CORE_HAS_RVALUE_REFS
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Destructor.
 
@@ -173,6 +218,47 @@ inline RefCntPtr<T>& RefCntPtr<T>::operator=(const RefCntPtr<U>& refCnfPtr)
 	return *this;
 }
 
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move assignment operator. Releases the current resource and takes over
+//! ownership from another pointer, which is left empty.
+
+template <typename T>
+inline RefCntPtr<T>& RefCntPtr<T>::operator=(RefCntPtr&& refCnfPtr) CORE_NOEXCEPT
+{
+	// Ignore self-assignment.
+	if (this != &refCnfPtr)
+	{
+		T* ptr = refCnfPtr.m_ptr;
+
+		refCnfPtr.m_ptr = nullptr;
+
+		reset(ptr);
+	}
+
+	return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move assignment operator for sub-types of T. Releases the current resource
+//! and takes over ownership from another pointer, which is left empty.
+
+template <typename T>
+template <typename U>
+inline RefCntPtr<T>& RefCntPtr<T>::operator=(RefCntPtr<U>&& refCnfPtr) CORE_NOEXCEPT
+{
+	T* ptr = refCnfPtr.m_ptr;
+
+	refCnfPtr.m_ptr = nullptr;
+
+	reset(ptr);
+
+	return *this;
+}
+
+#endif // CORE_HAS_RVALUE_REFS
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Change pointer ownership.
 
@@ -11,7 +11,7 @@
 #pragma once
 #endif
 
-#include "Interlocked.hpp"
+#include "Atomic.hpp"
 
 namespace Core
 {
@@ -46,6 +46,13 @@ protected:
 	//! Destructor.
 	virtual ~RefCounted();
 
+	//
+	// Internal methods.
+	//
+
+	//! Destroy the object once the last reference has been released.
+	virtual void destroy();
+
 private:
 	//
 	// Members.
@@ -78,36 +85,48 @@ inline RefCounted::~RefCounted()
 
 inline long RefCounted::refCount() const
 {
-	return m_refCount;
+	return Core::atomicLoad(m_refCount, MEMORY_ORDER_RELAXED);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//! Increase the reference count by one.
+//! Increase the reference count by one. No ordering is needed as the new
+//! reference is always made from an existing one.
 
 inline long RefCounted::incRefCount()
 {
 	ASSERT(m_refCount > 0);
 
-	long newCount = Core::atomicIncrement(m_refCount);
+	long newCount = Core::atomicFetchAdd(m_refCount, 1L, MEMORY_ORDER_RELAXED) + 1;
 
 	return newCount;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//! Decrease the reference count by one
+//! Decrease the reference count by one. The release makes any writes through
+//! this reference visible to the thread that destroys the object and the
+//! acquire makes those writes visible to the destructor.
 
 inline long RefCounted::decRefCount()
 {
 	ASSERT(m_refCount > 0);
 
-	long newCount = Core::atomicDecrement(m_refCount);
+	long newCount = Core::atomicFetchSub(m_refCount, 1L, MEMORY_ORDER_ACQ_REL) - 1;
 
 	if (newCount == 0)
-		delete this;
+		destroy();
 
 	return newCount;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy the object once the last reference has been released. By default
+//! the object is deleted immediately, derived classes can defer it instead.
+
+inline void RefCounted::destroy()
+{
+	delete this;
+}
+
 //namespace Core
 }
 
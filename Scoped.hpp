@@ -41,9 +41,23 @@ public:
 	//! Construction from a resource, its destroy function and null value.
 	Scoped(T resource, Deleter deleter, T null = 0);
 
+#ifdef CORE_HAS_RVALUE_REFS
+	//! Move constructor.
+	Scoped(Scoped&& guard) CORE_NOEXCEPT;
+#endif
+
 	//! Destructor.
 	~Scoped();
 
+#ifdef CORE_HAS_RVALUE_REFS
+	//
+	// Operators.
+	//
+
+	//! Move assignment operator.
+	Scoped& operator=(Scoped&& guard) CORE_NOEXCEPT;
+#endif
+
 	//
 	// Properties.
 	//
@@ -112,6 +126,23 @@ inline Scoped<T>::Scoped(T resource, Deleter deleter, T null)
 {
 }
 
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move constructor. Takes over ownership of the resource from another guard,
+//! which is left empty.
+
+template <typename T>
+inline Scoped<T>::Scoped(Scoped&& guard) CORE_NOEXCEPT
+	: m_resource(guard.m_resource)
+	, m_deleter(guard.m_deleter)
+	, m_null(guard.m_null)
+{
+	guard.m_resource = guard.m_null;
+}
+
+#endif // CORE_HAS_RVALUE_REFS
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Destructor.
 
@@ -121,6 +152,32 @@ inline Scoped<T>::~Scoped()
 	reset();
 }
 
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move assignment operator. Destroys the current resource and takes over
+//! ownership of the resource from another guard, which is left empty.
+
+template <typename T>
+inline Scoped<T>& Scoped<T>::operator=(Scoped&& guard) CORE_NOEXCEPT
+{
+	// Ignore self-assignment.
+	if (this != &guard)
+	{
+		reset();
+
+		m_resource = guard.m_resource;
+		m_deleter = guard.m_deleter;
+		m_null = guard.m_null;
+
+		guard.m_resource = guard.m_null;
+	}
+
+	return *this;
+}
+
+#endif // CORE_HAS_RVALUE_REFS
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Get the managed resource.
 
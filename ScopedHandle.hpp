@@ -0,0 +1,286 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ScopedHandle.hpp
+//! \brief  The ScopedHandle class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_SCOPEDHANDLE_HPP
+#define CORE_SCOPEDHANDLE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "BadLogicException.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The deleter for a ScopedHandle whose resource is destroyed by a free
+//! function. The function can return any type, the result is ignored. The
+//! null value is given as an integer and cast to the resource type, e.g. -1
+//! for INVALID_HANDLE_VALUE.
+
+template <typename T, typename R, R (*Fn)(T), ptrdiff_t Null = 0>
+struct FnDeleter
+{
+	//! Get the resource specific null value.
+	static T null()
+	{
+		return (T)(Null);
+	}
+
+	//! Destroy the resource.
+	static void destroy(T resource)
+	{
+		Fn(resource);
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! The deleter for a ScopedHandle whose resource is destroyed by a Windows API
+//! function, e.g. StdCallDeleter<void*, DWORD, NetApiBufferFree>. This is only
+//! different from FnDeleter on 32-bit builds, where the calling convention is
+//! part of the function type.
+
+template <typename T, typename R, R (__stdcall *Fn)(T), ptrdiff_t Null = 0>
+struct StdCallDeleter
+{
+	//! Get the resource specific null value.
+	static T null()
+	{
+		return (T)(Null);
+	}
+
+	//! Destroy the resource.
+	static void destroy(T resource)
+	{
+		Fn(resource);
+	}
+};
+
+// Forward declarations.
+template <typename T, typename D>
+class ScopedHandle;
+
+template <typename T, typename D>
+T* attachTo(ScopedHandle<T, D>& guard);
+
+////////////////////////////////////////////////////////////////////////////////
+//! A class for temporarily managing the lifetime of resources that require a
+//! custom destroy function, where the function is known at compile time.
+//! Unlike Scoped the deleter and null value are provided by the deleter type,
+//! D, so the guard is the size of the resource and the call to destroy it can
+//! be inlined. D must provide the static methods T null() and destroy(T).
+
+template <typename T, typename D>
+class ScopedHandle /*: private NotCopyable*/
+{
+public:
+	//! Default constructor.
+	ScopedHandle();
+
+	//! Construction from a resource.
+	explicit ScopedHandle(T resource);
+
+#ifdef CORE_HAS_RVALUE_REFS
+	//! Move constructor.
+	ScopedHandle(ScopedHandle&& guard) CORE_NOEXCEPT;
+#endif
+
+	//! Destructor.
+	~ScopedHandle();
+
+#ifdef CORE_HAS_RVALUE_REFS
+	//
+	// Operators.
+	//
+
+	//! Move assignment operator.
+	ScopedHandle& operator=(ScopedHandle&& guard) CORE_NOEXCEPT;
+#endif
+
+	//
+	// Properties.
+	//
+
+	//! Get the managed resource.
+	T get() const;
+
+	//
+	// Methods.
+	//
+
+	//! Query if we are not owning a resource.
+	bool empty() const;
+
+	//! Destroy the resource.
+	void reset();
+
+	//! Acquire ownership of a resource.
+	void attach(T resource);
+
+	//! Release ownership of the resource.
+	T detach();
+
+private:
+	//
+	// Members.
+	//
+	T		m_resource;		//!< The value to manage.
+
+	//
+	// Friends.
+	//
+
+	//! Allow attachment via an output parameter.
+	friend T* attachTo<>(ScopedHandle<T, D>& guard);
+
+private:
+	// NotCopyable.
+	ScopedHandle(const ScopedHandle&);
+	ScopedHandle& operator=(const ScopedHandle&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor. This ctor is used with the attachTo() free function.
+
+template <typename T, typename D>
+inline ScopedHandle<T, D>::ScopedHandle()
+	: m_resource(D::null())
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a resource.
+
+template <typename T, typename D>
+inline ScopedHandle<T, D>::ScopedHandle(T resource)
+	: m_resource(resource)
+{
+}
+
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move constructor. Takes over ownership of the resource from another guard,
+//! which is left empty.
+
+template <typename T, typename D>
+inline ScopedHandle<T, D>::ScopedHandle(ScopedHandle&& guard) CORE_NOEXCEPT
+	: m_resource(guard.m_resource)
+{
+	guard.m_resource = D::null();
+}
+
+#endif // CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+template <typename T, typename D>
+inline ScopedHandle<T, D>::~ScopedHandle()
+{
+	reset();
+}
+
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move assignment operator. Destroys the current resource and takes over
+//! ownership of the resource from another guard, which is left empty.
+
+template <typename T, typename D>
+inline ScopedHandle<T, D>& ScopedHandle<T, D>::operator=(ScopedHandle&& guard) CORE_NOEXCEPT
+{
+	// Ignore self-assignment.
+	if (this != &guard)
+	{
+		reset();
+
+		m_resource = guard.m_resource;
+
+		guard.m_resource = D::null();
+	}
+
+	return *this;
+}
+
+#endif // CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the managed resource.
+
+template <typename T, typename D>
+inline T ScopedHandle<T, D>::get() const
+{
+	return m_resource;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if we are not owning a resource.
+
+template <typename T, typename D>
+inline bool ScopedHandle<T, D>::empty() const
+{
+	return (m_resource == D::null());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy the resource.
+
+template <typename T, typename D>
+inline void ScopedHandle<T, D>::reset()
+{
+	if (m_resource != D::null())
+	{
+		D::destroy(m_resource);
+
+		m_resource = D::null();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Acquire ownership of a resource. If a resource is already held it is
+//! destroyed first.
+
+template <typename T, typename D>
+inline void ScopedHandle<T, D>::attach(T resource)
+{
+	reset();
+
+	m_resource = resource;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Release ownership of the resource.
+
+template <typename T, typename D>
+inline T ScopedHandle<T, D>::detach()
+{
+	T resource = m_resource;
+
+	m_resource = D::null();
+
+	return resource;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Helper function to gain access to the internal member so that it can be
+//! passed as an output parameter, without overloading the & operator.
+//! e.g. NetShareEnum(..., attachTo(p), ...).
+
+template <typename T, typename D>
+T* attachTo(ScopedHandle<T, D>& guard)
+{
+	if (!guard.empty())
+		throw BadLogicException(TXT("Cannot attach to a non-empty smart pointer"));
+
+	return &guard.m_resource;
+}
+
+//namespace Core
+}
+
+#endif // CORE_SCOPEDHANDLE_HPP
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ScopedLock.hpp
+//! \brief  The ScopedLock class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_SCOPEDLOCK_HPP
+#define CORE_SCOPEDLOCK_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A class for holding a lock for the lifetime of a scope. The lock type needs
+//! lock() and unlock() methods, such as Mutex and SpinMutex. The lock can be
+//! released early, and re-acquired, within the scope.
+
+template <typename M>
+class ScopedLock /*: private NotCopyable*/
+{
+public:
+	//! Construction from the lock to acquire.
+	explicit ScopedLock(M& mutex);
+
+	//! Destructor.
+	~ScopedLock();
+
+	//
+	// Properties.
+	//
+
+	//! Query if the lock is held.
+	bool isLocked() const;
+
+	//
+	// Methods.
+	//
+
+	//! Re-acquire the lock.
+	void lock();
+
+	//! Release the lock early.
+	void unlock();
+
+private:
+	//
+	// Members.
+	//
+	M&		m_mutex;	//!< The lock.
+	bool	m_locked;	//!< Whether the lock is held.
+
+	// NotCopyable.
+	ScopedLock(const ScopedLock&);
+	ScopedLock& operator=(const ScopedLock&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the lock to acquire.
+
+template <typename M>
+inline ScopedLock<M>::ScopedLock(M& mutex)
+	: m_mutex(mutex)
+	, m_locked(false)
+{
+	m_mutex.lock();
+	m_locked = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. Releases the lock, if still held.
+
+template <typename M>
+inline ScopedLock<M>::~ScopedLock()
+{
+	if (m_locked)
+		m_mutex.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the lock is held.
+
+template <typename M>
+inline bool ScopedLock<M>::isLocked() const
+{
+	return m_locked;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Re-acquire the lock, after releasing it early.
+
+template <typename M>
+inline void ScopedLock<M>::lock()
+{
+	ASSERT(!m_locked);
+
+	m_mutex.lock();
+	m_locked = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Release the lock early.
+
+template <typename M>
+inline void ScopedLock<M>::unlock()
+{
+	ASSERT(m_locked);
+
+	m_locked = false;
+	m_mutex.unlock();
+}
+
+//namespace Core
+}
+
+#endif // CORE_SCOPEDLOCK_HPP
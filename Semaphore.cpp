@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Semaphore.cpp
+//! \brief  The Semaphore class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "Semaphore.hpp"
+#include "InvalidArgException.hpp"
+#include "RuntimeException.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Avoid bringing in <windows.h>.
+
+#if (!defined(__GNUC__)) || (defined(__GNUC__) && !defined(_WINBASE_H))
+
+extern "C" void* __stdcall CreateSemaphoreA(void* attributes, long initialCount, long maximumCount, const char* name);
+extern "C" int __stdcall ReleaseSemaphore(void* semaphore, long releaseCount, long* previousCount);
+extern "C" unsigned long __stdcall WaitForSingleObject(void* handle, unsigned long milliseconds);
+extern "C" int __stdcall CloseHandle(void* handle);
+
+#define INFINITE		0xFFFFFFFF
+#define WAIT_OBJECT_0	0x00000000
+
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the initial and maximum count.
+
+Semaphore::Semaphore(long initial, long maximum)
+	: m_count(initial)
+	, m_maximum(maximum)
+	, m_semaphore(nullptr)
+{
+	if ( (maximum < 1) || (initial < 0) || (initial > maximum) )
+		throw InvalidArgException(TXT("Invalid semaphore count"));
+
+	m_semaphore = ::CreateSemaphoreA(nullptr, 0, LONG_MAX, nullptr);
+
+	if (m_semaphore == nullptr)
+		throw RuntimeException(TXT("Failed to create a semaphore"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+Semaphore::~Semaphore()
+{
+	::CloseHandle(m_semaphore);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Increment the count, waking a waiting thread for each unit. The count is
+//! limited to the maximum, but only once all the waiters have been woken.
+
+void Semaphore::release(long count)
+{
+	ASSERT(count > 0);
+
+	long current = atomicLoad(m_count, MEMORY_ORDER_RELAXED);
+	long next;
+
+	do
+	{
+		if (current < 0)
+			next = ((current + count) < m_maximum) ? (current + count) : m_maximum;
+		else
+			next = (count < (m_maximum - current)) ? (current + count) : m_maximum;
+	}
+	while (!atomicCompareSwap(m_count, current, next, MEMORY_ORDER_RELEASE));
+
+	if (current < 0)
+	{
+		const long waiters = -current;
+
+		::ReleaseSemaphore(m_semaphore, (count < waiters) ? count : waiters, nullptr);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Block until woken by a release, or the timeout expires. If the wait times
+//! out the thread stops counting as a waiter, unless a release has already
+//! woken it, in which case the wake-up is taken. Returns false if the timeout
+//! expired.
+
+bool Semaphore::block(ulong timeout)
+{
+	const ulong milliseconds = (timeout == ULONG_MAX) ? INFINITE : timeout;
+
+	if (::WaitForSingleObject(m_semaphore, milliseconds) == WAIT_OBJECT_0)
+		return true;
+
+	long count = atomicLoad(m_count, MEMORY_ORDER_RELAXED);
+
+	while (count < 0)
+	{
+		if (atomicCompareSwap(m_count, count, count+1, MEMORY_ORDER_RELAXED))
+			return false;
+	}
+
+	::WaitForSingleObject(m_semaphore, INFINITE);
+
+	return true;
+}
+
+//namespace Core
+}
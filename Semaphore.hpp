@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Semaphore.hpp
+//! \brief  The Semaphore class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_SEMAPHORE_HPP
+#define CORE_SEMAPHORE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Atomic.hpp"
+#include <limits.h>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A counting semaphore that only enters the kernel when a thread has to
+//! block, or be woken.
+//!
+//! The count is kept in user mode, and a negative count is the number of
+//! threads waiting. Waiting when the count is positive is a single atomic
+//! decrement. Releasing wakes no more threads than are waiting, and one per
+//! unit released, so there is no thundering herd.
+
+class Semaphore /*: private NotCopyable*/
+{
+public:
+	//! Construction with the initial and maximum count.
+	explicit Semaphore(long initial = 0, long maximum = LONG_MAX);
+
+	//! Destructor.
+	~Semaphore();
+
+	//
+	// Methods.
+	//
+
+	//! Wait until the count is positive, and decrement it.
+	void wait();
+
+	//! Wait, for no longer than a timeout, until the count is positive.
+	bool wait(ulong timeout);
+
+	//! Decrement the count, unless it isn't positive.
+	bool tryWait();
+
+	//! Increment the count, waking a waiting thread for each unit.
+	void release(long count = 1);
+
+private:
+	//
+	// Members.
+	//
+	long	m_count;		//!< The count, or minus the number of waiters.
+	long	m_maximum;		//!< The maximum count.
+	void*	m_semaphore;	//!< The kernel semaphore the waiters block on.
+
+	//
+	// Internal methods.
+	//
+
+	//! Block until woken by a release, or the timeout expires.
+	bool block(ulong timeout);
+
+	// NotCopyable.
+	Semaphore(const Semaphore&);
+	Semaphore& operator=(const Semaphore&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait until the count is positive, and decrement it.
+
+inline void Semaphore::wait()
+{
+	if (atomicFetchSub(m_count, 1L, MEMORY_ORDER_ACQUIRE) <= 0)
+		block(ULONG_MAX);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait, for no longer than a timeout in milliseconds, until the count is
+//! positive, and decrement it. Returns false if the timeout expired.
+
+inline bool Semaphore::wait(ulong timeout)
+{
+	if (atomicFetchSub(m_count, 1L, MEMORY_ORDER_ACQUIRE) > 0)
+		return true;
+
+	return block(timeout);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Decrement the count, unless it isn't positive. Returns false if the count
+//! wasn't positive.
+
+inline bool Semaphore::tryWait()
+{
+	long count = atomicLoad(m_count, MEMORY_ORDER_RELAXED);
+
+	while (count > 0)
+	{
+		if (atomicCompareSwap(m_count, count, count-1, MEMORY_ORDER_ACQUIRE))
+			return true;
+	}
+
+	return false;
+}
+
+//namespace Core
+}
+
+#endif // CORE_SEMAPHORE_HPP
@@ -0,0 +1,192 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   SeqLock.hpp
+//! \brief  The SeqLock class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_SEQLOCK_HPP
+#define CORE_SEQLOCK_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Atomic.hpp"
+#include "ThreadUtils.hpp"
+#include <string.h>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A sequence lock for sharing a small value that is read far more often than
+//! it's written, such as a snapshot of rates or counters. The type must be
+//! trivially copyable, e.g. a POD struct.
+//!
+//! A writer makes the sequence number odd, copies the value in and makes the
+//! sequence number even again. A reader copies the value out between two reads
+//! of the sequence number, and tries again if they differ, or are odd. Readers
+//! never write to the lock, so they don't contend with each other for its
+//! cache line. Writers are serialised by the sequence number, but a stream of
+//! writes can hold off the readers, so it suits values that change rarely.
+//!
+//! The value is stored as words that are copied with relaxed atomic loads and
+//! stores, so a read that overlaps a write is a benign, detected, race.
+
+template <typename T>
+class SeqLock /*: private NotCopyable*/
+{
+public:
+	//! Default constructor. The value is zero-filled.
+	SeqLock();
+
+	//! Construction with the initial value.
+	explicit SeqLock(const T& value);
+
+	//
+	// Properties.
+	//
+
+	//! Get the number of writes made.
+	size_t writes() const;
+
+	//
+	// Methods.
+	//
+
+	//! Read a consistent copy of the value.
+	T read() const;
+
+	//! Try to read a consistent copy of the value, without retrying.
+	bool tryRead(T& value) const;
+
+	//! Replace the value.
+	void write(const T& value);
+
+private:
+	//! The number of words the value is stored in.
+	static const size_t WORDS = (sizeof(T) + sizeof(size_t) - 1) / sizeof(size_t);
+
+	//
+	// Members.
+	//
+	size_t	m_sequence;		//!< The sequence number, which is odd during a write.
+	size_t	m_words[WORDS];	//!< The value.
+
+	// NotCopyable.
+	SeqLock(const SeqLock&);
+	SeqLock& operator=(const SeqLock&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor. The value is zero-filled.
+
+template <typename T>
+inline SeqLock<T>::SeqLock()
+	: m_sequence(0)
+{
+	memset(m_words, 0, sizeof(m_words));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the initial value.
+
+template <typename T>
+inline SeqLock<T>::SeqLock(const T& value)
+	: m_sequence(0)
+{
+	memset(m_words, 0, sizeof(m_words));
+	memcpy(m_words, &value, sizeof(T));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of writes made, e.g. to detect that the value has changed
+//! since it was last read. The value may be stale by the time it's used.
+
+template <typename T>
+inline size_t SeqLock<T>::writes() const
+{
+	return atomicLoad(m_sequence, MEMORY_ORDER_ACQUIRE) / 2;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read a consistent copy of the value, retrying while a write overlaps the
+//! read.
+
+template <typename T>
+inline T SeqLock<T>::read() const
+{
+	T value;
+
+	while (!tryRead(value))
+		yieldThread();
+
+	return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Try to read a consistent copy of the value, without retrying. Returns false
+//! if a write overlapped the read, in which case the value is unspecified.
+
+template <typename T>
+inline bool SeqLock<T>::tryRead(T& value) const
+{
+	const size_t before = atomicLoad(m_sequence, MEMORY_ORDER_ACQUIRE);
+
+	if ((before & 1) != 0)
+		return false;
+
+	size_t words[WORDS];
+
+	for (size_t i = 0; i != WORDS; ++i)
+		words[i] = atomicLoad(m_words[i], MEMORY_ORDER_RELAXED);
+
+	// Stop the copy being moved after the second read of the sequence number.
+	atomicThreadFence(MEMORY_ORDER_ACQUIRE);
+
+	if (atomicLoad(m_sequence, MEMORY_ORDER_RELAXED) != before)
+		return false;
+
+	memcpy(&value, words, sizeof(T));
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Replace the value. Concurrent writers wait for each other.
+
+template <typename T>
+inline void SeqLock<T>::write(const T& value)
+{
+	size_t words[WORDS] = { 0 };
+
+	memcpy(words, &value, sizeof(T));
+
+	size_t sequence = atomicLoad(m_sequence, MEMORY_ORDER_RELAXED);
+
+	for (;;)
+	{
+		if ((sequence & 1) != 0)
+		{
+			yieldThread();
+			sequence = atomicLoad(m_sequence, MEMORY_ORDER_RELAXED);
+		}
+		else if (atomicCompareSwap(m_sequence, sequence, sequence+1, MEMORY_ORDER_ACQUIRE))
+		{
+			break;
+		}
+	}
+
+	// Stop the copy being moved before the sequence number is made odd.
+	atomicThreadFence(MEMORY_ORDER_RELEASE);
+
+	for (size_t i = 0; i != WORDS; ++i)
+		atomicStore(m_words[i], words[i], MEMORY_ORDER_RELAXED);
+
+	atomicStore(m_sequence, sequence+2, MEMORY_ORDER_RELEASE);
+}
+
+//namespace Core
+}
+
+#endif // CORE_SEQLOCK_HPP
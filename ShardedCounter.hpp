@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ShardedCounter.hpp
+//! \brief  The ShardedCounter class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_SHARDEDCOUNTER_HPP
+#define CORE_SHARDEDCOUNTER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "ShardedSlots.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A count of events that is incremented from many threads, such as requests
+//! served or bytes sent. Each thread increments its own shard, so a busy count
+//! doesn't bounce a single cache line between the processors. Reading the
+//! count sums the shards, so is far more expensive than incrementing it.
+
+class ShardedCounter /*: private NotCopyable*/
+{
+public:
+	//! Default constructor.
+	ShardedCounter();
+
+	//
+	// Methods.
+	//
+
+	//! Count an event.
+	void increment();
+
+	//! Count a number of events.
+	void add(longlong count);
+
+	//! Get the count.
+	longlong read() const;
+
+	//! Zero the count.
+	void reset();
+
+private:
+	//
+	// Members.
+	//
+	ShardedSlots	m_slots;	//!< The count for each shard.
+
+	// NotCopyable.
+	ShardedCounter(const ShardedCounter&);
+	ShardedCounter& operator=(const ShardedCounter&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor. The count starts at zero.
+
+inline ShardedCounter::ShardedCounter()
+	: m_slots(1)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Count an event.
+
+inline void ShardedCounter::increment()
+{
+	m_slots.add(0, 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Count a number of events, which must not be negative.
+
+inline void ShardedCounter::add(longlong count)
+{
+	ASSERT(count >= 0);
+
+	m_slots.add(0, count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the count. Events counted while the count is read may be missed.
+
+inline longlong ShardedCounter::read() const
+{
+	return m_slots.sum(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Zero the count. Events counted at the same time may be lost.
+
+inline void ShardedCounter::reset()
+{
+	m_slots.reset();
+}
+
+//namespace Core
+}
+
+#endif // CORE_SHARDEDCOUNTER_HPP
@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ShardedGauge.hpp
+//! \brief  The ShardedGauge class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_SHARDEDGAUGE_HPP
+#define CORE_SHARDEDGAUGE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "ShardedSlots.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A level that goes up and down from many threads, such as the number of
+//! requests in progress or the bytes buffered. Each thread adjusts its own
+//! shard, so a shard on its own can be negative, e.g. when a request starts on
+//! one thread and ends on another, but the sum over the shards is the level.
+
+class ShardedGauge /*: private NotCopyable*/
+{
+public:
+	//! Default constructor.
+	ShardedGauge();
+
+	//
+	// Methods.
+	//
+
+	//! Raise the level by one.
+	void increment();
+
+	//! Lower the level by one.
+	void decrement();
+
+	//! Adjust the level.
+	void add(longlong amount);
+
+	//! Get the level.
+	longlong read() const;
+
+private:
+	//
+	// Members.
+	//
+	ShardedSlots	m_slots;	//!< The adjustments made by each shard.
+
+	// NotCopyable.
+	ShardedGauge(const ShardedGauge&);
+	ShardedGauge& operator=(const ShardedGauge&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor. The level starts at zero.
+
+inline ShardedGauge::ShardedGauge()
+	: m_slots(1)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Raise the level by one.
+
+inline void ShardedGauge::increment()
+{
+	m_slots.add(0, 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Lower the level by one.
+
+inline void ShardedGauge::decrement()
+{
+	m_slots.add(0, -1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Adjust the level by a positive or negative amount.
+
+inline void ShardedGauge::add(longlong amount)
+{
+	m_slots.add(0, amount);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the level. Adjustments made while the level is read may be missed.
+
+inline longlong ShardedGauge::read() const
+{
+	return m_slots.sum(0);
+}
+
+//namespace Core
+}
+
+#endif // CORE_SHARDEDGAUGE_HPP
@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ShardedHistogram.cpp
+//! \brief  The ShardedHistogram class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "ShardedHistogram.hpp"
+#include <math.h>
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+ShardedHistogram::ShardedHistogram()
+	: m_slots(BUCKETS + 1)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of values recorded. Values recorded while the buckets are
+//! read may be missed.
+
+longlong ShardedHistogram::count() const
+{
+	longlong count = 0;
+
+	for (size_t bucket = 0; bucket != BUCKETS; ++bucket)
+		count += m_slots.sum(bucket);
+
+	return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get an upper bound for the value at a fraction of the distribution, e.g.
+//! 0.99 for the 99th percentile. This is the largest value in the bucket that
+//! holds it. Returns zero if no values have been recorded.
+
+ulonglong ShardedHistogram::quantile(double fraction) const
+{
+	ASSERT((fraction >= 0.0) && (fraction <= 1.0));
+
+	longlong counts[BUCKETS];
+	longlong total = 0;
+
+	for (size_t bucket = 0; bucket != BUCKETS; ++bucket)
+	{
+		counts[bucket] = m_slots.sum(bucket);
+		total += counts[bucket];
+	}
+
+	if (total <= 0)
+		return 0;
+
+	longlong rank = static_cast<longlong>(ceil(fraction * static_cast<double>(total)));
+
+	if (rank < 1)
+		rank = 1;
+
+	size_t bucket = 0;
+
+	for (longlong seen = counts[0]; (seen < rank) && (bucket != BUCKETS-1); seen += counts[bucket])
+		++bucket;
+
+	return upperBound(bucket);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the smallest value in a bucket.
+
+ulonglong ShardedHistogram::lowerBound(size_t bucket)
+{
+	ASSERT(bucket < BUCKETS);
+
+	return (bucket == 0) ? 0 : (ulonglong(1) << (bucket - 1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the largest value in a bucket.
+
+ulonglong ShardedHistogram::upperBound(size_t bucket)
+{
+	ASSERT(bucket < BUCKETS);
+
+	return (bucket == BUCKETS-1) ? ~ulonglong(0) : ((ulonglong(1) << bucket) - 1);
+}
+
+//namespace Core
+}
@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ShardedHistogram.hpp
+//! \brief  The ShardedHistogram class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_SHARDEDHISTOGRAM_HPP
+#define CORE_SHARDEDHISTOGRAM_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "ShardedSlots.hpp"
+
+// Visual C++
+#ifdef _MSC_VER
+
+// Manually define the intrinsic to avoid bringing in <intrin.h>.
+extern "C" unsigned char __cdecl _BitScanReverse(unsigned long* index, unsigned long mask);
+
+#pragma intrinsic(_BitScanReverse)
+
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A distribution of values recorded from many threads, such as latencies or
+//! message sizes. Each thread records into its own shard, so recording a value
+//! is as cheap as incrementing a ShardedCounter.
+//!
+//! The buckets are powers of two: bucket 0 holds zero, and bucket N holds the
+//! values from 2^(N-1) up to 2^N - 1, so the bucket is the number of bits
+//! needed for the value. The sum of the values is also kept, for the mean.
+
+class ShardedHistogram /*: private NotCopyable*/
+{
+public:
+	//! The number of buckets.
+	static const size_t BUCKETS = 65;
+
+	//! Default constructor.
+	ShardedHistogram();
+
+	//
+	// Methods.
+	//
+
+	//! Record a value.
+	void record(ulonglong value);
+
+	//! Get the number of values recorded.
+	longlong count() const;
+
+	//! Get the number of values recorded in a bucket.
+	longlong count(size_t bucket) const;
+
+	//! Get the sum of the values recorded.
+	ulonglong sum() const;
+
+	//! Get an upper bound for the value at a fraction of the distribution.
+	ulonglong quantile(double fraction) const;
+
+	//! Discard the values recorded.
+	void reset();
+
+	//
+	// Class methods.
+	//
+
+	//! Get the bucket for a value.
+	static size_t bucket(ulonglong value);
+
+	//! Get the smallest value in a bucket.
+	static ulonglong lowerBound(size_t bucket);
+
+	//! Get the largest value in a bucket.
+	static ulonglong upperBound(size_t bucket);
+
+private:
+	//! The slot that holds the sum of the values.
+	static const size_t SUM_SLOT = BUCKETS;
+
+	//
+	// Members.
+	//
+	ShardedSlots	m_slots;	//!< The bucket counts and sum for each shard.
+
+	// NotCopyable.
+	ShardedHistogram(const ShardedHistogram&);
+	ShardedHistogram& operator=(const ShardedHistogram&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Record a value.
+
+inline void ShardedHistogram::record(ulonglong value)
+{
+	m_slots.add(bucket(value), 1);
+	m_slots.add(SUM_SLOT, static_cast<longlong>(value));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of values recorded in a bucket. Values recorded while the
+//! count is read may be missed.
+
+inline longlong ShardedHistogram::count(size_t bucket) const
+{
+	ASSERT(bucket < BUCKETS);
+
+	return m_slots.sum(bucket);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the sum of the values recorded, which wraps around on overflow.
+
+inline ulonglong ShardedHistogram::sum() const
+{
+	return static_cast<ulonglong>(m_slots.sum(SUM_SLOT));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Discard the values recorded. Values recorded at the same time may be lost.
+
+inline void ShardedHistogram::reset()
+{
+	m_slots.reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the bucket for a value, which is the number of bits needed to hold it.
+
+inline size_t ShardedHistogram::bucket(ulonglong value)
+{
+	if (value == 0)
+		return 0;
+
+#ifdef _MSC_VER
+	unsigned long index = 0;
+	const unsigned long high = static_cast<unsigned long>(value >> 32);
+
+	if (high != 0)
+	{
+		_BitScanReverse(&index, high);
+		return index + 33;
+	}
+
+	_BitScanReverse(&index, static_cast<unsigned long>(value));
+	return index + 1;
+#else
+	return 64 - __builtin_clzll(value);
+#endif
+}
+
+//namespace Core
+}
+
+#endif // CORE_SHARDEDHISTOGRAM_HPP
@@ -0,0 +1,114 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ShardedSlots.cpp
+//! \brief  The ShardedSlots class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "ShardedSlots.hpp"
+#include "AlignedArray.hpp"
+#include "CacheLine.hpp"
+#include "InvalidArgException.hpp"
+
+namespace Core
+{
+
+namespace
+{
+
+//! The number of slots in a cache line.
+const size_t SLOTS_PER_LINE = CACHE_LINE_SIZE / sizeof(size_t);
+
+//namespace
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The slots of a thread. The slots are allocated by the owning thread the
+//! first time it updates them, and are only visible to other threads once the
+//! pointer to them has been published.
+
+struct ShardedSlots::Shard : public ThreadRecord
+{
+	//! Default constructor.
+	Shard()
+		: m_slots(nullptr)
+		, m_storage()
+	{
+	}
+
+	size_t*					m_slots;	//!< The published slots, or null.
+	AlignedArray<size_t>	m_storage;	//!< The storage for the slots.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the number of slots.
+
+ShardedSlots::ShardedSlots(size_t slots)
+	: m_slots(slots)
+	, m_shards()
+{
+	if (slots == 0)
+		throw InvalidArgException(TXT("The number of slots must not be zero"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the sum of a slot over all the shards. The sum is not a snapshot, as the
+//! shards may be updated while it's being calculated.
+
+longlong ShardedSlots::sum(size_t slot) const
+{
+	ASSERT(slot < m_slots);
+
+	size_t sum = 0;
+
+	for (Shard* shard = m_shards.first<Shard>(); shard != nullptr; shard = ThreadRecords::next(shard))
+	{
+		const size_t* slots = atomicLoad(shard->m_slots, MEMORY_ORDER_ACQUIRE);
+
+		if (slots != nullptr)
+			sum += atomicLoad(slots[slot], MEMORY_ORDER_RELAXED);
+	}
+
+	return static_cast<longlong>(static_cast<ptrdiff_t>(sum));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Zero all the slots. Updates made at the same time may be lost.
+
+void ShardedSlots::reset()
+{
+	for (Shard* shard = m_shards.first<Shard>(); shard != nullptr; shard = ThreadRecords::next(shard))
+	{
+		size_t* slots = atomicLoad(shard->m_slots, MEMORY_ORDER_ACQUIRE);
+
+		if (slots != nullptr)
+		{
+			for (size_t slot = 0; slot != m_slots; ++slot)
+				atomicStore(slots[slot], size_t(0), MEMORY_ORDER_RELAXED);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the slots for the calling thread, creating them the first time. The
+//! storage is rounded up to whole cache lines so that it doesn't share a line
+//! with another thread's data.
+
+size_t* ShardedSlots::threadSlots()
+{
+	Shard* shard = m_shards.threadRecord<Shard>();
+
+	if (shard->m_slots == nullptr)
+	{
+		const size_t lines = (m_slots + SLOTS_PER_LINE - 1) / SLOTS_PER_LINE;
+
+		AlignedArray<size_t> storage(lines * SLOTS_PER_LINE, CACHE_LINE_SIZE);
+
+		shard->m_storage.swap(storage);
+		atomicStore(shard->m_slots, shard->m_storage.get(), MEMORY_ORDER_RELEASE);
+	}
+
+	return shard->m_slots;
+}
+
+//namespace Core
+}
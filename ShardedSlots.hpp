@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ShardedSlots.hpp
+//! \brief  The ShardedSlots class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_SHARDEDSLOTS_HPP
+#define CORE_SHARDEDSLOTS_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "ThreadRecords.hpp"
+#include "Atomic.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The storage for statistics that are updated from many threads, such as the
+//! ShardedCounter, ShardedGauge and ShardedHistogram classes.
+//!
+//! There is a fixed number of slots, and each thread that updates them has its
+//! own shard of them on its own cache lines. As no other thread writes to a
+//! shard, an update is a plain load and store, with no locked instruction. A
+//! slot's value is the sum of that slot in every shard. The shard of a thread
+//! that has exited is taken over by the next new thread, so its updates are
+//! kept.
+//!
+//! The shards hold native-width words so that they can be read without a lock
+//! on 32-bit platforms too. The sums wrap around at the word size, so on a
+//! 32-bit platform a sum is only exact while it fits in 32 bits.
+
+class ShardedSlots /*: private NotCopyable*/
+{
+public:
+	//! Construction with the number of slots.
+	explicit ShardedSlots(size_t slots);
+
+	//
+	// Properties.
+	//
+
+	//! Get the number of slots.
+	size_t slots() const;
+
+	//! Get the number of shards.
+	size_t shards() const;
+
+	//
+	// Methods.
+	//
+
+	//! Add to a slot in the calling thread's shard.
+	void add(size_t slot, longlong amount);
+
+	//! Get the sum of a slot over all the shards.
+	longlong sum(size_t slot) const;
+
+	//! Zero all the slots.
+	void reset();
+
+private:
+	//! The slots of a thread.
+	struct Shard;
+
+	//
+	// Members.
+	//
+	size_t			m_slots;	//!< The number of slots.
+	ThreadRecords	m_shards;	//!< The shards of the threads.
+
+	//
+	// Internal methods.
+	//
+
+	//! Get the slots for the calling thread, creating them if required.
+	size_t* threadSlots();
+
+	// NotCopyable.
+	ShardedSlots(const ShardedSlots&);
+	ShardedSlots& operator=(const ShardedSlots&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of slots.
+
+inline size_t ShardedSlots::slots() const
+{
+	return m_slots;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of shards, which is the number of threads that have updated
+//! the slots at the same time.
+
+inline size_t ShardedSlots::shards() const
+{
+	return m_shards.count();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Add to a slot in the calling thread's shard. Only the calling thread writes
+//! to its shard, apart from reset(), so the addition doesn't need to be atomic;
+//! the load and store are only atomic so that other threads can read the slot.
+
+inline void ShardedSlots::add(size_t slot, longlong amount)
+{
+	ASSERT(slot < m_slots);
+
+	size_t& value = threadSlots()[slot];
+
+	atomicStore(value, atomicLoad(value, MEMORY_ORDER_RELAXED) + static_cast<size_t>(amount), MEMORY_ORDER_RELAXED);
+}
+
+//namespace Core
+}
+
+#endif // CORE_SHARDEDSLOTS_HPP
@@ -0,0 +1,466 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   SharedCount.hpp
+//! \brief  The SharedCount class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_SHAREDCOUNT_HPP
+#define CORE_SHAREDCOUNT_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "CountingPolicy.hpp"
+#include <new>
+#ifdef CORE_SMALL_OBJECT_ALLOCATOR
+#include "SmallObjectAllocator.hpp"
+#endif
+
+// The debug CRT version of 'new' doesn't support placement new.
+#ifdef _MSC_VER
+#pragma push_macro("new")
+#undef new
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The control block used by a SharedPtr. It holds the reference count and
+//! knows how to destroy the object being shared, which means the object is
+//! always destroyed as the type it was created with, whatever type of
+//! SharedPtr holds the last reference.
+//!
+//! There is a separate weak count for the WeakPtrs that observe the object.
+//! The object is destroyed when the last strong reference is released but the
+//! control block lives on until the last weak reference is released too. All
+//! the strong references together hold a single weak reference.
+//!
+//! The counting policy determines whether the counts are thread-safe, see
+//! AtomicCount and LocalCount.
+
+template <typename C = AtomicCount>
+class SharedCount : private C /*, private NotCopyable*/
+{
+public:
+	//! Default constructor. The counts start at one.
+	SharedCount();
+
+	//! Destructor.
+	virtual ~SharedCount();
+
+	//
+	// Properties.
+	//
+
+	//! Get the current reference count.
+	long count() const;
+
+	//! Get the current weak reference count.
+	long weakCount() const;
+
+	//! Query if the object has been destroyed.
+	bool expired() const;
+
+	//
+	// Methods.
+	//
+
+	//! Add a reference.
+	void addRef();
+
+	//! Release a reference, destroying the object when it's the last one.
+	void release();
+
+	//! Add a reference, unless the object has already been destroyed.
+	bool tryAddRef();
+
+	//! Add a weak reference.
+	void addWeakRef();
+
+	//! Release a weak reference.
+	void releaseWeak();
+
+#ifdef CORE_SMALL_OBJECT_ALLOCATOR
+	//
+	// Class methods.
+	//
+
+	//! Allocate a control block from the shared small object allocator.
+	static void* operator new(size_t size);
+
+	//! Return a control block to the shared small object allocator.
+	static void operator delete(void* block, size_t size);
+#endif
+
+protected:
+	//
+	// Internal methods.
+	//
+
+	//! Destroy the object being shared.
+	virtual void dispose() = 0;
+
+private:
+	//
+	// Members.
+	//
+	long	m_count;		//!< The reference count.
+	long	m_weakCount;	//!< The weak reference count.
+
+	// NotCopyable.
+	SharedCount(const SharedCount&);
+	SharedCount& operator=(const SharedCount&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor. The counts start at one.
+
+template <typename C>
+inline SharedCount<C>::SharedCount()
+	: m_count(1)
+	, m_weakCount(1)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+template <typename C>
+inline SharedCount<C>::~SharedCount()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the current reference count. The value may be stale by the time it's
+//! used if other threads hold references.
+
+template <typename C>
+inline long SharedCount<C>::count() const
+{
+	return this->load(m_count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the current weak reference count. This includes the one held on behalf
+//! of the strong references.
+
+template <typename C>
+inline long SharedCount<C>::weakCount() const
+{
+	return this->load(m_weakCount);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the object has been destroyed. Once expired a control block can
+//! never be revived.
+
+template <typename C>
+inline bool SharedCount<C>::expired() const
+{
+	return (this->load(m_count) == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Add a reference.
+
+template <typename C>
+inline void SharedCount<C>::addRef()
+{
+	this->increment(m_count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Release a reference. When the last reference is released the object is
+//! destroyed, along with the control block if there are no weak references.
+
+template <typename C>
+inline void SharedCount<C>::release()
+{
+	if (this->decrement(m_count) == 0)
+	{
+		dispose();
+		releaseWeak();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Add a reference, unless the object has already been destroyed. The count
+//! is only incremented if it's not zero, so a WeakPtr can never resurrect an
+//! object that is being destroyed. Returns true if a reference was added.
+
+template <typename C>
+inline bool SharedCount<C>::tryAddRef()
+{
+	long count = this->load(m_count);
+
+	while (count != 0)
+	{
+		const long previous = this->compareExchange(m_count, count+1, count);
+
+		if (previous == count)
+			return true;
+
+		count = previous;
+	}
+
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Add a weak reference.
+
+template <typename C>
+inline void SharedCount<C>::addWeakRef()
+{
+	this->increment(m_weakCount);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Release a weak reference. When the last one is released the control block
+//! is destroyed.
+
+template <typename C>
+inline void SharedCount<C>::releaseWeak()
+{
+	if (this->decrement(m_weakCount) == 0)
+		delete this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The control block for an object that was allocated separately, such as one
+//! passed to the SharedPtr constructor.
+
+template <typename T, typename C = AtomicCount>
+class SharedCountPtr : public SharedCount<C>
+{
+public:
+	//! Construction from the pointer to own.
+	explicit SharedCountPtr(T* ptr);
+
+protected:
+	//
+	// SharedCount methods.
+	//
+
+	//! Destroy the object being shared.
+	virtual void dispose();
+
+private:
+	//
+	// Members.
+	//
+	T*	m_ptr;		//!< The object being shared.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from the pointer to own.
+
+template <typename T, typename C>
+inline SharedCountPtr<T, C>::SharedCountPtr(T* ptr)
+	: m_ptr(ptr)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy the object being shared.
+
+template <typename T, typename C>
+inline void SharedCountPtr<T, C>::dispose()
+{
+	delete m_ptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The control block for an object that is allocated along with it, as done
+//! by makeShared(). The object is constructed in place in the block, so the
+//! count and the object share a single allocation and, usually, a cache line.
+//! The storage is aligned for any of the fundamental types; over-aligned types
+//! are not supported. Note that the memory for the object is only freed once
+//! any WeakPtrs have also been released.
+
+template <typename T, typename C = AtomicCount>
+class SharedCountObj : public SharedCount<C>
+{
+public:
+	//! Construct the object using its default constructor.
+	SharedCountObj();
+
+	//! Construct the object from one argument.
+	template <typename A1>
+	explicit SharedCountObj(const A1& a1);
+
+	//! Construct the object from two arguments.
+	template <typename A1, typename A2>
+	SharedCountObj(const A1& a1, const A2& a2);
+
+	//! Construct the object from three arguments.
+	template <typename A1, typename A2, typename A3>
+	SharedCountObj(const A1& a1, const A2& a2, const A3& a3);
+
+	//! Construct the object from four arguments.
+	template <typename A1, typename A2, typename A3, typename A4>
+	SharedCountObj(const A1& a1, const A2& a2, const A3& a3, const A4& a4);
+
+	//! Construct the object from five arguments.
+	template <typename A1, typename A2, typename A3, typename A4, typename A5>
+	SharedCountObj(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5);
+
+	//
+	// Properties.
+	//
+
+	//! Get the object being shared.
+	T* get();
+
+protected:
+	//
+	// SharedCount methods.
+	//
+
+	//! Destroy the object being shared.
+	virtual void dispose();
+
+private:
+	//! The storage for the object, aligned for the fundamental types.
+	union Storage
+	{
+		char		m_bytes[sizeof(T)];
+		double		m_double;
+		long double	m_longDouble;
+		long		m_long;
+		void*		m_pointer;
+	};
+
+	//
+	// Members.
+	//
+	Storage	m_storage;		//!< The storage for the object.
+
+	//
+	// Internal methods.
+	//
+
+	//! Get the raw storage for the object.
+	void* storage();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construct the object using its default constructor.
+
+template <typename T, typename C>
+inline SharedCountObj<T, C>::SharedCountObj()
+{
+	::new(storage()) T();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construct the object from one argument.
+
+template <typename T, typename C>
+template <typename A1>
+inline SharedCountObj<T, C>::SharedCountObj(const A1& a1)
+{
+	::new(storage()) T(a1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construct the object from two arguments.
+
+template <typename T, typename C>
+template <typename A1, typename A2>
+inline SharedCountObj<T, C>::SharedCountObj(const A1& a1, const A2& a2)
+{
+	::new(storage()) T(a1, a2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construct the object from three arguments.
+
+template <typename T, typename C>
+template <typename A1, typename A2, typename A3>
+inline SharedCountObj<T, C>::SharedCountObj(const A1& a1, const A2& a2, const A3& a3)
+{
+	::new(storage()) T(a1, a2, a3);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construct the object from four arguments.
+
+template <typename T, typename C>
+template <typename A1, typename A2, typename A3, typename A4>
+inline SharedCountObj<T, C>::SharedCountObj(const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+{
+	::new(storage()) T(a1, a2, a3, a4);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construct the object from five arguments.
+
+template <typename T, typename C>
+template <typename A1, typename A2, typename A3, typename A4, typename A5>
+inline SharedCountObj<T, C>::SharedCountObj(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+{
+	::new(storage()) T(a1, a2, a3, a4, a5);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the object being shared.
+
+template <typename T, typename C>
+inline T* SharedCountObj<T, C>::get()
+{
+	return static_cast<T*>(storage());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destroy the object being shared. The storage is released along with the
+//! control block.
+
+template <typename T, typename C>
+inline void SharedCountObj<T, C>::dispose()
+{
+	get()->~T();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the raw storage for the object.
+
+template <typename T, typename C>
+inline void* SharedCountObj<T, C>::storage()
+{
+	return m_storage.m_bytes;
+}
+
+#ifdef CORE_SMALL_OBJECT_ALLOCATOR
+
+////////////////////////////////////////////////////////////////////////////////
+//! Allocate a control block from the shared small object allocator.
+
+template <typename C>
+inline void* SharedCount<C>::operator new(size_t size)
+{
+	return SmallObjectAllocator::instance().allocate(size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Return a control block to the shared small object allocator. The destructor
+//! is virtual and so the size is that of the most derived type.
+
+template <typename C>
+inline void SharedCount<C>::operator delete(void* block, size_t size)
+{
+	SmallObjectAllocator::instance().deallocate(block, size);
+}
+
+#endif // CORE_SMALL_OBJECT_ALLOCATOR
+
+//namespace Core
+}
+
+#ifdef _MSC_VER
+#pragma pop_macro("new")
+#endif
+
+#endif // CORE_SHAREDCOUNT_HPP
@@ -11,16 +11,33 @@
 #pragma once
 #endif
 
-#include "Interlocked.hpp"
+#include "SharedCount.hpp"
 #include "SmartPtr.hpp"
 
+// The debug CRT version of 'new' would hide the control block's operator new.
+#if defined(_MSC_VER) && defined(CORE_SMALL_OBJECT_ALLOCATOR)
+#pragma push_macro("new")
+#undef new
+#endif
+
 namespace Core
 {
 
-////////////////////////////////////////////////////////////////////////////////
-//! A reference counted smart pointer.
+// Forward declarations.
+template <typename T, typename C>
+class WeakPtr;
 
-template <typename T>
+////////////////////////////////////////////////////////////////////////////////
+//! A reference counted smart pointer. The reference count lives in a separate
+//! control block, unless the object was created with makeShared(), in which
+//! case the object and the count share a single allocation.
+//!
+//! The counting policy determines whether the pointer can be shared between
+//! threads. The default, AtomicCount, uses atomic operations. LocalCount uses
+//! plain arithmetic and is for objects that are confined to a single thread,
+//! see makeLocalShared().
+
+template <typename T, typename C = AtomicCount>
 class SharedPtr : public SmartPtr<T>
 {
 public:
@@ -30,12 +47,24 @@ public:
 	//! Construction from a raw pointer.
 	explicit SharedPtr(T* ptr);
 
+	//! Construction from a new control block that holds the object.
+	explicit SharedPtr(SharedCountObj<T, C>& refCount);
+
 	//! Copy constructor.
-	SharedPtr(const SharedPtr<T>& sharedPtr);
+	SharedPtr(const SharedPtr& sharedPtr);
 
 	//! Copy constructor for sub-types of T.
 	template <typename U>
-	SharedPtr(const SharedPtr<U>& sharedPtr);
+	SharedPtr(const SharedPtr<U, C>& sharedPtr);
+
+#ifdef CORE_HAS_RVALUE_REFS
+	//! Move constructor.
+	SharedPtr(SharedPtr&& sharedPtr) CORE_NOEXCEPT;
+
+	//! Move constructor for sub-types of T.
+	template <typename U>
+	SharedPtr(SharedPtr<U, C>&& sharedPtr) CORE_NOEXCEPT;
+#endif
 
 	//! Destructor.
 	~SharedPtr();
@@ -49,7 +78,16 @@ public:
 
 	//! Assignment operator for sub-types of T.
 	template <typename U>
-	SharedPtr& operator=(const SharedPtr<U>& sharedPtr);
+	SharedPtr& operator=(const SharedPtr<U, C>& sharedPtr);
+
+#ifdef CORE_HAS_RVALUE_REFS
+	//! Move assignment operator.
+	SharedPtr& operator=(SharedPtr&& sharedPtr) CORE_NOEXCEPT;
+
+	//! Move assignment operator for sub-types of T.
+	template <typename U>
+	SharedPtr& operator=(SharedPtr<U, C>&& sharedPtr) CORE_NOEXCEPT;
+#endif
 
 	//
 	// Methods.
@@ -62,33 +100,37 @@ private:
 	//
 	// Members.
 	//
-	long*	m_refCount;		//!< The pointer reference count.
+	SharedCount<C>*	m_refCount;		//!< The pointer reference count.
 
 	//! Private constructor for use by cast functions.
-	SharedPtr(T* ptr, long* refCount);
+	SharedPtr(T* ptr, SharedCount<C>* refCount);
 
 	//
 	// Friends.
 	//
 
 	//! Allow member access for SharedPtrs of sub-types.
-	template<typename U>
+	template<typename U, typename D>
 	friend class SharedPtr;
 
+	//! Allow member access for WeakPtrs.
+	template<typename U, typename D>
+	friend class WeakPtr;
+
 	//! Allow member access for the static_cast like function.
-	template<typename P, typename U>
-	friend SharedPtr<P> static_ptr_cast(const SharedPtr<U>& sharedPtr);
+	template<typename P, typename U, typename D>
+	friend SharedPtr<P, D> static_ptr_cast(const SharedPtr<U, D>& sharedPtr);
 
 	//! Allow member access for the dynamic_cast like function.
-	template<typename P, typename U>
-	friend SharedPtr<P> dynamic_ptr_cast(const SharedPtr<U>& sharedPtr);
+	template<typename P, typename U, typename D>
+	friend SharedPtr<P, D> dynamic_ptr_cast(const SharedPtr<U, D>& sharedPtr);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 //! Default constructor. Sets pointer and reference count to NULL.
 
-template <typename T>
-inline SharedPtr<T>::SharedPtr()
+template <typename T, typename C>
+inline SharedPtr<T, C>::SharedPtr()
 	: m_refCount(nullptr)
 {
 }
@@ -96,8 +138,8 @@ inline SharedPtr<T>::SharedPtr()
 ////////////////////////////////////////////////////////////////////////////////
 //! Construction from a raw pointer. Takes ownership of a new pointer.
 
-template <typename T>
-inline SharedPtr<T>::SharedPtr(T* ptr)
+template <typename T, typename C>
+inline SharedPtr<T, C>::SharedPtr(T* ptr)
 	: m_refCount(nullptr)
 {
 	reset(ptr);
@@ -106,34 +148,65 @@ inline SharedPtr<T>::SharedPtr(T* ptr)
 ////////////////////////////////////////////////////////////////////////////////
 //! Copy constructor. Takes shared ownership of another pointer.
 
-template<typename T>
-inline SharedPtr<T>::SharedPtr(const SharedPtr<T>& sharedPtr)
+template <typename T, typename C>
+inline SharedPtr<T, C>::SharedPtr(const SharedPtr& sharedPtr)
 	: SmartPtr<T>(sharedPtr.m_ptr)
 	, m_refCount(sharedPtr.m_refCount)
 {
 	if (m_refCount != nullptr)
-		Core::atomicIncrement(*m_refCount);
+		m_refCount->addRef();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //! Copy constructor for sub-types of T. Takes shared ownership of another
 //! pointer that must be a sub-type of T or be "more" const than T.
 
-template <typename T>
+template <typename T, typename C>
 template <typename U>
-inline SharedPtr<T>::SharedPtr(const SharedPtr<U>& sharedPtr)
+inline SharedPtr<T, C>::SharedPtr(const SharedPtr<U, C>& sharedPtr)
 	: SmartPtr<T>(sharedPtr.m_ptr)
 	, m_refCount(sharedPtr.m_refCount)
 {
 	if (m_refCount != nullptr)
-		Core::atomicIncrement(*m_refCount);
+		m_refCount->addRef();
+}
+
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move constructor. Takes over ownership from another pointer, which is left
+//! empty, without changing the reference count.
+
+template <typename T, typename C>
+inline SharedPtr<T, C>::SharedPtr(SharedPtr&& sharedPtr) CORE_NOEXCEPT
+	: SmartPtr<T>(sharedPtr.m_ptr)
+	, m_refCount(sharedPtr.m_refCount)
+{
+	sharedPtr.m_ptr = nullptr;
+	sharedPtr.m_refCount = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move constructor for sub-types of T. Takes over ownership from another
+//! pointer, which is left empty, without changing the reference count.
+
+template <typename T, typename C>
+template <typename U>
+inline SharedPtr<T, C>::SharedPtr(SharedPtr<U, C>&& sharedPtr) CORE_NOEXCEPT
+	: SmartPtr<T>(sharedPtr.m_ptr)
+	, m_refCount(sharedPtr.m_refCount)
+{
+	sharedPtr.m_ptr = nullptr;
+	sharedPtr.m_refCount = nullptr;
 }
 
+#endif // CORE_HAS_RVALUE_REFS
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Destructor. Frees the pointer if the last reference.
 
-template <typename T>
-inline SharedPtr<T>::~SharedPtr()
+template <typename T, typename C>
+inline SharedPtr<T, C>::~SharedPtr()
 {
 	reset(nullptr);
 }
@@ -142,25 +215,22 @@ inline SharedPtr<T>::~SharedPtr()
 //! Assignment operator. Frees the current pointer if the last reference and
 //! takes shared ownership of another pointer.
 
-template <typename T>
-inline SharedPtr<T>& SharedPtr<T>::operator=(const SharedPtr& sharedPtr)
+template <typename T, typename C>
+inline SharedPtr<T, C>& SharedPtr<T, C>::operator=(const SharedPtr& sharedPtr)
 {
 	// Ignore self-assignment.
 	if (this->m_ptr != sharedPtr.m_ptr)
 	{
-		// Final reference?
-		if ((m_refCount != nullptr) && (Core::atomicDecrement(*m_refCount) == 0))
-		{
-			delete this->m_ptr;
-			delete this->m_refCount;
-		}
+		// Release our reference.
+		if (m_refCount != nullptr)
+			m_refCount->release();
 
 		this->m_ptr = sharedPtr.m_ptr;
 		this->m_refCount = sharedPtr.m_refCount;
 
 		// Share ownership.
 		if (m_refCount != nullptr)
-			Core::atomicIncrement(*m_refCount);
+			m_refCount->addRef();
 	}
 
 	return *this;
@@ -171,54 +241,111 @@ inline SharedPtr<T>& SharedPtr<T>::operator=(const SharedPtr& sharedPtr)
 //! last reference and takes shared ownership of another pointer that must be a
 //! sub-type of T.
 
-template <typename T>
+template <typename T, typename C>
 template <typename U>
-inline SharedPtr<T>& SharedPtr<T>::operator=(const SharedPtr<U>& sharedPtr)
+inline SharedPtr<T, C>& SharedPtr<T, C>::operator=(const SharedPtr<U, C>& sharedPtr)
 {
 	// Ignore self-assignment.
 	if (this->m_ptr != sharedPtr.m_ptr)
 	{
-		// Final reference?
-		if ((m_refCount != nullptr) && (Core::atomicDecrement(*m_refCount) == 0))
-		{
-			delete this->m_ptr;
-			delete this->m_refCount;
-		}
+		// Release our reference.
+		if (m_refCount != nullptr)
+			m_refCount->release();
 
 		this->m_ptr = sharedPtr.m_ptr;
 		this->m_refCount = sharedPtr.m_refCount;
 
 		// Share ownership.
 		if (m_refCount != nullptr)
-			Core::atomicIncrement(*m_refCount);
+			m_refCount->addRef();
+	}
+
+	return *this;
+}
+
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move assignment operator. Frees the current pointer if the last reference
+//! and takes over ownership from another pointer, which is left empty.
+
+template <typename T, typename C>
+inline SharedPtr<T, C>& SharedPtr<T, C>::operator=(SharedPtr&& sharedPtr) CORE_NOEXCEPT
+{
+	// Ignore self-assignment.
+	if (this != &sharedPtr)
+	{
+		SharedCount<C>* oldCnt = m_refCount;
+
+		this->m_ptr = sharedPtr.m_ptr;
+		this->m_refCount = sharedPtr.m_refCount;
+
+		sharedPtr.m_ptr = nullptr;
+		sharedPtr.m_refCount = nullptr;
+
+		// Release our reference last as it may own the source.
+		if (oldCnt != nullptr)
+			oldCnt->release();
 	}
 
 	return *this;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! Move assignment operator for sub-types of T. Frees the current pointer if
+//! the last reference and takes over ownership from another pointer, which is
+//! left empty.
+
+template <typename T, typename C>
+template <typename U>
+inline SharedPtr<T, C>& SharedPtr<T, C>::operator=(SharedPtr<U, C>&& sharedPtr) CORE_NOEXCEPT
+{
+	SharedCount<C>* oldCnt = m_refCount;
+
+	this->m_ptr = sharedPtr.m_ptr;
+	this->m_refCount = sharedPtr.m_refCount;
+
+	sharedPtr.m_ptr = nullptr;
+	sharedPtr.m_refCount = nullptr;
+
+	// Release our reference last as it may own the source.
+	if (oldCnt != nullptr)
+		oldCnt->release();
+
+	return *this;
+}
+
+#endif // CORE_HAS_RVALUE_REFS
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Change pointer ownership. Frees the current pointer if the last reference
 //! and takes shared ownership of another pointer, if provided.
 
-template <typename T>
-inline void SharedPtr<T>::reset(T* ptr)
+template <typename T, typename C>
+inline void SharedPtr<T, C>::reset(T* ptr)
 {
-	T*    tmpPtr = nullptr;
-	long* tmpCnt = nullptr;
+	T*              tmpPtr = nullptr;
+	SharedCount<C>* tmpCnt = nullptr;
 
 	// Allocate new resources up front.
 	if (ptr != nullptr)
 	{
+		try
+		{
+			tmpCnt = new SharedCountPtr<T, C>(ptr);
+		}
+		catch (...)
+		{
+			delete ptr;
+			throw;
+		}
+
 		tmpPtr = ptr;
-		tmpCnt = new long(1);
 	}
 
 	// Release current resources, if final reference.
-	if ((m_refCount != nullptr) && (Core::atomicDecrement(*m_refCount) == 0))
-	{
-		delete this->m_ptr;
-		delete this->m_refCount;
-	}
+	if (m_refCount != nullptr)
+		m_refCount->release();
 
 	// Update state.
 	this->m_ptr = tmpPtr;
@@ -228,42 +355,178 @@ inline void SharedPtr<T>::reset(T* ptr)
 ////////////////////////////////////////////////////////////////////////////////
 //! Private constructor for use by cast functions.
 
-template <typename T>
-inline SharedPtr<T>::SharedPtr(T* ptr, long* refCount)
+template <typename T, typename C>
+inline SharedPtr<T, C>::SharedPtr(T* ptr, SharedCount<C>* refCount)
 	: SmartPtr<T>(ptr)
 	, m_refCount(refCount)
 {
 	if (m_refCount != nullptr)
-		Core::atomicIncrement(*m_refCount);
+		m_refCount->addRef();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a new control block that holds the object, which is how
+//! makeShared() creates an object. Takes ownership of the initial reference.
+
+template <typename T, typename C>
+inline SharedPtr<T, C>::SharedPtr(SharedCountObj<T, C>& refCount)
+	: SmartPtr<T>(refCount.get())
+	, m_refCount(&refCount)
+{
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //! A variant of static_cast<> that can be used to create a SharedPtr of the
 //! derived ptr type from the base ptr type.
 
-template<typename P, typename U>
-inline SharedPtr<P> static_ptr_cast(const SharedPtr<U>& sharedPtr)
+template<typename P, typename U, typename C>
+inline SharedPtr<P, C> static_ptr_cast(const SharedPtr<U, C>& sharedPtr)
 {
-	return SharedPtr<P>(static_cast<P*>(sharedPtr.m_ptr), sharedPtr.m_refCount);
+	return SharedPtr<P, C>(static_cast<P*>(sharedPtr.m_ptr), sharedPtr.m_refCount);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //! A variant of dynamic_cast<> that can be used to create a SharedPtr of the
 //! derived ptr type from the base ptr type.
 
-template<typename P, typename U>
-inline SharedPtr<P> dynamic_ptr_cast(const SharedPtr<U>& sharedPtr)
+template<typename P, typename U, typename C>
+inline SharedPtr<P, C> dynamic_ptr_cast(const SharedPtr<U, C>& sharedPtr)
 {
-	P*    tmpPtr = dynamic_cast<P*>(sharedPtr.m_ptr);
-	long* tmpCnt = sharedPtr.m_refCount;
+	P*              tmpPtr = dynamic_cast<P*>(sharedPtr.m_ptr);
+	SharedCount<C>* tmpCnt = sharedPtr.m_refCount;
 
 	if (tmpPtr == nullptr)
 		tmpCnt = nullptr;
 
-	return SharedPtr<P>(tmpPtr, tmpCnt);
+	return SharedPtr<P, C>(tmpPtr, tmpCnt);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a new object using its default constructor. The object and its
+//! reference count are created with a single allocation.
+
+template<typename T>
+inline SharedPtr<T> makeShared()
+{
+	return SharedPtr<T>(*new SharedCountObj<T>());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a new object from one argument. The object and its reference count
+//! are created with a single allocation.
+
+template<typename T, typename A1>
+inline SharedPtr<T> makeShared(const A1& a1)
+{
+	return SharedPtr<T>(*new SharedCountObj<T>(a1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a new object from two arguments. The object and its reference count
+//! are created with a single allocation.
+
+template<typename T, typename A1, typename A2>
+inline SharedPtr<T> makeShared(const A1& a1, const A2& a2)
+{
+	return SharedPtr<T>(*new SharedCountObj<T>(a1, a2));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a new object from three arguments. The object and its reference count
+//! are created with a single allocation.
+
+template<typename T, typename A1, typename A2, typename A3>
+inline SharedPtr<T> makeShared(const A1& a1, const A2& a2, const A3& a3)
+{
+	return SharedPtr<T>(*new SharedCountObj<T>(a1, a2, a3));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a new object from four arguments. The object and its reference count
+//! are created with a single allocation.
+
+template<typename T, typename A1, typename A2, typename A3, typename A4>
+inline SharedPtr<T> makeShared(const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+{
+	return SharedPtr<T>(*new SharedCountObj<T>(a1, a2, a3, a4));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a new object from five arguments. The object and its reference count
+//! are created with a single allocation.
+
+template<typename T, typename A1, typename A2, typename A3, typename A4, typename A5>
+inline SharedPtr<T> makeShared(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+{
+	return SharedPtr<T>(*new SharedCountObj<T>(a1, a2, a3, a4, a5));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a new thread-confined object using its default constructor. The
+//! object and its reference count are created with a single allocation. The
+//! object must only be shared within the calling thread.
+
+template<typename T>
+inline SharedPtr<T, LocalCount> makeLocalShared()
+{
+	return SharedPtr<T, LocalCount>(*new SharedCountObj<T, LocalCount>());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a new thread-confined object from one argument. The object and its
+//! reference count are created with a single allocation.
+
+template<typename T, typename A1>
+inline SharedPtr<T, LocalCount> makeLocalShared(const A1& a1)
+{
+	return SharedPtr<T, LocalCount>(*new SharedCountObj<T, LocalCount>(a1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a new thread-confined object from two arguments. The object and its
+//! reference count are created with a single allocation.
+
+template<typename T, typename A1, typename A2>
+inline SharedPtr<T, LocalCount> makeLocalShared(const A1& a1, const A2& a2)
+{
+	return SharedPtr<T, LocalCount>(*new SharedCountObj<T, LocalCount>(a1, a2));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a new thread-confined object from three arguments. The object and its
+//! reference count are created with a single allocation.
+
+template<typename T, typename A1, typename A2, typename A3>
+inline SharedPtr<T, LocalCount> makeLocalShared(const A1& a1, const A2& a2, const A3& a3)
+{
+	return SharedPtr<T, LocalCount>(*new SharedCountObj<T, LocalCount>(a1, a2, a3));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a new thread-confined object from four arguments. The object and its
+//! reference count are created with a single allocation.
+
+template<typename T, typename A1, typename A2, typename A3, typename A4>
+inline SharedPtr<T, LocalCount> makeLocalShared(const A1& a1, const A2& a2, const A3& a3, const A4& a4)
+{
+	return SharedPtr<T, LocalCount>(*new SharedCountObj<T, LocalCount>(a1, a2, a3, a4));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a new thread-confined object from five arguments. The object and its
+//! reference count are created with a single allocation.
+
+template<typename T, typename A1, typename A2, typename A3, typename A4, typename A5>
+inline SharedPtr<T, LocalCount> makeLocalShared(const A1& a1, const A2& a2, const A3& a3, const A4& a4, const A5& a5)
+{
+	return SharedPtr<T, LocalCount>(*new SharedCountObj<T, LocalCount>(a1, a2, a3, a4, a5));
 }
 
 //namespace Core
 }
 
+#if defined(_MSC_VER) && defined(CORE_SMALL_OBJECT_ALLOCATOR)
+#pragma pop_macro("new")
+#endif
+
 #endif // CORE_SHAREDPTR_HPP
@@ -0,0 +1,167 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   SmallObjectAllocator.cpp
+//! \brief  The SmallObjectAllocator class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "SmallObjectAllocator.hpp"
+#include <new>
+
+// The debug CRT version of 'new' doesn't support calling the operator directly.
+#ifdef _MSC_VER
+#pragma push_macro("new")
+#undef new
+#endif
+
+namespace Core
+{
+
+namespace
+{
+
+//! The block sizes of the size classes.
+const size_t s_sizes[SmallObjectAllocator::SIZE_CLASSES] =
+{
+	16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Ensure the shared instance is constructed before, and destroyed after, any
+// static objects in client code that might allocate from it.
+
+#ifdef _MSC_VER
+#pragma warning(disable : 4073)
+#pragma init_seg(lib)
+#define CORE_INIT_PRIORITY
+#else
+#define CORE_INIT_PRIORITY	__attribute__((init_priority(101)))
+#endif
+
+//! The shared instance.
+SmallObjectAllocator s_instance CORE_INIT_PRIORITY;
+
+//namespace
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+SmallObjectAllocator::SmallObjectAllocator()
+{
+	for (size_t i = 0; i != SIZE_CLASSES; ++i)
+		m_pools[i] = nullptr;
+
+	try
+	{
+		for (size_t i = 0; i != SIZE_CLASSES; ++i)
+			m_pools[i] = new BlockPool(s_sizes[i]);
+	}
+	catch (...)
+	{
+		for (size_t i = 0; i != SIZE_CLASSES; ++i)
+			delete m_pools[i];
+
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. All the memory is freed, so no blocks can still be in use.
+
+SmallObjectAllocator::~SmallObjectAllocator()
+{
+	for (size_t i = 0; i != SIZE_CLASSES; ++i)
+		delete m_pools[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of bytes in blocks that are in use. This includes the space
+//! lost to rounding up to the size class, but not requests served by the heap.
+//! The value may be stale by the time it's used.
+
+size_t SmallObjectAllocator::bytesInUse() const
+{
+	size_t bytes = 0;
+
+	for (size_t i = 0; i != SIZE_CLASSES; ++i)
+		bytes += m_pools[i]->blocksInUse() * m_pools[i]->blockSize();
+
+	return bytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of bytes reserved for the size classes.
+
+size_t SmallObjectAllocator::bytesReserved() const
+{
+	size_t bytes = 0;
+
+	for (size_t i = 0; i != SIZE_CLASSES; ++i)
+		bytes += m_pools[i]->slabs() * BlockPool::SLAB_SIZE;
+
+	return bytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the pool for a size class, e.g. for its statistics.
+
+const BlockPool& SmallObjectAllocator::pool(size_t sizeClass) const
+{
+	ASSERT(sizeClass < SIZE_CLASSES);
+
+	return *m_pools[sizeClass];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Allocate a block of memory. Throws std::bad_alloc if the memory cannot be
+//! allocated.
+
+void* SmallObjectAllocator::allocate(size_t bytes)
+{
+	if (bytes > MAX_SIZE)
+		return ::operator new(bytes);
+
+	return m_pools[sizeClass(bytes)]->allocate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Free a block of memory. The size must be the one it was allocated with. The
+//! block can be null.
+
+void SmallObjectAllocator::deallocate(void* block, size_t bytes)
+{
+	if (bytes > MAX_SIZE)
+		::operator delete(block);
+	else
+		m_pools[sizeClass(bytes)]->deallocate(block);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the size class for a request, which must not be larger than MAX_SIZE.
+
+size_t SmallObjectAllocator::sizeClass(size_t bytes)
+{
+	ASSERT(bytes <= MAX_SIZE);
+
+	size_t sizeClass = 0;
+
+	while (s_sizes[sizeClass] < bytes)
+		++sizeClass;
+
+	return sizeClass;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the shared instance.
+
+SmallObjectAllocator& SmallObjectAllocator::instance()
+{
+	return s_instance;
+}
+
+//namespace Core
+}
+
+#ifdef _MSC_VER
+#pragma pop_macro("new")
+#endif
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   SmallObjectAllocator.hpp
+//! \brief  The SmallObjectAllocator class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_SMALLOBJECTALLOCATOR_HPP
+#define CORE_SMALLOBJECTALLOCATOR_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "BlockPool.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A general purpose allocator for small blocks of memory. Requests are
+//! rounded up to one of a fixed set of size classes, each of which is served
+//! by a BlockPool, so that allocating and freeing on the same thread uses the
+//! thread's own cache. Blocks freed by other threads are handed back to the
+//! owning thread in a batch. Requests larger than MAX_SIZE go to the heap.
+//!
+//! The size of a block must be passed when it is freed. The library's own
+//! small allocations, such as the SharedPtr control blocks, are routed through
+//! the shared instance when CORE_SMALL_OBJECT_ALLOCATOR is defined.
+
+class SmallObjectAllocator /*: private NotCopyable*/
+{
+public:
+	//! The number of size classes.
+	static const size_t SIZE_CLASSES = 12;
+
+	//! The largest size served by the size classes.
+	static const size_t MAX_SIZE = 1024;
+
+	//! Default constructor.
+	SmallObjectAllocator();
+
+	//! Destructor.
+	~SmallObjectAllocator();
+
+	//
+	// Properties.
+	//
+
+	//! Get the number of bytes in blocks that are in use.
+	size_t bytesInUse() const;
+
+	//! Get the number of bytes reserved for the size classes.
+	size_t bytesReserved() const;
+
+	//! Get the pool for a size class, e.g. for its statistics.
+	const BlockPool& pool(size_t sizeClass) const;
+
+	//
+	// Methods.
+	//
+
+	//! Allocate a block of memory.
+	void* allocate(size_t bytes);
+
+	//! Free a block of memory.
+	void deallocate(void* block, size_t bytes);
+
+	//
+	// Class methods.
+	//
+
+	//! Get the size class for a request.
+	static size_t sizeClass(size_t bytes);
+
+	//! Get the shared instance.
+	static SmallObjectAllocator& instance();
+
+private:
+	//
+	// Members.
+	//
+	BlockPool*	m_pools[SIZE_CLASSES];	//!< The pools for the size classes.
+
+	// NotCopyable.
+	SmallObjectAllocator(const SmallObjectAllocator&);
+	SmallObjectAllocator& operator=(const SmallObjectAllocator&);
+};
+
+//namespace Core
+}
+
+#endif // CORE_SMALLOBJECTALLOCATOR_HPP
@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   SpinMutex.hpp
+//! \brief  The SpinMutex class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_SPINMUTEX_HPP
+#define CORE_SPINMUTEX_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Mutex.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A Mutex that spins for a while before blocking, for locks that are held
+//! briefly. The number of spins adapts to how long the lock is usually held,
+//! up to a limit, after which the thread blocks in the kernel as before.
+
+class SpinMutex : public Mutex
+{
+public:
+	//! The default maximum number of times to spin before blocking.
+	static const uint DEFAULT_SPIN_LIMIT = 1000;
+
+	//! Construction with the maximum number of times to spin before blocking.
+	explicit SpinMutex(uint spinLimit = DEFAULT_SPIN_LIMIT);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the maximum number of times to spin before blocking.
+
+inline SpinMutex::SpinMutex(uint spinLimit)
+	: Mutex(spinLimit)
+{
+}
+
+//namespace Core
+}
+
+#endif // CORE_SPINMUTEX_HPP
@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   SpscByteRing.cpp
+//! \brief  The SpscByteRing class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "SpscByteRing.hpp"
+#include "InvalidArgException.hpp"
+#include <string.h>
+
+namespace Core
+{
+
+STATIC_ASSERT(sizeof(size_t) <= SpscByteRing::ALIGNMENT);
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the capacity in bytes, which must be a power of two no
+//! less than four times the record alignment.
+
+SpscByteRing::SpscByteRing(size_t capacity)
+	: m_buffer(capacity, AlignedArray<byte>::DEFAULT_ALIGNMENT, AlignedArray<byte>::UNINITIALISED)
+	, m_mask(capacity - 1)
+	, m_tail(0)
+	, m_reserved(0)
+	, m_cachedHead(0)
+	, m_head(0)
+	, m_next(0)
+	, m_cachedTail(0)
+{
+	if ( (capacity < (4 * ALIGNMENT)) || ((capacity & m_mask) != 0) )
+		throw InvalidArgException(TXT("The ring capacity must be a power of two of at least 32 bytes"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+SpscByteRing::~SpscByteRing()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Copy a record into the ring and publish it, unless the ring is full. The
+//! record must be no larger than maxRecordSize(). Returns false if the ring is
+//! full.
+
+bool SpscByteRing::tryWrite(const void* record, size_t bytes)
+{
+	void* buffer = tryReserve(bytes);
+
+	if (buffer == nullptr)
+		return false;
+
+	memcpy(buffer, record, bytes);
+	commit();
+
+	return true;
+}
+
+//namespace Core
+}
@@ -0,0 +1,246 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   SpscByteRing.hpp
+//! \brief  The SpscByteRing class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_SPSCBYTERING_HPP
+#define CORE_SPSCBYTERING_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Atomic.hpp"
+#include "AlignedArray.hpp"
+#include "CacheLine.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A bounded, wait-free stream of variable-length records passed from exactly
+//! one producer thread to exactly one consumer thread, e.g. lines read from a
+//! file and handed to a parser.
+//!
+//! Each record is written in place after a small length header. A record that
+//! doesn't fit before the end of the buffer is preceded by a marker that tells
+//! the consumer to skip to the start, so records are always contiguous. The
+//! indices are managed in the same way as SpscRing.
+//!
+//! The producer reserves space for one or more records and then commits them
+//! all in one go. The consumer peeks at the next record in place and then
+//! releases it. The producer methods must only be called by the producer
+//! thread, and the consumer methods only by the consumer thread.
+
+class SpscByteRing /*: private NotCopyable*/
+{
+public:
+	//! The alignment of the records.
+	static const size_t ALIGNMENT = 8;
+
+	//! Construction with the capacity in bytes, which must be a power of two.
+	explicit SpscByteRing(size_t capacity);
+
+	//! Destructor.
+	~SpscByteRing();
+
+	//
+	// Properties.
+	//
+
+	//! Get the size of the buffer.
+	size_t capacity() const;
+
+	//! Get the size of the largest record that can be written.
+	size_t maxRecordSize() const;
+
+	//! Query if the ring is empty.
+	bool empty() const;
+
+	//
+	// Producer methods.
+	//
+
+	//! Reserve space for a record, unless the ring is full.
+	void* tryReserve(size_t bytes);
+
+	//! Publish the records reserved since the last commit.
+	void commit();
+
+	//! Copy a record into the ring and publish it, unless the ring is full.
+	bool tryWrite(const void* record, size_t bytes);
+
+	//
+	// Consumer methods.
+	//
+
+	//! Get the next record, unless the ring is empty.
+	const void* tryPeek(size_t& bytes);
+
+	//! Release the record returned by the last peek.
+	void release();
+
+private:
+	//! The length header stored in place of a record to skip to the start.
+	static const size_t WRAP = static_cast<size_t>(-1);
+
+	//
+	// Members.
+	//
+	AlignedArray<byte>	m_buffer;		//!< The ring buffer.
+	size_t				m_mask;			//!< The mask to map an index to an offset.
+	CachePadding<>		m_padding1;		//!< Keep the producer off the read-only members.
+	size_t				m_tail;			//!< The index after the last committed record.
+	size_t				m_reserved;		//!< The index after the last reserved record.
+	size_t				m_cachedHead;	//!< The producer's copy of the head.
+	CachePadding<>		m_padding2;		//!< Keep the consumer off the producer.
+	size_t				m_head;			//!< The index of the next record to read.
+	size_t				m_next;			//!< The index after the peeked record.
+	size_t				m_cachedTail;	//!< The consumer's copy of the tail.
+	CachePadding<>		m_padding3;		//!< Keep the consumer off whatever follows.
+
+	//
+	// Internal methods.
+	//
+
+	//! Get the length header at an index.
+	size_t& header(size_t index);
+
+	//! Get the space taken by a record, including its header and padding.
+	static size_t recordSize(size_t bytes);
+
+	// NotCopyable.
+	SpscByteRing(const SpscByteRing&);
+	SpscByteRing& operator=(const SpscByteRing&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the size of the buffer.
+
+inline size_t SpscByteRing::capacity() const
+{
+	return m_mask + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the size of the largest record that can be written. A record can take
+//! no more than half the buffer, so that it always fits once the consumer has
+//! caught up, even when it has to skip to the start.
+
+inline size_t SpscByteRing::maxRecordSize() const
+{
+	return (capacity() / 2) - ALIGNMENT;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the ring is empty. The value may be stale by the time it's used.
+
+inline bool SpscByteRing::empty() const
+{
+	const size_t head = atomicLoad(m_head, MEMORY_ORDER_ACQUIRE);
+	const size_t tail = atomicLoad(m_tail, MEMORY_ORDER_ACQUIRE);
+
+	return (head == tail);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Reserve space for a record, which must be no larger than maxRecordSize().
+//! The record is not visible to the consumer until it's committed. Returns
+//! null if the ring is full.
+
+inline void* SpscByteRing::tryReserve(size_t bytes)
+{
+	ASSERT(bytes <= maxRecordSize());
+
+	const size_t size = recordSize(bytes);
+	const size_t toEnd = capacity() - (m_reserved & m_mask);
+	const size_t needed = (size <= toEnd) ? size : (toEnd + size);
+
+	if ((capacity() - (m_reserved - m_cachedHead)) < needed)
+	{
+		m_cachedHead = atomicLoad(m_head, MEMORY_ORDER_ACQUIRE);
+
+		if ((capacity() - (m_reserved - m_cachedHead)) < needed)
+			return nullptr;
+	}
+
+	if (size > toEnd)
+	{
+		header(m_reserved) = WRAP;
+		m_reserved += toEnd;
+	}
+
+	header(m_reserved) = bytes;
+
+	void* record = &header(m_reserved) + 1;
+
+	m_reserved += size;
+
+	return record;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Publish the records reserved since the last commit.
+
+inline void SpscByteRing::commit()
+{
+	atomicStore(m_tail, m_reserved, MEMORY_ORDER_RELEASE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the next record, which stays valid until it's released. Returns null if
+//! the ring is empty.
+
+inline const void* SpscByteRing::tryPeek(size_t& bytes)
+{
+	size_t index = m_head;
+
+	if (index == m_cachedTail)
+	{
+		m_cachedTail = atomicLoad(m_tail, MEMORY_ORDER_ACQUIRE);
+
+		if (index == m_cachedTail)
+			return nullptr;
+	}
+
+	if (header(index) == WRAP)
+		index += capacity() - (index & m_mask);
+
+	bytes = header(index);
+	m_next = index + recordSize(bytes);
+
+	return &header(index) + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Release the record returned by the last peek, so that its space can be
+//! reused.
+
+inline void SpscByteRing::release()
+{
+	ASSERT(m_next != m_head);
+
+	atomicStore(m_head, m_next, MEMORY_ORDER_RELEASE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the length header at an index.
+
+inline size_t& SpscByteRing::header(size_t index)
+{
+	return *reinterpret_cast<size_t*>(m_buffer.get() + (index & m_mask));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the space taken by a record, including its header and padding.
+
+inline size_t SpscByteRing::recordSize(size_t bytes)
+{
+	return ALIGNMENT + ((bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1));
+}
+
+//namespace Core
+}
+
+#endif // CORE_SPSCBYTERING_HPP
@@ -0,0 +1,372 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   SpscRing.hpp
+//! \brief  The SpscRing class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_SPSCRING_HPP
+#define CORE_SPSCRING_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Atomic.hpp"
+#include "AlignedArray.hpp"
+#include "CacheLine.hpp"
+#include "InvalidArgException.hpp"
+#include "ThreadUtils.hpp"
+#include <new>
+#ifdef CORE_HAS_RVALUE_REFS
+#include <utility>
+#endif
+
+// The debug CRT version of 'new' doesn't support placement new.
+#ifdef _MSC_VER
+#pragma push_macro("new")
+#undef new
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A bounded, wait-free queue for passing values from exactly one producer
+//! thread to exactly one consumer thread, e.g. between stages of a pipeline.
+//!
+//! The producer owns the tail and the consumer owns the head, and each keeps
+//! a private copy of the other's index on its own cache line. The other index
+//! is only re-read when the copy says the ring is full or empty, so in the
+//! steady state a push or pop is a plain store with no locked instructions.
+//! The batch methods transfer many values for a single publish.
+//!
+//! The producer methods must only be called by the producer thread, and the
+//! consumer methods only by the consumer thread.
+
+template <typename T>
+class SpscRing /*: private NotCopyable*/
+{
+public:
+	//! Construction with the capacity, which must be a power of two.
+	explicit SpscRing(size_t capacity);
+
+	//! Destructor.
+	~SpscRing();
+
+	//
+	// Properties.
+	//
+
+	//! Get the maximum number of values the ring can hold.
+	size_t capacity() const;
+
+	//! Get the number of values in the ring.
+	size_t size() const;
+
+	//! Query if the ring is empty.
+	bool empty() const;
+
+	//
+	// Producer methods.
+	//
+
+	//! Push a value, unless the ring is full.
+	bool tryPush(const T& value);
+
+	//! Push a value, waiting until there is space.
+	void push(const T& value);
+
+	//! Push as many of the values as there is space for.
+	size_t pushBatch(const T* values, size_t count);
+
+	//
+	// Consumer methods.
+	//
+
+	//! Pop a value, unless the ring is empty.
+	bool tryPop(T& value);
+
+	//! Pop a value, waiting until there is one.
+	void pop(T& value);
+
+	//! Pop as many values as are available, up to the count.
+	size_t popBatch(T* values, size_t count);
+
+private:
+	//! The storage for a value.
+	union Storage
+	{
+		char		m_bytes[sizeof(T)];
+		double		m_double;
+		long double	m_longDouble;
+		long		m_long;
+		void*		m_pointer;
+	};
+
+	//! The ring buffer type.
+	typedef AlignedArray<Storage> Slots;
+
+	//
+	// Members.
+	//
+	Slots			m_slots;		//!< The ring buffer.
+	size_t			m_mask;			//!< The mask to map an index to a slot.
+	CachePadding<>	m_padding1;		//!< Keep the producer off the read-only members.
+	size_t			m_tail;			//!< The index of the next push.
+	size_t			m_cachedHead;	//!< The producer's copy of the head.
+	CachePadding<>	m_padding2;		//!< Keep the consumer off the producer.
+	size_t			m_head;			//!< The index of the next pop.
+	size_t			m_cachedTail;	//!< The consumer's copy of the tail.
+	CachePadding<>	m_padding3;		//!< Keep the consumer off whatever follows.
+
+	//
+	// Internal methods.
+	//
+
+	//! Get the value in the slot for an index.
+	T* slotValue(size_t index);
+
+	//! Get the number of free slots, refreshing the head if fewer than wanted.
+	size_t writable(size_t wanted);
+
+	//! Get the number of full slots, refreshing the tail if fewer than wanted.
+	size_t readable(size_t wanted);
+
+	// NotCopyable.
+	SpscRing(const SpscRing&);
+	SpscRing& operator=(const SpscRing&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the capacity, which must be a power of two.
+
+template <typename T>
+inline SpscRing<T>::SpscRing(size_t capacity)
+	: m_slots(capacity, Slots::DEFAULT_ALIGNMENT, Slots::UNINITIALISED)
+	, m_mask(capacity - 1)
+	, m_tail(0)
+	, m_cachedHead(0)
+	, m_head(0)
+	, m_cachedTail(0)
+{
+	if ( (capacity == 0) || ((capacity & m_mask) != 0) )
+		throw InvalidArgException(TXT("The ring capacity must be a power of two"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. Any values still in the ring are destroyed.
+
+template <typename T>
+inline SpscRing<T>::~SpscRing()
+{
+	for (size_t index = m_head; index != m_tail; ++index)
+		slotValue(index)->~T();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the maximum number of values the ring can hold.
+
+template <typename T>
+inline size_t SpscRing<T>::capacity() const
+{
+	return m_mask + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of values in the ring. The value may be stale by the time
+//! it's used.
+
+template <typename T>
+inline size_t SpscRing<T>::size() const
+{
+	const size_t head = atomicLoad(m_head, MEMORY_ORDER_ACQUIRE);
+	const size_t tail = atomicLoad(m_tail, MEMORY_ORDER_ACQUIRE);
+
+	return tail - head;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the ring is empty. The value may be stale by the time it's used.
+
+template <typename T>
+inline bool SpscRing<T>::empty() const
+{
+	return (size() == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Push a value, unless the ring is full. Returns false if the ring is full.
+
+template <typename T>
+inline bool SpscRing<T>::tryPush(const T& value)
+{
+	if (writable(1) == 0)
+		return false;
+
+	new(slotValue(m_tail)) T(value);
+	atomicStore(m_tail, m_tail+1, MEMORY_ORDER_RELEASE);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Push a value, waiting until there is space. The calling thread yields while
+//! it waits.
+
+template <typename T>
+inline void SpscRing<T>::push(const T& value)
+{
+	while (!tryPush(value))
+		yieldThread();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Push as many of the values as there is space for, and publish them all in
+//! one go. Returns the number of values pushed.
+
+template <typename T>
+inline size_t SpscRing<T>::pushBatch(const T* values, size_t count)
+{
+	const size_t available = writable(count);
+	const size_t pushed = (count < available) ? count : available;
+	size_t       index = 0;
+
+	try
+	{
+		for (; index != pushed; ++index)
+			new(slotValue(m_tail+index)) T(values[index]);
+	}
+	catch (...)
+	{
+		atomicStore(m_tail, m_tail+index, MEMORY_ORDER_RELEASE);
+		throw;
+	}
+
+	atomicStore(m_tail, m_tail+pushed, MEMORY_ORDER_RELEASE);
+
+	return pushed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Pop a value, unless the ring is empty. Returns false if the ring is empty.
+
+template <typename T>
+inline bool SpscRing<T>::tryPop(T& value)
+{
+	if (readable(1) == 0)
+		return false;
+
+	T* stored = slotValue(m_head);
+
+#ifdef CORE_HAS_RVALUE_REFS
+	value = std::move(*stored);
+#else
+	value = *stored;
+#endif
+	stored->~T();
+
+	atomicStore(m_head, m_head+1, MEMORY_ORDER_RELEASE);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Pop a value, waiting until there is one. The calling thread yields while
+//! it waits.
+
+template <typename T>
+inline void SpscRing<T>::pop(T& value)
+{
+	while (!tryPop(value))
+		yieldThread();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Pop as many values as are available, up to the count, and free their slots
+//! in one go. Returns the number of values popped.
+
+template <typename T>
+inline size_t SpscRing<T>::popBatch(T* values, size_t count)
+{
+	const size_t available = readable(count);
+	const size_t popped = (count < available) ? count : available;
+	size_t       index = 0;
+
+	try
+	{
+		for (; index != popped; ++index)
+		{
+			T* stored = slotValue(m_head+index);
+
+#ifdef CORE_HAS_RVALUE_REFS
+			values[index] = std::move(*stored);
+#else
+			values[index] = *stored;
+#endif
+			stored->~T();
+		}
+	}
+	catch (...)
+	{
+		atomicStore(m_head, m_head+index, MEMORY_ORDER_RELEASE);
+		throw;
+	}
+
+	atomicStore(m_head, m_head+popped, MEMORY_ORDER_RELEASE);
+
+	return popped;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the value in the slot for an index.
+
+template <typename T>
+inline T* SpscRing<T>::slotValue(size_t index)
+{
+	return reinterpret_cast<T*>(m_slots[index & m_mask].m_bytes);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of free slots. The head is only re-read when the producer's
+//! copy says there are fewer than wanted.
+
+template <typename T>
+inline size_t SpscRing<T>::writable(size_t wanted)
+{
+	size_t available = capacity() - (m_tail - m_cachedHead);
+
+	if (available < wanted)
+	{
+		m_cachedHead = atomicLoad(m_head, MEMORY_ORDER_ACQUIRE);
+		available = capacity() - (m_tail - m_cachedHead);
+	}
+
+	return available;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of full slots. The tail is only re-read when the consumer's
+//! copy says there are fewer than wanted.
+
+template <typename T>
+inline size_t SpscRing<T>::readable(size_t wanted)
+{
+	size_t available = m_cachedTail - m_head;
+
+	if (available < wanted)
+	{
+		m_cachedTail = atomicLoad(m_tail, MEMORY_ORDER_ACQUIRE);
+		available = m_cachedTail - m_head;
+	}
+
+	return available;
+}
+
+//namespace Core
+}
+
+#ifdef _MSC_VER
+#pragma pop_macro("new")
+#endif
+
+#endif // CORE_SPSCRING_HPP
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Task.hpp
+//! \brief  The Task class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_TASK_HPP
+#define CORE_TASK_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "RefCounted.hpp"
+#include "Exception.hpp"
+#include "AnsiWide.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The base class for a unit of work that is run by a ThreadPool. A task is
+//! reference counted, and the pool releases its reference once the task has
+//! been run. Any exception thrown by the work is caught and passed to the
+//! task, as there is nowhere for it to propagate to on a worker thread.
+
+class Task : public RefCounted
+{
+public:
+	//
+	// Methods.
+	//
+
+	//! Run the task, passing any exception thrown to failed().
+	void run();
+
+protected:
+	//! Default constructor.
+	Task();
+
+	//! Destructor.
+	virtual ~Task();
+
+	//
+	// Internal methods.
+	//
+
+	//! Do the work.
+	virtual void execute() = 0;
+
+	//! Handle the work failing with an exception.
+	virtual void failed(const tstring& message) = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+inline Task::Task()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+inline Task::~Task()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Run the task, passing any exception thrown to failed().
+
+inline void Task::run()
+{
+	try
+	{
+		execute();
+	}
+	catch (const Exception& e)
+	{
+		failed(e.twhat());
+	}
+	catch (const std::exception& e)
+	{
+		failed(A2T(e.what()));
+	}
+	catch (...)
+	{
+		failed(TXT("An unknown exception was thrown"));
+	}
+}
+
+//namespace Core
+}
+
+#endif // CORE_TASK_HPP
@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   AlignedArrayTests.cpp
+//! \brief  The unit tests for the AlignedArray class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/AlignedArray.hpp>
+
+namespace
+{
+
+bool isAligned(const void* buffer, size_t alignment)
+{
+	return ((reinterpret_cast<size_t>(buffer) & (alignment-1)) == 0);
+}
+
+}
+
+TEST_SET(AlignedArray)
+{
+	typedef Core::AlignedArray<float> TestArray;
+
+TEST_CASE("initial state is an empty array")
+{
+	TestArray test;
+
+	TEST_TRUE(test.get() == nullptr);
+	TEST_TRUE(test.empty());
+	TEST_TRUE(test.size() == 0);
+	TEST_TRUE(test.capacity() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("construction allocates a zeroed buffer with the requested alignment")
+{
+	TestArray test(100, 32);
+
+	TEST_TRUE(test.size() == 100);
+	TEST_TRUE(test.alignment() == 32);
+	TEST_TRUE(isAligned(test.get(), 32));
+
+	bool zeroed = true;
+
+	for (size_t i = 0; i != test.size(); ++i)
+		zeroed = zeroed && (test[i] == 0.0f);
+
+	TEST_TRUE(zeroed);
+}
+TEST_CASE_END
+
+TEST_CASE("the default alignment is a cache line")
+{
+	TestArray test(1);
+
+	TEST_TRUE(test.alignment() == Core::CACHE_LINE_SIZE);
+	TEST_TRUE(isAligned(test.get(), Core::CACHE_LINE_SIZE));
+}
+TEST_CASE_END
+
+TEST_CASE("resizing preserves the existing elements and alignment")
+{
+	TestArray test(4, 64, TestArray::UNINITIALISED);
+
+	for (size_t i = 0; i != test.size(); ++i)
+		test[i] = static_cast<float>(i);
+
+	test.resize(1000);
+
+	TEST_TRUE(test.size() == 1000);
+	TEST_TRUE(test.capacity() >= 1000);
+	TEST_TRUE(isAligned(test.get(), 64));
+	TEST_TRUE((test[0] == 0.0f) && (test[3] == 3.0f));
+}
+TEST_CASE_END
+
+TEST_CASE("growing the array a little at a time at least doubles the capacity")
+{
+	TestArray test(100);
+
+	test.resize(101);
+
+	TEST_TRUE(test.size() == 101);
+	TEST_TRUE(test.capacity() >= 200);
+
+	size_t reallocations = 0;
+
+	for (size_t size = 102; size != 10000; ++size)
+	{
+		const size_t capacity = test.capacity();
+
+		test.resize(size);
+
+		if (test.capacity() != capacity)
+			++reallocations;
+	}
+
+	TEST_TRUE(reallocations <= 6);
+}
+TEST_CASE_END
+
+TEST_CASE("shrinking the array does not reallocate the buffer")
+{
+	TestArray test(100);
+	const float* buffer = test.get();
+
+	test.resize(10);
+
+	TEST_TRUE(test.size() == 10);
+	TEST_TRUE(test.capacity() == 100);
+	TEST_TRUE(test.get() == buffer);
+}
+TEST_CASE_END
+
+TEST_CASE("small arrays are never backed by large pages")
+{
+	TestArray test(16, 64, TestArray::LARGE_PAGES);
+
+	TEST_FALSE(test.largePages());
+	TEST_TRUE(isAligned(test.get(), 64));
+}
+TEST_CASE_END
+
+TEST_CASE("a large page request falls back to normal memory when unavailable")
+{
+	const size_t size = (4 * 1024 * 1024) / sizeof(float);
+
+	TestArray test(size, 64, TestArray::LARGE_PAGES | TestArray::UNINITIALISED);
+
+	TEST_TRUE(test.size() == size);
+	TEST_TRUE(test.capacity() >= size);
+	TEST_TRUE(isAligned(test.get(), 64));
+}
+TEST_CASE_END
+
+TEST_CASE("swapping exchanges the buffers")
+{
+	TestArray test1(10);
+	TestArray test2(20, 128);
+	const float* buffer1 = test1.get();
+	const float* buffer2 = test2.get();
+
+	test1.swap(test2);
+
+	TEST_TRUE((test1.get() == buffer2) && (test1.size() == 20) && (test1.alignment() == 128));
+	TEST_TRUE((test2.get() == buffer1) && (test2.size() == 10));
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,195 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   AnsiWideConverterTests.cpp
+//! \brief  The unit tests for the AnsiToWideConverter and WideToAnsiConverter classes.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/AnsiWideConverter.hpp>
+#include <Core/Utf.hpp>
+#include <vector>
+
+static std::wstring toWide(Core::AnsiToWideConverter& converter, const std::string& input, size_t chunkSize, size_t destSize)
+{
+	std::wstring         output;
+	std::vector<wchar_t> buffer(destSize);
+	const char*          begin = input.data();
+	const char*          end   = begin + input.size();
+
+	while (begin != end)
+	{
+		const char* chunkEnd = ((end - begin) > static_cast<ptrdiff_t>(chunkSize)) ? begin + chunkSize : end;
+
+		while (begin != chunkEnd)
+		{
+			wchar_t* dest = &buffer[0];
+
+			converter.convert(begin, chunkEnd, dest, &buffer[0] + destSize);
+			output.append(&buffer[0], dest);
+		}
+	}
+
+	wchar_t* dest = &buffer[0];
+
+	while (!converter.flush(dest, &buffer[0] + destSize))
+	{
+		output.append(&buffer[0], dest);
+		dest = &buffer[0];
+	}
+
+	output.append(&buffer[0], dest);
+
+	return output;
+}
+
+static std::string toAnsi(Core::WideToAnsiConverter& converter, const std::wstring& input, size_t chunkSize, size_t destSize)
+{
+	std::string       output;
+	std::vector<char> buffer(destSize);
+	const wchar_t*    begin = input.data();
+	const wchar_t*    end   = begin + input.size();
+
+	while (begin != end)
+	{
+		const wchar_t* chunkEnd = ((end - begin) > static_cast<ptrdiff_t>(chunkSize)) ? begin + chunkSize : end;
+
+		while (begin != chunkEnd)
+		{
+			char* dest = &buffer[0];
+
+			converter.convert(begin, chunkEnd, dest, &buffer[0] + destSize);
+			output.append(&buffer[0], dest);
+		}
+	}
+
+	char* dest = &buffer[0];
+
+	while (!converter.flush(dest, &buffer[0] + destSize))
+	{
+		output.append(&buffer[0], dest);
+		dest = &buffer[0];
+	}
+
+	output.append(&buffer[0], dest);
+
+	return output;
+}
+
+TEST_SET(AnsiWideConverter)
+{
+	// "aé€😀" followed by a run of ASCII.
+	const std::string utf8 = std::string("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80") + std::string(100, 'z');
+	const std::wstring wide = Core::utf8ToWide(utf8);
+
+TEST_CASE("the converter uses the current ANSI encoding by default")
+{
+	Core::AnsiToWideConverter ansiToWide;
+	Core::WideToAnsiConverter wideToAnsi;
+
+	TEST_TRUE(ansiToWide.encoding() == Core::getAnsiEncoding());
+	TEST_TRUE(wideToAnsi.encoding() == Core::getAnsiEncoding());
+	TEST_TRUE(ansiToWide.pending() == 0);
+	TEST_TRUE(wideToAnsi.pending() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a UTF-8 sequence split across chunks is held back until the rest arrives")
+{
+	Core::AnsiToWideConverter converter(Core::UTF8_ENCODING);
+	const char*               input = "\xE2\x82\xAC";
+	wchar_t                   buffer[4];
+	wchar_t*                  dest = buffer;
+	const char*               begin = input;
+
+	TEST_TRUE(converter.convert(begin, input + 2, dest, buffer + 4));
+	TEST_TRUE(begin == input + 2);
+	TEST_TRUE(dest == buffer);
+	TEST_TRUE(converter.pending() == 2);
+
+	TEST_TRUE(converter.convert(begin, input + 3, dest, buffer + 4));
+	TEST_TRUE(dest == buffer + 1);
+	TEST_TRUE(buffer[0] == static_cast<wchar_t>(0x20AC));
+	TEST_TRUE(converter.pending() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("UTF-8 converted in any size chunks matches a one-shot conversion")
+{
+	for (size_t chunkSize = 1; chunkSize != 12; ++chunkSize)
+	{
+		for (size_t destSize = 2; destSize != 6; ++destSize)
+		{
+			Core::AnsiToWideConverter ansiToWide(Core::UTF8_ENCODING);
+			Core::WideToAnsiConverter wideToAnsi(Core::UTF8_ENCODING);
+
+			TEST_TRUE(toWide(ansiToWide, utf8, chunkSize, destSize) == wide);
+			TEST_TRUE(toAnsi(wideToAnsi, wide, chunkSize, destSize + 2) == utf8);
+		}
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("converting stops when the output buffer is full")
+{
+	Core::AnsiToWideConverter converter(Core::UTF8_ENCODING);
+	const char*               input = "abc";
+	const char*               begin = input;
+	wchar_t                   buffer[2];
+	wchar_t*                  dest = buffer;
+
+	TEST_FALSE(converter.convert(begin, input + 3, dest, buffer + 2));
+	TEST_TRUE(begin == input + 2);
+	TEST_TRUE(dest == buffer + 2);
+}
+TEST_CASE_END
+
+TEST_CASE("invalid and truncated UTF-8 is replaced by the replacement character")
+{
+	Core::AnsiToWideConverter converter(Core::UTF8_ENCODING);
+
+	const std::wstring result = toWide(converter, std::string("a\xFF" "b\xE2\x82"), 1, 8);
+
+	TEST_TRUE(result.size() == 5);
+	TEST_TRUE(result[0] == L'a');
+	TEST_TRUE(result[1] == static_cast<wchar_t>(0xFFFD));
+	TEST_TRUE(result[2] == L'b');
+	TEST_TRUE(result[3] == static_cast<wchar_t>(0xFFFD));
+	TEST_TRUE(result[4] == static_cast<wchar_t>(0xFFFD));
+	TEST_TRUE(converter.pending() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("resetting the converter discards any pending sequence")
+{
+	Core::AnsiToWideConverter converter(Core::UTF8_ENCODING);
+
+	TEST_TRUE(toWide(converter, std::string("\xE2\x82"), 2, 1).size() == 2);
+
+	const char* input = "\xC3";
+	const char* begin = input;
+	wchar_t     buffer[1];
+	wchar_t*    dest = buffer;
+
+	converter.convert(begin, input + 1, dest, buffer + 1);
+
+	TEST_TRUE(converter.pending() == 1);
+
+	converter.reset();
+
+	TEST_TRUE(converter.pending() == 0);
+	TEST_TRUE(converter.flush(dest, buffer + 1) && (dest == buffer));
+}
+TEST_CASE_END
+
+TEST_CASE("the locale encoding converts one character for one character")
+{
+	Core::AnsiToWideConverter ansiToWide(Core::LOCALE_ENCODING);
+	Core::WideToAnsiConverter wideToAnsi(Core::LOCALE_ENCODING);
+
+	TEST_TRUE(toWide(ansiToWide, "hello world", 3, 2) == L"hello world");
+	TEST_TRUE(toAnsi(wideToAnsi, L"hello world", 3, 2) == "hello world");
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
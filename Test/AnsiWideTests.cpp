@@ -6,6 +6,27 @@
 #include "Common.hpp"
 #include <Core/UnitTest.hpp>
 #include <Core/AnsiWide.hpp>
+#include <locale>
+
+static std::wstring widenViaLocale(const std::string& string)
+{
+	std::wstring result(string.size(), L'\0');
+
+	if (!string.empty())
+		std::use_facet< std::ctype<wchar_t> >(std::locale()).widen(string.data(), string.data()+string.size(), &result[0]);
+
+	return result;
+}
+
+static std::string narrowViaLocale(const std::wstring& string)
+{
+	std::string result(string.size(), '\0');
+
+	if (!string.empty())
+		std::use_facet< std::ctype<wchar_t> >(std::locale()).narrow(string.data(), string.data()+string.size(), '?', &result[0]);
+
+	return result;
+}
 
 TEST_SET(AnsiWide)
 {
@@ -47,6 +68,113 @@ TEST_CASE("convert a string from Unicode to ANSI")
 }
 TEST_CASE_END
 
+TEST_CASE("the conversion objects can be passed to var_args functions")
+{
+	TEST_TRUE(sizeof(Core::AnsiToWide) == sizeof(wchar_t*));
+	TEST_TRUE(sizeof(Core::WideToAnsi) == sizeof(char*));
+}
+TEST_CASE_END
+
+TEST_CASE("strings either side of the inline buffer size are converted")
+{
+	const size_t sizes[] = { Core::InlineAnsiToWide::INLINE_SIZE-1, Core::InlineAnsiToWide::INLINE_SIZE, Core::InlineAnsiToWide::INLINE_SIZE * 4 };
+
+	for (size_t i = 0; i != ARRAY_SIZE(sizes); ++i)
+	{
+		const std::string  ansi(sizes[i], 'A');
+		const std::wstring wide(sizes[i], L'A');
+
+		TEST_TRUE(A2W(ansi.c_str()) == wide);
+		TEST_TRUE(W2A(wide.c_str()) == ansi);
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("a conversion buffer is reused for strings that fit")
+{
+	Core::WideConvertBuffer wideBuffer;
+	Core::AnsiConvertBuffer ansiBuffer;
+
+	const wchar_t* wide = Core::ansiToWide(ansiString, wideBuffer);
+
+	TEST_TRUE(std::wstring(wide) == wideString);
+	TEST_TRUE(wideBuffer.capacity() == strlen(ansiString));
+	TEST_TRUE(Core::ansiToWide(std::string("abc"), wideBuffer) == wide);
+	TEST_TRUE(std::wstring(wide) == L"abc");
+	TEST_TRUE(Core::ansiToWide("", wideBuffer) == wide);
+
+	const char* ansi = Core::wideToAnsi(wideString, ansiBuffer);
+
+	TEST_TRUE(std::string(ansi) == ansiString);
+	TEST_TRUE(Core::wideToAnsi(std::wstring(L"xyz"), ansiBuffer) == ansi);
+	TEST_TRUE(std::string(ansi) == "xyz");
+}
+TEST_CASE_END
+
+TEST_CASE("a conversion buffer grows for longer strings")
+{
+	Core::AnsiConvertBuffer buffer;
+	const std::wstring      wide(1000, L'x');
+
+	Core::wideToAnsi(L"short", buffer);
+
+	TEST_TRUE(std::string(Core::wideToAnsi(wide, buffer)) == std::string(1000, 'x'));
+	TEST_TRUE(buffer.capacity() >= 1000);
+}
+TEST_CASE_END
+
+TEST_CASE("long strings convert the same as the locale regardless of where non-ASCII characters appear")
+{
+	const std::string ascii = "The quick brown fox jumps over the lazy dog 0123456789!";
+
+	bool ansiMatches = true;
+	bool wideMatches = true;
+
+	for (size_t pos = 0; pos <= ascii.size(); pos += 7)
+	{
+		std::string ansi = ascii + ascii;
+
+		if (pos < ansi.size())
+			ansi[pos] = static_cast<char>(0xE9);
+
+		std::wstring wide = widenViaLocale(ascii + ascii);
+
+		if (pos < wide.size())
+			wide[pos] = static_cast<wchar_t>(0x20AC);
+
+		if (Core::ansiToWide(ansi) != widenViaLocale(ansi))
+			ansiMatches = false;
+
+		if (Core::wideToAnsi(wide) != narrowViaLocale(wide))
+			wideMatches = false;
+	}
+
+	TEST_TRUE(ansiMatches);
+	TEST_TRUE(wideMatches);
+	TEST_TRUE(Core::ansiToWide(ascii + ascii + ascii) == widenViaLocale(ascii + ascii + ascii));
+	TEST_TRUE(Core::wideToAnsi(widenViaLocale(ascii + ascii)) == ascii + ascii);
+}
+TEST_CASE_END
+
+TEST_CASE("conversions use UTF-8 when it is the configured ANSI encoding")
+{
+	const char*    utf8 = "caf\xC3\xA9";
+	const wchar_t  wide[] = { L'c', L'a', L'f', static_cast<wchar_t>(0xE9), L'\0' };
+
+	TEST_TRUE(Core::getAnsiEncoding() == Core::LOCALE_ENCODING);
+
+	Core::setAnsiEncoding(Core::UTF8_ENCODING);
+
+	TEST_TRUE(Core::ansiToWide(utf8) == wide);
+	TEST_TRUE(Core::wideToAnsi(wide) == utf8);
+	TEST_TRUE(A2W(utf8) == std::wstring(wide));
+	TEST_TRUE(W2A(wide) == std::string(utf8));
+	TEST_TRUE(Core::ansiToWide("bad\xFF") == std::wstring(L"bad") + static_cast<wchar_t>(0xFFFD));
+
+	Core::setAnsiEncoding(Core::LOCALE_ENCODING);
+}
+TEST_CASE_END
+
 TEST_CASE("convert from ANSI/Unicode to build dependent type")
 {
 	tstring expected = tString;
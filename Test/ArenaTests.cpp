@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ArenaTests.cpp
+//! \brief  The unit tests for the Arena and ArenaAllocator classes.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/Arena.hpp>
+#include <Core/ArenaAllocator.hpp>
+#include <vector>
+
+TEST_SET(Arena)
+{
+	typedef Core::ArenaAllocator<tchar> CharAllocator;
+	typedef std::basic_string<tchar, std::char_traits<tchar>, CharAllocator> ArenaString;
+	typedef Core::ArenaAllocator<ArenaString> StringAllocator;
+	typedef std::vector<ArenaString, StringAllocator> ArenaStrings;
+
+TEST_CASE("no memory is allocated until the first allocation")
+{
+	Core::Arena arena;
+
+	TEST_TRUE(arena.capacity() == 0);
+
+	arena.allocate(1);
+
+	TEST_TRUE(arena.capacity() == Core::Arena::DEFAULT_CHUNK_SIZE);
+}
+TEST_CASE_END
+
+TEST_CASE("allocations are consecutive and aligned")
+{
+	Core::Arena arena;
+
+	char* first = static_cast<char*>(arena.allocate(1, 1));
+	char* second = static_cast<char*>(arena.allocate(1, 1));
+	char* third = static_cast<char*>(arena.allocate(8, 64));
+
+	TEST_TRUE(second == (first + 1));
+	TEST_TRUE((reinterpret_cast<size_t>(third) % 64) == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a new chunk is added when the current one is full")
+{
+	Core::Arena arena(1024);
+
+	arena.allocate(1000);
+	arena.allocate(1000);
+
+	TEST_TRUE(arena.capacity() == 2048);
+
+	arena.allocate(4096);
+
+	TEST_TRUE(arena.capacity() >= (2048 + 4096));
+}
+TEST_CASE_END
+
+TEST_CASE("rewinding to a mark releases the memory allocated since")
+{
+	Core::Arena arena(1024);
+
+	arena.allocate(100);
+
+	const Core::Arena::Mark mark = arena.mark();
+	void* expected = arena.allocate(100);
+
+	arena.allocate(2000);
+	arena.rewind(mark);
+
+	TEST_TRUE(arena.allocate(100) == expected);
+}
+TEST_CASE_END
+
+TEST_CASE("resetting reuses the chunks without allocating more")
+{
+	Core::Arena arena(1024);
+
+	void* first = arena.allocate(1000);
+	arena.allocate(1000);
+
+	const size_t capacity = arena.capacity();
+
+	arena.reset();
+
+	TEST_TRUE(arena.allocate(1000) == first);
+	arena.allocate(1000);
+	TEST_TRUE(arena.capacity() == capacity);
+}
+TEST_CASE_END
+
+TEST_CASE("strings and containers can be allocated from an arena")
+{
+	Core::Arena     arena;
+	CharAllocator   allocator(arena);
+	ArenaStrings    strings((StringAllocator(allocator)));
+
+	for (int i = 0; i != 100; ++i)
+		strings.push_back(ArenaString(TXT("a string long enough to need the allocator"), allocator));
+
+	TEST_TRUE(strings.size() == 100);
+	TEST_TRUE(strings[99] == TXT("a string long enough to need the allocator"));
+	TEST_TRUE(arena.capacity() != 0);
+	TEST_TRUE(strings.get_allocator() == allocator);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
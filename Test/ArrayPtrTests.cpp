@@ -6,6 +6,7 @@
 #include "Common.hpp"
 #include <Core/UnitTest.hpp>
 #include <Core/ArrayPtr.hpp>
+#include <utility>
 
 TEST_SET(ArrayPtr)
 {
@@ -197,5 +198,23 @@ TEST_CASE("the pointer is not empty when it owns something")
 }
 TEST_CASE_END
 
+#ifdef CORE_HAS_RVALUE_REFS
+TEST_CASE("moving a pointer transfers ownership and leaves the source empty")
+{
+	int*    expected = new int[1];
+	TestPtr source(expected);
+	TestPtr test(std::move(source));
+
+	TEST_TRUE(test.get() == expected);
+	TEST_TRUE(source.get() == nullptr);
+
+	source = std::move(test);
+
+	TEST_TRUE(source.get() == expected);
+	TEST_TRUE(test.get() == nullptr);
+}
+TEST_CASE_END
+#endif
+
 }
 TEST_SET_END
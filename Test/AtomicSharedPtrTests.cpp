@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   AtomicSharedPtrTests.cpp
+//! \brief  The unit tests for the AtomicSharedPtr class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/AtomicSharedPtr.hpp>
+#include <Core/ThreadPool.hpp>
+#include "PtrTest.hpp"
+
+namespace
+{
+
+//! A value whose fields are checked for consistency by readers.
+struct Version
+{
+	explicit Version(long number)
+		: m_number(number)
+		, m_check(~number)
+	{
+		Core::atomicFetchAdd(s_instances, 1L);
+	}
+
+	~Version()
+	{
+		m_check = 0;
+		Core::atomicFetchSub(s_instances, 1L);
+	}
+
+	long	m_number;
+	long	m_check;
+
+	static long s_instances;
+};
+
+long Version::s_instances = 0;
+
+//! The number of versions published by the writer.
+const long VERSIONS = 20000;
+
+//! A function object that loads the value until the last version is seen.
+struct VersionReader
+{
+	typedef bool result_type;
+
+	explicit VersionReader(Core::AtomicSharedPtr<Version>& pointer)
+		: m_pointer(&pointer)
+	{
+	}
+
+	bool operator()() const
+	{
+		bool consistent = true;
+		long last = 0;
+
+		while (last != VERSIONS)
+		{
+			const Core::SharedPtr<Version> version = m_pointer->load();
+
+			consistent &= ( (version.get() != nullptr)
+						 && (version->m_check == ~version->m_number)
+						 && (version->m_number >= last) );
+
+			if (version.get() != nullptr)
+				last = version->m_number;
+		}
+
+		return consistent;
+	}
+
+	Core::AtomicSharedPtr<Version>*	m_pointer;
+};
+
+}
+
+TEST_SET(AtomicSharedPtr)
+{
+	typedef Core::SharedPtr<PtrTest> TestPtr;
+
+TEST_CASE("initial state is an empty pointer")
+{
+	Core::AtomicSharedPtr<PtrTest> test;
+
+	TEST_TRUE(test.load().get() == nullptr);
+}
+TEST_CASE_END
+
+TEST_CASE("load returns a reference to the value stored")
+{
+	TestPtr                        value(new PtrTest);
+	Core::AtomicSharedPtr<PtrTest> test(value);
+
+	TestPtr loaded = test.load();
+
+	TEST_TRUE(loaded.get() == value.get());
+	TEST_TRUE(loaded.get() == test.load().get());
+
+	TestPtr other(new PtrTest);
+
+	test.store(other);
+
+	TEST_TRUE(test.load().get() == other.get());
+}
+TEST_CASE_END
+
+TEST_CASE("the value is destroyed when the last reference is released")
+{
+	Core::SharedPtr<Derived> derived(new Derived);
+	PtrTest*                 expected = derived.get();
+
+	Core::AtomicSharedPtr<PtrTest> test((TestPtr(derived)));
+
+	derived.reset();
+
+	TestPtr loaded = test.load();
+
+	test.store(TestPtr());
+
+	TEST_TRUE(loaded.get() == expected);
+	TEST_TRUE(test.load().get() == nullptr);
+}
+TEST_CASE_END
+
+TEST_CASE("exchange returns the previous value")
+{
+	TestPtr                        first(new PtrTest);
+	TestPtr                        second(new PtrTest);
+	Core::AtomicSharedPtr<PtrTest> test(first);
+
+	TEST_TRUE(test.exchange(second).get() == first.get());
+	TEST_TRUE(test.exchange(TestPtr()).get() == second.get());
+	TEST_TRUE(test.exchange(first).get() == nullptr);
+}
+TEST_CASE_END
+
+TEST_CASE("compare exchange only replaces the value if it matches the expected one")
+{
+	TestPtr                        first(new PtrTest);
+	TestPtr                        second(new PtrTest);
+	TestPtr                        expected;
+	Core::AtomicSharedPtr<PtrTest> test(first);
+
+	TEST_FALSE(test.compareExchange(expected, second));
+	TEST_TRUE(expected.get() == first.get());
+	TEST_TRUE(test.load().get() == first.get());
+
+	TEST_TRUE(test.compareExchange(expected, second));
+	TEST_TRUE(test.load().get() == second.get());
+
+	expected = second;
+
+	TEST_TRUE(test.compareExchange(expected, TestPtr()));
+	TEST_TRUE(test.load().get() == nullptr);
+}
+TEST_CASE_END
+
+TEST_CASE("readers always see a live value whilst a writer replaces it")
+{
+	{
+		Core::ThreadPool pool(3);
+		Core::AtomicSharedPtr<Version> pointer(Core::SharedPtr<Version>(new Version(0)));
+
+		Core::Future<bool> first = pool.submit(VersionReader(pointer));
+		Core::Future<bool> second = pool.submit(VersionReader(pointer));
+		Core::Future<bool> third = pool.submit(VersionReader(pointer));
+
+		for (long i = 1; i <= VERSIONS; ++i)
+			pointer.store(Core::SharedPtr<Version>(new Version(i)));
+
+		TEST_TRUE(first.get());
+		TEST_TRUE(second.get());
+		TEST_TRUE(third.get());
+	}
+
+	TEST_TRUE(Version::s_instances == 0);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
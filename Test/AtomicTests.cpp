@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   AtomicTests.cpp
+//! \brief  The unit tests for the atomic operations and the Atomic class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/Atomic.hpp>
+
+TEST_SET(Atomic)
+{
+
+TEST_CASE("initial state is zero")
+{
+	Core::Atomic<long> test;
+
+	TEST_TRUE(test.load() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("load returns the value stored")
+{
+	Core::Atomic<long> test(1);
+
+	TEST_TRUE(test.load() == 1);
+	TEST_TRUE(test.load(Core::MEMORY_ORDER_RELAXED) == 1);
+
+	test.store(2, Core::MEMORY_ORDER_RELEASE);
+
+	TEST_TRUE(test.load(Core::MEMORY_ORDER_ACQUIRE) == 2);
+
+	test.store(3);
+
+	TEST_TRUE(test.load() == 3);
+}
+TEST_CASE_END
+
+TEST_CASE("exchange returns the previous value")
+{
+	Core::Atomic<long> test(1);
+
+	TEST_TRUE(test.exchange(2) == 1);
+	TEST_TRUE(test.exchange(3, Core::MEMORY_ORDER_ACQ_REL) == 2);
+	TEST_TRUE(test.load() == 3);
+}
+TEST_CASE_END
+
+TEST_CASE("compare exchange only replaces the value when it matches the expected one")
+{
+	Core::Atomic<long> test(1);
+	long               expected = 2;
+
+	TEST_FALSE(test.compareExchange(expected, 3));
+	TEST_TRUE(expected == 1);
+	TEST_TRUE(test.load() == 1);
+
+	TEST_TRUE(test.compareExchange(expected, 3, Core::MEMORY_ORDER_ACQ_REL));
+	TEST_TRUE(expected == 1);
+	TEST_TRUE(test.load() == 3);
+}
+TEST_CASE_END
+
+TEST_CASE("fetch operations modify the value and return the previous one")
+{
+	Core::Atomic<long> test(1);
+
+	TEST_TRUE(test.fetchAdd(2, Core::MEMORY_ORDER_RELAXED) == 1);
+	TEST_TRUE(test.fetchSub(1, Core::MEMORY_ORDER_ACQ_REL) == 3);
+	TEST_TRUE(test.fetchOr(0x0C) == 2);
+	TEST_TRUE(test.fetchAnd(0x06) == 0x0E);
+	TEST_TRUE(test.load() == 0x06);
+}
+TEST_CASE_END
+
+TEST_CASE("a 64-bit value is read and written as a whole")
+{
+	const longlong high = static_cast<longlong>(1) << 40;
+
+	Core::Atomic<longlong> test(high);
+
+	TEST_TRUE(test.fetchAdd(high) == high);
+	TEST_TRUE(test.load() == 2*high);
+
+	longlong expected = 2*high;
+
+	TEST_TRUE(test.compareExchange(expected, high | 1));
+	TEST_TRUE(test.exchange(0) == (high | 1));
+	TEST_TRUE(test.fetchOr(high) == 0);
+	TEST_TRUE(test.fetchAnd(~high) == high);
+	TEST_TRUE(test.load() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a pointer can be loaded, stored and swapped")
+{
+	int values[2] = { 0, 1 };
+
+	Core::Atomic<int*> test;
+
+	TEST_TRUE(test.load() == nullptr);
+
+	test.store(&values[0]);
+
+	TEST_TRUE(test.load() == &values[0]);
+
+	int* expected = &values[0];
+
+	TEST_TRUE(test.compareExchange(expected, &values[1]));
+	TEST_TRUE(test.exchange(nullptr) == &values[1]);
+}
+TEST_CASE_END
+
+TEST_CASE("the free functions operate on plain variables")
+{
+	long value = 1;
+
+	TEST_TRUE(Core::atomicLoad(value, Core::MEMORY_ORDER_RELAXED) == 1);
+
+	Core::atomicStore(value, 2L);
+
+	TEST_TRUE(Core::atomicFetchAdd(value, 1L) == 2);
+	TEST_TRUE(Core::atomicExchange(value, 5L) == 3);
+
+	long expected = 5;
+
+	TEST_TRUE(Core::atomicCompareSwap(value, expected, 6L));
+	TEST_TRUE(value == 6);
+
+	Core::atomicThreadFence();
+	Core::atomicThreadFence(Core::MEMORY_ORDER_ACQUIRE);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
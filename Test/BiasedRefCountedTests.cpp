@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   BiasedRefCountedTests.cpp
+//! \brief  The unit tests for the BiasedRefCounted class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/BiasedRefCounted.hpp>
+#include <Core/RefCntPtr.hpp>
+
+namespace
+{
+
+template <bool Padded>
+class Counted : public Core::BiasedRefCounted<Padded>
+{
+public:
+	Counted()
+		: m_value(42)
+	{
+		++s_instances;
+	}
+
+	int m_value;
+
+	static int s_instances;
+
+private:
+	virtual ~Counted()
+	{
+		--s_instances;
+	}
+};
+
+template <bool Padded>
+int Counted<Padded>::s_instances = 0;
+
+}
+
+TEST_SET(BiasedRefCounted)
+{
+	typedef Counted<false> Compact;
+	typedef Counted<true>  Padded;
+
+TEST_CASE("object starts confined with a reference count of 1")
+{
+	Compact* test = new Compact;
+
+	TEST_TRUE(test->refCount() == 1);
+	TEST_FALSE(test->isShared());
+
+	test->decRefCount();
+}
+TEST_CASE_END
+
+TEST_CASE("the reference count is maintained before and after sharing")
+{
+	Compact* test = new Compact;
+
+	TEST_TRUE(test->incRefCount() == 2);
+	TEST_TRUE(test->decRefCount() == 1);
+
+	test->share();
+
+	TEST_TRUE(test->isShared());
+	TEST_TRUE(test->incRefCount() == 2);
+	TEST_TRUE(test->decRefCount() == 1);
+	TEST_TRUE(Compact::s_instances == 1);
+
+	TEST_TRUE(test->decRefCount() == 0);
+	TEST_TRUE(Compact::s_instances == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("the padded count does not share a cache line with the derived class")
+{
+	Padded* test = new Padded;
+
+	const char* object = reinterpret_cast<const char*>(test);
+	const char* value = reinterpret_cast<const char*>(&test->m_value);
+
+	TEST_TRUE(sizeof(Padded) >= (2 * Core::CACHE_LINE_SIZE));
+	TEST_TRUE(static_cast<size_t>(value - object) >= (2 * Core::CACHE_LINE_SIZE));
+	TEST_TRUE(sizeof(Compact) < Core::CACHE_LINE_SIZE);
+
+	test->decRefCount();
+
+	TEST_TRUE(Padded::s_instances == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("the unpadded count takes no more space than its members")
+{
+	struct Members
+	{
+		virtual ~Members() {}
+
+		long	m_refCount;
+		bool	m_shared;
+#ifdef _DEBUG
+		ulong	m_owner;
+#endif
+	};
+
+	TEST_TRUE(sizeof(Core::BiasedRefCounted<false>) == sizeof(Members));
+}
+TEST_CASE_END
+
+TEST_CASE("the object can be owned by a RefCntPtr")
+{
+	{
+		Core::RefCntPtr<Padded> test(new Padded);
+		Core::RefCntPtr<Padded> copy(test);
+
+		test->share();
+
+		Core::RefCntPtr<Padded> shared(copy);
+
+		TEST_TRUE(test->refCount() == 3);
+		TEST_TRUE(shared->m_value == 42);
+	}
+
+	TEST_TRUE(Padded::s_instances == 0);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ConditionVariableTests.cpp
+//! \brief  The unit tests for the ConditionVariable class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/ConditionVariable.hpp>
+#include <Core/ScopedLock.hpp>
+#include <Core/ThreadPool.hpp>
+#include <deque>
+
+namespace
+{
+
+//! A queue of values shared by producers and consumers.
+struct SharedQueue
+{
+	Core::Mutex				m_mutex;
+	Core::ConditionVariable	m_ready;
+	std::deque<int>			m_values;
+	bool					m_closed;
+
+	SharedQueue()
+		: m_closed(false)
+	{
+	}
+};
+
+//! A function object that pops values until the queue is closed and empty.
+struct Consumer
+{
+	typedef long result_type;
+
+	explicit Consumer(SharedQueue& queue)
+		: m_queue(&queue)
+	{
+	}
+
+	long operator()() const
+	{
+		long sum = 0;
+
+		Core::ScopedLock<Core::Mutex> lock(m_queue->m_mutex);
+
+		for (;;)
+		{
+			while (m_queue->m_values.empty() && !m_queue->m_closed)
+				m_queue->m_ready.wait(m_queue->m_mutex);
+
+			if (m_queue->m_values.empty())
+				return sum;
+
+			sum += m_queue->m_values.front();
+			m_queue->m_values.pop_front();
+		}
+	}
+
+	SharedQueue*	m_queue;
+};
+
+}
+
+TEST_SET(ConditionVariable)
+{
+
+TEST_CASE("a wait times out if the condition variable is not notified")
+{
+	Core::Mutex mutex;
+	Core::ConditionVariable condition;
+
+	condition.notifyOne();
+	condition.notifyAll();
+
+	Core::ScopedLock<Core::Mutex> lock(mutex);
+
+	TEST_FALSE(condition.wait(mutex, 10));
+	TEST_FALSE(mutex.tryLock());
+}
+TEST_CASE_END
+
+TEST_CASE("notifying wakes the waiting threads")
+{
+	Core::ThreadPool pool(4);
+	SharedQueue queue;
+
+	Core::Future<long> first = pool.submit(Consumer(queue));
+	Core::Future<long> second = pool.submit(Consumer(queue));
+	Core::Future<long> third = pool.submit(Consumer(queue));
+
+	for (int i = 1; i <= 1000; ++i)
+	{
+		Core::ScopedLock<Core::Mutex> lock(queue.m_mutex);
+
+		queue.m_values.push_back(i);
+		queue.m_ready.notifyOne();
+	}
+
+	{
+		Core::ScopedLock<Core::Mutex> lock(queue.m_mutex);
+
+		queue.m_closed = true;
+		queue.m_ready.notifyAll();
+	}
+
+	TEST_TRUE((first.get() + second.get() + third.get()) == 500500);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
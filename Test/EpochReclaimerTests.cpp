@@ -0,0 +1,293 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   EpochReclaimerTests.cpp
+//! \brief  The unit tests for the EpochReclaimer and DeferredRefCounted classes.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/EpochReclaimer.hpp>
+#include <Core/DeferredRefCounted.hpp>
+#include <Core/RefCntPtr.hpp>
+#include <Core/ThreadPool.hpp>
+#include <Core/ThreadUtils.hpp>
+#include <Core/Event.hpp>
+#include <vector>
+
+namespace
+{
+
+class Retirable
+{
+public:
+	Retirable()
+	{
+		++s_instances;
+	}
+
+	~Retirable()
+	{
+		--s_instances;
+	}
+
+	static int s_instances;
+};
+
+int Retirable::s_instances = 0;
+
+class Deferred : public Core::DeferredRefCounted
+{
+public:
+	explicit Deferred(Core::EpochReclaimer& reclaimer)
+		: Core::DeferredRefCounted(reclaimer)
+	{
+		++s_instances;
+	}
+
+	static int s_instances;
+
+private:
+	virtual ~Deferred()
+	{
+		--s_instances;
+	}
+};
+
+int Deferred::s_instances = 0;
+
+//! An object whose destruction is only recorded, so that its memory is still
+//! valid to inspect afterwards.
+struct Version
+{
+	Version()
+		: m_destroyed(0)
+	{
+	}
+
+	long	m_destroyed;
+};
+
+//! Record that a version has been destroyed.
+void destroyVersion(void* object)
+{
+	Core::atomicStore(static_cast<Version*>(object)->m_destroyed, 1L);
+}
+
+//! A function object that reads the current version inside a region until
+//! told to stop, checking that it's never destroyed while the region lasts.
+struct VersionReader
+{
+	typedef bool result_type;
+
+	VersionReader(Core::EpochReclaimer& reclaimer, Version* const& current, const long& stop)
+		: m_reclaimer(&reclaimer)
+		, m_current(&current)
+		, m_stop(&stop)
+	{
+	}
+
+	bool operator()() const
+	{
+		bool live = true;
+
+		while (Core::atomicLoad(*m_stop) == 0)
+		{
+			Core::EpochGuard guard(*m_reclaimer);
+			Version* version = Core::atomicLoad(*m_current);
+
+			// Give the writer a chance to retire it whilst it's in use.
+			for (int i = 0; i != 10; ++i)
+			{
+				live &= (Core::atomicLoad(version->m_destroyed) == 0);
+				Core::yieldThread();
+			}
+		}
+
+		return live;
+	}
+
+	Core::EpochReclaimer*	m_reclaimer;
+	Version* const*			m_current;
+	const long*				m_stop;
+};
+
+//! A function object that enters a region and never leaves it, as if the
+//! thread was terminated.
+struct EnterRegion
+{
+	typedef void result_type;
+
+	EnterRegion(Core::EpochReclaimer& reclaimer, Core::Event& done)
+		: m_reclaimer(&reclaimer)
+		, m_done(&done)
+	{
+	}
+
+	void operator()() const
+	{
+		m_reclaimer->enter();
+		m_done->set();
+	}
+
+	Core::EpochReclaimer*	m_reclaimer;
+	Core::Event*			m_done;
+};
+
+}
+
+TEST_SET(EpochReclaimer)
+{
+
+TEST_CASE("a retired object is only destroyed once the epoch has advanced twice")
+{
+	Core::EpochReclaimer reclaimer;
+
+	reclaimer.retire(new Retirable);
+
+	TEST_TRUE(reclaimer.pending() == 1);
+	TEST_TRUE(reclaimer.reclaim() == 0);
+	TEST_TRUE(Retirable::s_instances == 1);
+	TEST_TRUE(reclaimer.epoch() == 1);
+
+	TEST_TRUE(reclaimer.reclaim() == 1);
+	TEST_TRUE(Retirable::s_instances == 0);
+	TEST_TRUE(reclaimer.pending() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("the epoch cannot advance past a thread inside a region")
+{
+	Core::EpochReclaimer reclaimer;
+
+	{
+		Core::EpochGuard guard(reclaimer);
+
+		reclaimer.retire(new Retirable);
+
+		TEST_TRUE(reclaimer.reclaim() == 0);
+		TEST_TRUE(reclaimer.reclaim() == 0);
+		TEST_TRUE(reclaimer.epoch() == 1);
+		TEST_TRUE(Retirable::s_instances == 1);
+	}
+
+	TEST_TRUE(reclaimer.reclaim() == 1);
+	TEST_TRUE(Retirable::s_instances == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("regions can be nested")
+{
+	Core::EpochReclaimer reclaimer;
+
+	{
+		Core::EpochGuard outer(reclaimer);
+
+		{
+			Core::EpochGuard inner(reclaimer);
+		}
+
+		reclaimer.reclaim();
+		reclaimer.reclaim();
+
+		TEST_TRUE(reclaimer.epoch() == 1);
+	}
+
+	reclaimer.reclaim();
+
+	TEST_TRUE(reclaimer.epoch() == 2);
+}
+TEST_CASE_END
+
+TEST_CASE("destroying the reclaimer destroys any objects still waiting")
+{
+	{
+		Core::EpochReclaimer reclaimer;
+
+		reclaimer.retire(new Retirable);
+		reclaimer.retire(new Retirable);
+	}
+
+	TEST_TRUE(Retirable::s_instances == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("an object read by another thread is not destroyed whilst it's inside a region")
+{
+	const size_t versions = 5000;
+
+	std::vector<Version> storage(versions);
+	Version* current = &storage[0];
+	long     stop = 0;
+
+	{
+		Core::EpochReclaimer reclaimer;
+		Core::ThreadPool pool(3);
+
+		Core::Future<bool> first = pool.submit(VersionReader(reclaimer, current, stop));
+		Core::Future<bool> second = pool.submit(VersionReader(reclaimer, current, stop));
+		Core::Future<bool> third = pool.submit(VersionReader(reclaimer, current, stop));
+
+		for (size_t i = 1; i != versions; ++i)
+		{
+			reclaimer.retire(Core::atomicExchange(current, &storage[i]), destroyVersion);
+			reclaimer.reclaim();
+		}
+
+		Core::atomicStore(stop, 1L);
+
+		TEST_TRUE(first.get());
+		TEST_TRUE(second.get());
+		TEST_TRUE(third.get());
+	}
+
+	size_t destroyed = 0;
+
+	for (size_t i = 0; i != versions; ++i)
+		destroyed += storage[i].m_destroyed;
+
+	TEST_TRUE(destroyed == versions-1);
+}
+TEST_CASE_END
+
+TEST_CASE("a region left open by a thread that has exited is closed when its state is reused")
+{
+	Core::EpochReclaimer reclaimer;
+	Core::Event done;
+
+	{
+		Core::ThreadPool pool(1);
+
+		pool.submit(EnterRegion(reclaimer, done));
+		done.wait();
+	}
+
+	// The calling thread takes over the exited thread's state.
+	reclaimer.retire(new Retirable);
+
+	reclaimer.reclaim();
+	reclaimer.reclaim();
+
+	TEST_TRUE(Retirable::s_instances == 0);
+	TEST_TRUE(reclaimer.pending() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a deferred object is destroyed by the reclaimer, not by the last release")
+{
+	Core::EpochReclaimer reclaimer;
+
+	{
+		Core::RefCntPtr<Deferred> test(new Deferred(reclaimer));
+	}
+
+	TEST_TRUE(Deferred::s_instances == 1);
+	TEST_TRUE(reclaimer.pending() == 1);
+
+	reclaimer.reclaim();
+	reclaimer.reclaim();
+
+	TEST_TRUE(Deferred::s_instances == 0);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
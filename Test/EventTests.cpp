@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   EventTests.cpp
+//! \brief  The unit tests for the Event class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/Event.hpp>
+#include <Core/ThreadPool.hpp>
+
+namespace
+{
+
+//! A function object that waits on an event.
+struct WaitFor
+{
+	typedef bool result_type;
+
+	explicit WaitFor(Core::Event& event)
+		: m_event(&event)
+	{
+	}
+
+	bool operator()() const
+	{
+		m_event->wait();
+
+		return true;
+	}
+
+	Core::Event*	m_event;
+};
+
+}
+
+TEST_SET(Event)
+{
+
+TEST_CASE("an event is reset unless constructed as signalled")
+{
+	Core::Event event;
+	Core::Event signalled(Core::Event::MANUAL_RESET, true);
+
+	TEST_TRUE(event.mode() == Core::Event::AUTO_RESET);
+	TEST_FALSE(event.isSignalled());
+	TEST_FALSE(event.wait(10));
+
+	TEST_TRUE(signalled.mode() == Core::Event::MANUAL_RESET);
+	TEST_TRUE(signalled.isSignalled());
+	TEST_TRUE(signalled.wait(10));
+}
+TEST_CASE_END
+
+TEST_CASE("an auto reset event is reset by releasing a waiting thread")
+{
+	Core::Event event(Core::Event::AUTO_RESET);
+
+	event.set();
+	event.set();
+
+	TEST_TRUE(event.isSignalled());
+	TEST_TRUE(event.wait(10));
+	TEST_FALSE(event.isSignalled());
+	TEST_FALSE(event.wait(10));
+}
+TEST_CASE_END
+
+TEST_CASE("a manual reset event stays signalled until it is reset")
+{
+	Core::Event event(Core::Event::MANUAL_RESET);
+
+	event.set();
+
+	TEST_TRUE(event.wait(10));
+	TEST_TRUE(event.wait(10));
+
+	event.reset();
+
+	TEST_FALSE(event.isSignalled());
+	TEST_FALSE(event.wait(10));
+}
+TEST_CASE_END
+
+TEST_CASE("setting an event releases the threads waiting on it")
+{
+	Core::ThreadPool pool(4);
+	Core::Event manual(Core::Event::MANUAL_RESET);
+	Core::Event automatic(Core::Event::AUTO_RESET);
+
+	Core::Future<bool> first = pool.submit(WaitFor(manual));
+	Core::Future<bool> second = pool.submit(WaitFor(manual));
+	Core::Future<bool> third = pool.submit(WaitFor(automatic));
+
+	manual.set();
+	automatic.set();
+
+	TEST_TRUE(first.get() && second.get() && third.get());
+	TEST_TRUE(manual.isSignalled());
+	TEST_FALSE(automatic.isSignalled());
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
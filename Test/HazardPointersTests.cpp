@@ -0,0 +1,270 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   HazardPointersTests.cpp
+//! \brief  The unit tests for the HazardPointers and HazardPtr classes.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/HazardPointers.hpp>
+#include <Core/BadLogicException.hpp>
+#include <Core/ThreadPool.hpp>
+#include <Core/ThreadUtils.hpp>
+#include <Core/Event.hpp>
+#include <vector>
+
+namespace
+{
+
+class Node
+{
+public:
+	Node()
+	{
+		++s_instances;
+	}
+
+	~Node()
+	{
+		--s_instances;
+	}
+
+	static int s_instances;
+};
+
+int Node::s_instances = 0;
+
+//! An object whose destruction is only recorded, so that its memory is still
+//! valid to inspect afterwards.
+struct Version
+{
+	Version()
+		: m_destroyed(0)
+	{
+	}
+
+	long	m_destroyed;
+};
+
+//! Record that a version has been destroyed.
+void destroyVersion(void* object)
+{
+	Core::atomicStore(static_cast<Version*>(object)->m_destroyed, 1L);
+}
+
+//! A function object that protects the current version until told to stop,
+//! checking that a protected version is never destroyed.
+struct VersionReader
+{
+	typedef bool result_type;
+
+	VersionReader(Core::HazardPointers& domain, Version* const& current, const long& stop)
+		: m_domain(&domain)
+		, m_current(&current)
+		, m_stop(&stop)
+	{
+	}
+
+	bool operator()() const
+	{
+		bool live = true;
+
+		while (Core::atomicLoad(*m_stop) == 0)
+		{
+			Core::HazardPtr<Version> hazard(*m_domain);
+			Version* version = hazard.protect(*m_current);
+
+			// Give the writer a chance to retire it whilst it's protected.
+			for (int i = 0; i != 10; ++i)
+			{
+				live &= (Core::atomicLoad(version->m_destroyed) == 0);
+				Core::yieldThread();
+			}
+		}
+
+		return live;
+	}
+
+	Core::HazardPointers*	m_domain;
+	Version* const*			m_current;
+	const long*				m_stop;
+};
+
+//! A function object that protects an object and never releases the slot, as
+//! if the thread was terminated.
+struct AbandonHazard
+{
+	typedef void result_type;
+
+	AbandonHazard(Core::HazardPointers& domain, Node* node, Core::Event& done)
+		: m_domain(&domain)
+		, m_node(node)
+		, m_done(&done)
+	{
+	}
+
+	void operator()() const
+	{
+		const void** slot = m_domain->acquireSlot();
+
+		Core::atomicStore(*slot, static_cast<const void*>(m_node));
+		m_done->set();
+	}
+
+	Core::HazardPointers*	m_domain;
+	Node*					m_node;
+	Core::Event*			m_done;
+};
+
+}
+
+TEST_SET(HazardPointers)
+{
+	const size_t THRESHOLD = 2 * Core::HazardPointers::SLOTS_PER_THREAD;
+
+TEST_CASE("retired objects are destroyed once the scan threshold is reached")
+{
+	Core::HazardPointers domain;
+
+	for (size_t i = 0; i != THRESHOLD-1; ++i)
+		domain.retire(new Node);
+
+	TEST_TRUE(domain.pending() == THRESHOLD-1);
+	TEST_TRUE(Node::s_instances == static_cast<int>(THRESHOLD-1));
+
+	domain.retire(new Node);
+
+	TEST_TRUE(domain.pending() == 0);
+	TEST_TRUE(Node::s_instances == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a protected object is not destroyed by a scan")
+{
+	Core::HazardPointers domain;
+	Node* shared = new Node;
+
+	{
+		Core::HazardPtr<Node> hazard(domain);
+
+		TEST_TRUE(hazard.protect(shared) == shared);
+		TEST_TRUE(hazard.get() == shared);
+
+		Node* unlinked = shared;
+		shared = nullptr;
+		domain.retire(unlinked);
+
+		TEST_TRUE(domain.scan() == 0);
+		TEST_TRUE(Node::s_instances == 1);
+
+		hazard.reset();
+
+		TEST_TRUE(hazard.get() == nullptr);
+		TEST_TRUE(domain.scan() == 1);
+		TEST_TRUE(Node::s_instances == 0);
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("a retired UniquePtr is detached")
+{
+	Core::HazardPointers domain;
+	Core::UniquePtr<Node> test(new Node);
+
+	domain.retire(test);
+
+	TEST_TRUE(test.get() == nullptr);
+	TEST_TRUE(domain.scan() == 1);
+	TEST_TRUE(Node::s_instances == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("acquiring more slots than a thread has throws")
+{
+	Core::HazardPointers domain;
+
+	Core::HazardPtr<Node> first(domain);
+	Core::HazardPtr<Node> second(domain);
+	Core::HazardPtr<Node> third(domain);
+	Core::HazardPtr<Node> fourth(domain);
+
+	TEST_THROWS(domain.acquireSlot());
+}
+TEST_CASE_END
+
+TEST_CASE("an object protected by another thread is not destroyed whilst it is protected")
+{
+	const size_t versions = 20000;
+
+	std::vector<Version> storage(versions);
+	Version* current = &storage[0];
+	long     stop = 0;
+
+	{
+		Core::HazardPointers domain;
+		Core::ThreadPool pool(3);
+
+		Core::Future<bool> first = pool.submit(VersionReader(domain, current, stop));
+		Core::Future<bool> second = pool.submit(VersionReader(domain, current, stop));
+		Core::Future<bool> third = pool.submit(VersionReader(domain, current, stop));
+
+		for (size_t i = 1; i != versions; ++i)
+			domain.retire(Core::atomicExchange(current, &storage[i]), destroyVersion);
+
+		Core::atomicStore(stop, 1L);
+
+		TEST_TRUE(first.get());
+		TEST_TRUE(second.get());
+		TEST_TRUE(third.get());
+		TEST_TRUE(domain.pending() < versions-1);
+	}
+
+	size_t destroyed = 0;
+
+	for (size_t i = 0; i != versions; ++i)
+		destroyed += storage[i].m_destroyed;
+
+	TEST_TRUE(destroyed == versions-1);
+}
+TEST_CASE_END
+
+TEST_CASE("the slots left in use by a thread that has exited are released when its state is reused")
+{
+	Core::HazardPointers domain;
+	Core::Event done;
+	Node* node = new Node;
+
+	{
+		Core::ThreadPool pool(1);
+
+		pool.submit(AbandonHazard(domain, node, done));
+		done.wait();
+	}
+
+	// The calling thread takes over the exited thread's state.
+	Core::HazardPtr<Node> first(domain);
+	Core::HazardPtr<Node> second(domain);
+	Core::HazardPtr<Node> third(domain);
+	Core::HazardPtr<Node> fourth(domain);
+
+	domain.retire(node);
+
+	TEST_TRUE(domain.scan() == 1);
+	TEST_TRUE(Node::s_instances == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("destroying the domain destroys any objects still waiting")
+{
+	{
+		Core::HazardPointers domain;
+
+		domain.retire(new Node);
+		domain.retire(new Node);
+	}
+
+	TEST_TRUE(Node::s_instances == 0);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -26,5 +26,44 @@ TEST_CASE("decrement the value by one and return the new value")
 }
 TEST_CASE_END
 
+TEST_CASE("compare exchange only replaces the value when it matches and returns the initial value")
+{
+	long value = 1;
+
+	TEST_TRUE(Core::atomicCompareExchange(value, 3, 2) == 1);
+	TEST_TRUE(value == 1);
+	TEST_TRUE(Core::atomicCompareExchange(value, 3, 1) == 1);
+	TEST_TRUE(value == 3);
+}
+TEST_CASE_END
+
+TEST_CASE("64-bit compare exchange replaces the whole value")
+{
+	const longlong initial  = (static_cast<longlong>(1) << 40) | 2;
+	const longlong exchange = (static_cast<longlong>(3) << 40) | 4;
+
+	longlong value = initial;
+
+	TEST_TRUE(Core::atomicCompareExchange64(value, exchange, 2) == initial);
+	TEST_TRUE(value == initial);
+	TEST_TRUE(Core::atomicCompareExchange64(value, exchange, initial) == initial);
+	TEST_TRUE(value == exchange);
+}
+TEST_CASE_END
+
+TEST_CASE("volatile values can be used, as with the Visual C++ intrinsics")
+{
+	volatile long     value = 1;
+	volatile longlong value64 = 1;
+
+	TEST_TRUE(Core::atomicIncrement(value) == 2);
+	TEST_TRUE(Core::atomicDecrement(value) == 1);
+	TEST_TRUE(Core::atomicCompareExchange(value, 3, 1) == 1);
+	TEST_TRUE(value == 3);
+	TEST_TRUE(Core::atomicCompareExchange64(value64, 3, 1) == 1);
+	TEST_TRUE(value64 == 3);
+}
+TEST_CASE_END
+
 }
 TEST_SET_END
@@ -0,0 +1,218 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   MpmcQueueTests.cpp
+//! \brief  The unit tests for the MpmcQueue class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/MpmcQueue.hpp>
+#include <Core/ThreadPool.hpp>
+#include <Core/Atomic.hpp>
+#include <vector>
+
+namespace
+{
+
+//! A value that counts the live instances.
+struct Counted
+{
+	static int s_instances;
+
+	Counted()
+	{
+		++s_instances;
+	}
+
+	Counted(const Counted&)
+	{
+		++s_instances;
+	}
+
+	Counted& operator=(const Counted&)
+	{
+		return *this;
+	}
+
+	~Counted()
+	{
+		--s_instances;
+	}
+};
+
+int Counted::s_instances = 0;
+
+//! The number of values pushed by each producer.
+const int VALUES_PER_PRODUCER = 10000;
+
+//! A function object that pushes its own range of values.
+struct Producer
+{
+	typedef void result_type;
+
+	Producer(Core::MpmcQueue<int>& queue, int first)
+		: m_queue(&queue)
+		, m_first(first)
+	{
+	}
+
+	void operator()() const
+	{
+		for (int i = m_first; i != m_first + VALUES_PER_PRODUCER; ++i)
+			m_queue->push(i);
+	}
+
+	Core::MpmcQueue<int>*	m_queue;
+	int						m_first;
+};
+
+//! A function object that pops values and counts how often each one is seen.
+struct Consumer
+{
+	typedef void result_type;
+
+	Consumer(Core::MpmcQueue<int>& queue, std::vector<long>& seen)
+		: m_queue(&queue)
+		, m_seen(&seen)
+	{
+	}
+
+	void operator()() const
+	{
+		for (int i = 0; i != VALUES_PER_PRODUCER; ++i)
+		{
+			int value = -1;
+
+			m_queue->pop(value);
+			Core::atomicFetchAdd((*m_seen)[value], 1L);
+		}
+	}
+
+	Core::MpmcQueue<int>*	m_queue;
+	std::vector<long>*		m_seen;
+};
+
+}
+
+TEST_SET(MpmcQueue)
+{
+
+TEST_CASE("the capacity must be a power of two")
+{
+	TEST_THROWS(Core::MpmcQueue<int>(0));
+	TEST_THROWS(Core::MpmcQueue<int>(1));
+	TEST_THROWS(Core::MpmcQueue<int>(6));
+
+	Core::MpmcQueue<int> queue(8);
+
+	TEST_TRUE(queue.capacity() == 8);
+	TEST_TRUE(queue.empty());
+}
+TEST_CASE_END
+
+TEST_CASE("values are popped in the order they were pushed")
+{
+	Core::MpmcQueue<int> queue(4);
+
+	TEST_TRUE(queue.tryPush(1));
+	TEST_TRUE(queue.tryPush(2));
+	queue.push(3);
+
+	TEST_TRUE(queue.size() == 3);
+
+	int value = 0;
+
+	TEST_TRUE(queue.tryPop(value) && (value == 1));
+	TEST_TRUE(queue.tryPop(value) && (value == 2));
+	queue.pop(value);
+	TEST_TRUE(value == 3);
+}
+TEST_CASE_END
+
+TEST_CASE("pushing fails when the queue is full and popping fails when it is empty")
+{
+	Core::MpmcQueue<int> queue(2);
+	int value = 0;
+
+	TEST_FALSE(queue.tryPop(value));
+
+	TEST_TRUE(queue.tryPush(1));
+	TEST_TRUE(queue.tryPush(2));
+	TEST_FALSE(queue.tryPush(3));
+
+	TEST_TRUE(queue.tryPop(value));
+	TEST_TRUE(queue.tryPush(3));
+}
+TEST_CASE_END
+
+TEST_CASE("the slots are reused as the positions wrap around the ring")
+{
+	Core::MpmcQueue<int> queue(4);
+	bool inOrder = true;
+
+	for (int i = 0; i != 100; ++i)
+	{
+		int value = -1;
+
+		queue.push(i);
+		queue.push(i);
+		inOrder &= (queue.tryPop(value) && (value == i));
+		inOrder &= (queue.tryPop(value) && (value == i));
+	}
+
+	TEST_TRUE(inOrder);
+	TEST_TRUE(queue.empty());
+}
+TEST_CASE_END
+
+TEST_CASE("every value pushed by many producers is popped exactly once by many consumers")
+{
+	const int producers = 2;
+	const int consumers = 2;
+
+	Core::ThreadPool pool(producers + consumers);
+	Core::MpmcQueue<int> queue(16);
+	std::vector<long> seen(producers * VALUES_PER_PRODUCER, 0);
+	std::vector< Core::Future<void> > tasks;
+
+	for (int i = 0; i != consumers; ++i)
+		tasks.push_back(pool.submit(Consumer(queue, seen)));
+
+	for (int i = 0; i != producers; ++i)
+		tasks.push_back(pool.submit(Producer(queue, i * VALUES_PER_PRODUCER)));
+
+	for (size_t i = 0; i != tasks.size(); ++i)
+		tasks[i].get();
+
+	bool exactlyOnce = true;
+
+	for (size_t i = 0; i != seen.size(); ++i)
+		exactlyOnce &= (seen[i] == 1);
+
+	TEST_TRUE(exactlyOnce);
+	TEST_TRUE(queue.empty());
+}
+TEST_CASE_END
+
+TEST_CASE("popped values and those left in the queue are destroyed")
+{
+	{
+		Core::MpmcQueue<Counted> queue(4);
+		Counted value;
+
+		queue.push(value);
+		queue.push(value);
+		queue.push(value);
+
+		TEST_TRUE(Counted::s_instances == 4);
+
+		queue.pop(value);
+
+		TEST_TRUE(Counted::s_instances == 3);
+	}
+
+	TEST_TRUE(Counted::s_instances == 0);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
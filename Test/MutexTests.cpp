@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   MutexTests.cpp
+//! \brief  The unit tests for the Mutex, SpinMutex and ScopedLock classes.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/Mutex.hpp>
+#include <Core/SpinMutex.hpp>
+#include <Core/ScopedLock.hpp>
+#include <Core/ThreadPool.hpp>
+
+namespace
+{
+
+//! A loop body that increments a counter while holding a lock.
+template <typename M>
+struct LockedIncrement
+{
+	LockedIncrement(M& mutex, size_t& counter)
+		: m_mutex(&mutex)
+		, m_counter(&counter)
+	{
+	}
+
+	void operator()(size_t first, size_t last) const
+	{
+		for (size_t i = first; i != last; ++i)
+		{
+			Core::ScopedLock<M> lock(*m_mutex);
+
+			++(*m_counter);
+		}
+	}
+
+	M*		m_mutex;
+	size_t*	m_counter;
+};
+
+}
+
+TEST_SET(Mutex)
+{
+
+TEST_CASE("a held mutex cannot be acquired again until it is released")
+{
+	Core::Mutex mutex;
+
+	TEST_TRUE(mutex.tryLock());
+	TEST_FALSE(mutex.tryLock());
+
+	mutex.unlock();
+
+	TEST_TRUE(mutex.tryLock());
+
+	mutex.unlock();
+}
+TEST_CASE_END
+
+TEST_CASE("a scoped lock holds the mutex until the end of the scope")
+{
+	Core::Mutex mutex;
+
+	{
+		Core::ScopedLock<Core::Mutex> lock(mutex);
+
+		TEST_TRUE(lock.isLocked());
+		TEST_FALSE(mutex.tryLock());
+	}
+
+	TEST_TRUE(mutex.tryLock());
+
+	mutex.unlock();
+}
+TEST_CASE_END
+
+TEST_CASE("a scoped lock can be released early and re-acquired")
+{
+	Core::SpinMutex mutex;
+	Core::ScopedLock<Core::SpinMutex> lock(mutex);
+
+	lock.unlock();
+
+	TEST_FALSE(lock.isLocked());
+	TEST_TRUE(mutex.tryLock());
+
+	mutex.unlock();
+	lock.lock();
+
+	TEST_TRUE(lock.isLocked());
+	TEST_FALSE(mutex.tryLock());
+}
+TEST_CASE_END
+
+TEST_CASE("a mutex serialises access from multiple threads")
+{
+	Core::ThreadPool pool(4);
+	Core::Mutex mutex;
+	Core::SpinMutex spinMutex;
+	size_t counter = 0, spinCounter = 0;
+
+	pool.parallelFor(0, 100000, LockedIncrement<Core::Mutex>(mutex, counter), 100);
+	pool.parallelFor(0, 100000, LockedIncrement<Core::SpinMutex>(spinMutex, spinCounter), 100);
+
+	TEST_TRUE(counter == 100000);
+	TEST_TRUE(spinCounter == 100000);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,301 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ObjectPoolTests.cpp
+//! \brief  The unit tests for the BlockPool, ObjectPool and PooledObject classes.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/ObjectPool.hpp>
+#include <Core/PooledObject.hpp>
+#include <Core/UniquePtr.hpp>
+#include <Core/RefCounted.hpp>
+#include <Core/RefCntPtr.hpp>
+#include <Core/SharedPtr.hpp>
+#include <Core/SpscRing.hpp>
+#include <Core/Event.hpp>
+#include <Core/ThreadPool.hpp>
+#include <vector>
+
+namespace
+{
+
+class Point
+{
+public:
+	Point()
+		: m_x(0), m_y(0)
+	{
+		++s_instances;
+	}
+
+	Point(int x, int y)
+		: m_x(x), m_y(y)
+	{
+		++s_instances;
+	}
+
+	~Point()
+	{
+		--s_instances;
+	}
+
+	int m_x;
+	int m_y;
+
+	static int s_instances;
+};
+
+int Point::s_instances = 0;
+
+class Message : public Core::PooledObject<Message>
+{
+public:
+	int m_id;
+};
+
+class Counted : public Core::RefCounted, public Core::PooledObject<Counted>
+{
+public:
+	int m_id;
+};
+
+class Shape : public Core::PooledObject<Shape>
+{
+public:
+	virtual ~Shape()
+	{
+	}
+
+	int m_id;
+};
+
+class LargeShape : public Shape
+{
+public:
+	char m_points[1024];
+};
+
+//! The number of blocks passed between threads in each round.
+const size_t BLOCKS_PER_ROUND = 1000;
+
+//! A function object that allocates blocks and hands them to another thread to
+//! free, waiting for them all to be freed before starting the next round.
+struct BlockProducer
+{
+	typedef void result_type;
+
+	BlockProducer(Core::BlockPool& pool, Core::SpscRing<void*>& ring, Core::Event& freed, size_t rounds)
+		: m_pool(&pool)
+		, m_ring(&ring)
+		, m_freed(&freed)
+		, m_rounds(rounds)
+	{
+	}
+
+	void operator()() const
+	{
+		for (size_t round = 0; round != m_rounds; ++round)
+		{
+			for (size_t i = 0; i != BLOCKS_PER_ROUND; ++i)
+				m_ring->push(m_pool->allocate());
+
+			m_freed->wait();
+		}
+	}
+
+	Core::BlockPool*		m_pool;
+	Core::SpscRing<void*>*	m_ring;
+	Core::Event*			m_freed;
+	size_t					m_rounds;
+};
+
+}
+
+TEST_SET(ObjectPool)
+{
+
+TEST_CASE("a freed block is reused by the next allocation")
+{
+	Core::BlockPool pool(24);
+
+	void* block = pool.allocate();
+
+	pool.deallocate(block);
+
+	TEST_TRUE(pool.allocate() == block);
+
+	pool.deallocate(block);
+}
+TEST_CASE_END
+
+TEST_CASE("blocks are aligned like the heap's")
+{
+	Core::BlockPool pool(20);
+
+	void* first = pool.allocate();
+	void* second = pool.allocate();
+
+	TEST_TRUE((reinterpret_cast<size_t>(first) % (2 * sizeof(void*))) == 0);
+	TEST_TRUE(pool.blockSize() >= 20);
+	TEST_TRUE(static_cast<size_t>(static_cast<char*>(second) - static_cast<char*>(first)) == pool.blockSize());
+
+	pool.deallocate(first);
+	pool.deallocate(second);
+}
+TEST_CASE_END
+
+TEST_CASE("new slabs are only allocated when all the blocks are in use")
+{
+	Core::BlockPool    pool(64);
+	std::vector<void*> blocks;
+
+	for (int pass = 0; pass != 2; ++pass)
+	{
+		for (size_t i = 0; i != 1000; ++i)
+			blocks.push_back(pool.allocate());
+
+		for (size_t i = 0; i != blocks.size(); ++i)
+			pool.deallocate(blocks[i]);
+
+		blocks.clear();
+	}
+
+	const size_t perSlab = (Core::BlockPool::SLAB_SIZE / 64) - 1;
+
+	TEST_TRUE(pool.slabs() == ((1000 + perSlab - 1) / perSlab));
+}
+TEST_CASE_END
+
+TEST_CASE("blocks freed by another thread are reused by the thread that allocated them")
+{
+	const size_t rounds = 3;
+
+	Core::BlockPool pool(64);
+	Core::SpscRing<void*> ring(64);
+	Core::Event freed;
+	Core::ThreadPool threads(1);
+
+	Core::Future<void> producer = threads.submit(BlockProducer(pool, ring, freed, rounds));
+
+	bool reused = true;
+
+	for (size_t round = 0; round != rounds; ++round)
+	{
+		for (size_t i = 0; i != BLOCKS_PER_ROUND; ++i)
+		{
+			void* block = nullptr;
+
+			ring.pop(block);
+			pool.deallocate(block);
+		}
+
+		reused &= (pool.slabs() == 1);
+
+		freed.set();
+	}
+
+	producer.get();
+
+	TEST_TRUE(reused);
+	TEST_TRUE(pool.slabs() == 1);
+	TEST_TRUE(pool.blocksInUse() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("an object pool constructs and destroys its objects")
+{
+	Core::ObjectPool<Point> pool;
+
+	Point* origin = pool.create();
+	Point* point = pool.create(1, 2);
+
+	TEST_TRUE(Point::s_instances == 2);
+	TEST_TRUE((origin->m_x == 0) && (point->m_x == 1) && (point->m_y == 2));
+
+	pool.destroy(origin);
+	pool.destroy(point);
+
+	TEST_TRUE(Point::s_instances == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a pooled object deleted by a UniquePtr is returned to its pool")
+{
+	Message* first = new Message;
+	Core::UniquePtr<Message> test(first);
+
+	TEST_TRUE(Message::pool().slabs() == 1);
+
+	test.reset();
+
+	Message* second = new Message;
+
+	TEST_TRUE(second == first);
+
+	delete second;
+}
+TEST_CASE_END
+
+TEST_CASE("a derived object too large for the pool's blocks is allocated from the heap")
+{
+	LargeShape* derived = new LargeShape;
+	Shape*      large = derived;
+
+	memset(derived->m_points, 0xFF, sizeof(derived->m_points));
+
+	TEST_TRUE(Shape::pool().blocksInUse() == 0);
+
+	Shape* small = new Shape;
+
+	TEST_TRUE(Shape::pool().blocksInUse() == 1);
+
+	delete large;
+
+	TEST_TRUE(Shape::pool().blocksInUse() == 1);
+
+	delete small;
+
+	TEST_TRUE(Shape::pool().blocksInUse() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a pooled object can be created by an object pool")
+{
+	Core::ObjectPool<Message> pool;
+
+	Message* message = pool.create();
+
+	TEST_TRUE(message != nullptr);
+	TEST_TRUE(Message::pool().blocksInUse() == 0);
+
+	pool.destroy(message);
+}
+TEST_CASE_END
+
+TEST_CASE("a pooled object can be created by makeShared")
+{
+	Core::SharedPtr<Message> message = Core::makeShared<Message>();
+
+	message->m_id = 42;
+
+	TEST_TRUE(message->m_id == 42);
+	TEST_TRUE(Message::pool().blocksInUse() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a pooled object released by a RefCntPtr is returned to its pool")
+{
+	Counted* first = new Counted;
+
+	{
+		Core::RefCntPtr<Counted> test(first);
+	}
+
+	Core::RefCntPtr<Counted> second(new Counted);
+
+	TEST_TRUE(second.get() == first);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -6,6 +6,7 @@
 #include "Common.hpp"
 #include <Core/UnitTest.hpp>
 #include <Core/RefCntPtr.hpp>
+#include <utility>
 
 class RefCntTest : public Core::RefCounted
 {
@@ -229,5 +230,31 @@ TEST_CASE("the pointer is not empty when it owns something")
 }
 TEST_CASE_END
 
+#ifdef CORE_HAS_RVALUE_REFS
+TEST_CASE("moving a pointer transfers ownership without changing the reference count")
+{
+	RefCntTest* expected = new RefCntTest;
+	TestPtr     source(expected);
+	TestPtr     test(std::move(source));
+
+	TEST_TRUE(test.get() == expected);
+	TEST_TRUE(source.get() == nullptr);
+	TEST_TRUE(expected->refCount() == 1);
+
+	source = std::move(test);
+
+	TEST_TRUE(source.get() == expected);
+	TEST_TRUE(test.get() == nullptr);
+	TEST_TRUE(expected->refCount() == 1);
+
+	DerivedPtr derived(new RefCntDerived);
+	TestPtr    base(std::move(derived));
+
+	TEST_TRUE(derived.get() == nullptr);
+	TEST_TRUE(base->refCount() == 1);
+}
+TEST_CASE_END
+#endif
+
 }
 TEST_SET_END
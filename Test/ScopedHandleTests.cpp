@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ScopedHandleTests.cpp
+//! \brief  The unit tests for the ScopedHandle class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/ScopedHandle.hpp>
+#include <utility>
+
+static int s_destroyed = 0;
+
+// Deleters need external linkage to be template arguments.
+int closeHandle(int /*handle*/)
+{
+	++s_destroyed;
+	return 0;
+}
+
+long __stdcall freeBuffer(void* buffer)
+{
+	free(buffer);
+	return 0;
+}
+
+TEST_SET(ScopedHandle)
+{
+	typedef Core::ScopedHandle<int, Core::FnDeleter<int, int, closeHandle, -1> > ScopedInt;
+	typedef Core::ScopedHandle<void*, Core::StdCallDeleter<void*, long, freeBuffer> > ScopedBuffer;
+
+TEST_CASE("the guard is the same size as the resource")
+{
+	TEST_TRUE(sizeof(ScopedInt) == sizeof(int));
+	TEST_TRUE(sizeof(ScopedBuffer) == sizeof(void*));
+}
+TEST_CASE_END
+
+TEST_CASE("initial state is the deleter's null value")
+{
+	ScopedInt test;
+
+	TEST_TRUE(test.get() == -1);
+	TEST_TRUE(test.empty());
+}
+TEST_CASE_END
+
+TEST_CASE("the resource is destroyed when the guard goes out of scope")
+{
+	s_destroyed = 0;
+
+	{
+		ScopedInt test(42);
+
+		TEST_FALSE(test.empty());
+	}
+
+	TEST_TRUE(s_destroyed == 1);
+}
+TEST_CASE_END
+
+TEST_CASE("attach destroys the current resource first")
+{
+	s_destroyed = 0;
+
+	ScopedInt test(1);
+
+	test.attach(2);
+
+	TEST_TRUE(s_destroyed == 1);
+	TEST_TRUE(test.get() == 2);
+}
+TEST_CASE_END
+
+TEST_CASE("detach releases ownership of the resource")
+{
+	s_destroyed = 0;
+
+	{
+		ScopedInt test(42);
+
+		TEST_TRUE(test.detach() == 42);
+		TEST_TRUE(test.empty());
+	}
+
+	TEST_TRUE(s_destroyed == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a deleter with a non-void return type can be used")
+{
+	ScopedBuffer test(malloc(1));
+
+	TEST_FALSE(test.empty());
+
+	test.reset();
+
+	TEST_TRUE(test.get() == nullptr);
+}
+TEST_CASE_END
+
+TEST_CASE("smart pointer unaware functions can attach a resource to an empty instance")
+{
+	ScopedBuffer test;
+
+	*attachTo(test) = malloc(1);
+
+	TEST_FALSE(test.empty());
+	TEST_THROWS(attachTo(test));
+}
+TEST_CASE_END
+
+#ifdef CORE_HAS_RVALUE_REFS
+TEST_CASE("moving a guard transfers ownership and leaves the source empty")
+{
+	s_destroyed = 0;
+
+	ScopedInt source(42);
+	ScopedInt test(std::move(source));
+
+	TEST_TRUE(test.get() == 42);
+	TEST_TRUE(source.empty());
+
+	ScopedInt other(1);
+
+	other = std::move(test);
+
+	TEST_TRUE(s_destroyed == 1);
+	TEST_TRUE(other.get() == 42);
+	TEST_TRUE(test.empty());
+}
+TEST_CASE_END
+#endif
+
+}
+TEST_SET_END
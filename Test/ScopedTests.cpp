@@ -6,6 +6,7 @@
 #include "Common.hpp"
 #include <Core/UnitTest.hpp>
 #include <Core/Scoped.hpp>
+#include <utility>
 
 static void nullDeleter(void* /*buffer*/)
 {
@@ -112,5 +113,25 @@ TEST_CASE("the pointer is not empty when it owns something")
 }
 TEST_CASE_END
 
+#ifdef CORE_HAS_RVALUE_REFS
+TEST_CASE("moving a guard transfers ownership and leaves the source empty")
+{
+	void*     resource = malloc(1);
+	ScopedPtr source(resource, free);
+	ScopedPtr test(std::move(source));
+
+	TEST_TRUE(test.get() == resource);
+	TEST_TRUE(source.empty());
+
+	ScopedPtr other(malloc(1), free);
+
+	other = std::move(test);
+
+	TEST_TRUE(other.get() == resource);
+	TEST_TRUE(test.empty());
+}
+TEST_CASE_END
+#endif
+
 }
 TEST_SET_END
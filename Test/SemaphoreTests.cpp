@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   SemaphoreTests.cpp
+//! \brief  The unit tests for the Semaphore class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/Semaphore.hpp>
+#include <Core/ThreadPool.hpp>
+
+namespace
+{
+
+//! A function object that waits on a semaphore a number of times.
+struct Acquire
+{
+	typedef void result_type;
+
+	Acquire(Core::Semaphore& semaphore, int count)
+		: m_semaphore(&semaphore)
+		, m_count(count)
+	{
+	}
+
+	void operator()() const
+	{
+		for (int i = 0; i != m_count; ++i)
+			m_semaphore->wait();
+	}
+
+	Core::Semaphore*	m_semaphore;
+	int					m_count;
+};
+
+}
+
+TEST_SET(Semaphore)
+{
+
+TEST_CASE("the initial count must be between zero and the maximum")
+{
+	TEST_THROWS(Core::Semaphore(-1));
+	TEST_THROWS(Core::Semaphore(0, 0));
+	TEST_THROWS(Core::Semaphore(3, 2));
+}
+TEST_CASE_END
+
+TEST_CASE("waiting decrements the count until it is zero")
+{
+	Core::Semaphore semaphore(2);
+
+	semaphore.wait();
+	TEST_TRUE(semaphore.tryWait());
+	TEST_FALSE(semaphore.tryWait());
+	TEST_FALSE(semaphore.wait(10));
+
+	semaphore.release();
+
+	TEST_TRUE(semaphore.wait(10));
+}
+TEST_CASE_END
+
+TEST_CASE("releasing does not raise the count above the maximum")
+{
+	Core::Semaphore semaphore(0, 2);
+
+	semaphore.release(5);
+
+	TEST_TRUE(semaphore.tryWait());
+	TEST_TRUE(semaphore.tryWait());
+	TEST_FALSE(semaphore.tryWait());
+}
+TEST_CASE_END
+
+TEST_CASE("each unit released wakes one waiting thread")
+{
+	Core::ThreadPool pool(4);
+	Core::Semaphore semaphore;
+
+	Core::Future<void> first = pool.submit(Acquire(semaphore, 500));
+	Core::Future<void> second = pool.submit(Acquire(semaphore, 500));
+
+	for (int i = 0; i != 1000; ++i)
+		semaphore.release();
+
+	first.get();
+	second.get();
+
+	TEST_FALSE(semaphore.tryWait());
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
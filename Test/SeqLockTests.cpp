@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   SeqLockTests.cpp
+//! \brief  The unit tests for the SeqLock class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/SeqLock.hpp>
+#include <Core/ThreadPool.hpp>
+
+namespace
+{
+
+//! A snapshot whose fields are always written with the same value.
+struct Snapshot
+{
+	double	m_rate;
+	long	m_count;
+	char	m_flag;
+};
+
+//! Create a snapshot with every field set to a value.
+Snapshot makeSnapshot(long value)
+{
+	Snapshot snapshot = { static_cast<double>(value), value, static_cast<char>(value) };
+
+	return snapshot;
+}
+
+//! Query if the fields of a snapshot agree with each other.
+bool isConsistent(const Snapshot& snapshot)
+{
+	return (snapshot.m_rate == static_cast<double>(snapshot.m_count))
+		&& (snapshot.m_flag == static_cast<char>(snapshot.m_count));
+}
+
+//! A function object that writes a sequence of snapshots.
+struct Writer
+{
+	typedef void result_type;
+
+	explicit Writer(Core::SeqLock<Snapshot>& lock)
+		: m_lock(&lock)
+	{
+	}
+
+	void operator()() const
+	{
+		for (long i = 1; i <= 10000; ++i)
+			m_lock->write(makeSnapshot(i));
+	}
+
+	Core::SeqLock<Snapshot>*	m_lock;
+};
+
+//! A function object that reads snapshots until the last one is written.
+struct Reader
+{
+	typedef bool result_type;
+
+	explicit Reader(Core::SeqLock<Snapshot>& lock)
+		: m_lock(&lock)
+	{
+	}
+
+	bool operator()() const
+	{
+		bool consistent = true;
+		long last = 0;
+
+		while (last != 10000)
+		{
+			const Snapshot snapshot = m_lock->read();
+
+			consistent &= (isConsistent(snapshot) && (snapshot.m_count >= last));
+			last = snapshot.m_count;
+		}
+
+		return consistent;
+	}
+
+	Core::SeqLock<Snapshot>*	m_lock;
+};
+
+}
+
+TEST_SET(SeqLock)
+{
+
+TEST_CASE("the value is zero-filled unless an initial value is provided")
+{
+	Core::SeqLock<Snapshot> empty;
+	Core::SeqLock<Snapshot> initial(makeSnapshot(42));
+
+	TEST_TRUE(empty.read().m_count == 0);
+	TEST_TRUE(empty.read().m_rate == 0.0);
+	TEST_TRUE(initial.read().m_count == 42);
+	TEST_TRUE(initial.writes() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a read returns the last value written")
+{
+	Core::SeqLock<Snapshot> lock;
+
+	lock.write(makeSnapshot(1));
+	lock.write(makeSnapshot(2));
+
+	Snapshot snapshot;
+
+	TEST_TRUE(lock.tryRead(snapshot));
+	TEST_TRUE(isConsistent(snapshot) && (snapshot.m_count == 2));
+	TEST_TRUE(lock.writes() == 2);
+}
+TEST_CASE_END
+
+TEST_CASE("a read never returns a value torn by a concurrent write")
+{
+	Core::ThreadPool pool(3);
+	Core::SeqLock<Snapshot> lock;
+
+	Core::Future<bool> first = pool.submit(Reader(lock));
+	Core::Future<bool> second = pool.submit(Reader(lock));
+
+	Writer writer(lock);
+
+	writer();
+
+	TEST_TRUE(first.get());
+	TEST_TRUE(second.get());
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ShardedCounterTests.cpp
+//! \brief  The unit tests for the ShardedCounter, ShardedGauge and
+//!         ShardedHistogram classes.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/ShardedCounter.hpp>
+#include <Core/ShardedGauge.hpp>
+#include <Core/ShardedHistogram.hpp>
+#include <Core/ThreadPool.hpp>
+
+namespace
+{
+
+//! A loop body that counts each index.
+struct CountIndices
+{
+	explicit CountIndices(Core::ShardedCounter& counter)
+		: m_counter(&counter)
+	{
+	}
+
+	void operator()(size_t first, size_t last) const
+	{
+		for (size_t i = first; i != last; ++i)
+			m_counter->increment();
+	}
+
+	Core::ShardedCounter*	m_counter;
+};
+
+}
+
+TEST_SET(ShardedCounter)
+{
+
+TEST_CASE("there must be at least one slot and each thread has its own shard")
+{
+	TEST_THROWS(Core::ShardedSlots(0));
+
+	Core::ShardedSlots slots(3);
+
+	TEST_TRUE(slots.shards() == 0);
+	TEST_TRUE(slots.sum(2) == 0);
+
+	slots.add(2, 5);
+	slots.add(2, -7);
+
+	TEST_TRUE(slots.shards() == 1);
+	TEST_TRUE(slots.sum(2) == -2);
+}
+TEST_CASE_END
+
+TEST_CASE("a counter sums the events counted on every thread")
+{
+	Core::ThreadPool pool(4);
+	Core::ShardedCounter counter;
+
+	counter.add(5);
+	pool.parallelFor(0, 100000, CountIndices(counter), 100);
+
+	TEST_TRUE(counter.read() == 100005);
+
+	counter.reset();
+
+	TEST_TRUE(counter.read() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a gauge goes up and down")
+{
+	Core::ShardedGauge gauge;
+
+	gauge.increment();
+	gauge.increment();
+	gauge.decrement();
+	gauge.add(-3);
+
+	TEST_TRUE(gauge.read() == -2);
+}
+TEST_CASE_END
+
+TEST_CASE("a histogram value is recorded in the bucket for its number of bits")
+{
+	TEST_TRUE(Core::ShardedHistogram::bucket(0) == 0);
+	TEST_TRUE(Core::ShardedHistogram::bucket(1) == 1);
+	TEST_TRUE(Core::ShardedHistogram::bucket(7) == 3);
+	TEST_TRUE(Core::ShardedHistogram::bucket(8) == 4);
+	TEST_TRUE(Core::ShardedHistogram::bucket(ulonglong(1) << 40) == 41);
+	TEST_TRUE(Core::ShardedHistogram::bucket(~ulonglong(0)) == 64);
+
+	TEST_TRUE(Core::ShardedHistogram::lowerBound(4) == 8);
+	TEST_TRUE(Core::ShardedHistogram::upperBound(4) == 15);
+}
+TEST_CASE_END
+
+TEST_CASE("a histogram reports the count, sum and quantiles of the values")
+{
+	Core::ShardedHistogram histogram;
+
+	TEST_TRUE(histogram.quantile(0.5) == 0);
+
+	for (ulonglong value = 1; value <= 100; ++value)
+		histogram.record(value);
+
+	TEST_TRUE(histogram.count() == 100);
+	TEST_TRUE(histogram.count(7) == 37);
+	TEST_TRUE(histogram.sum() == 5050);
+	TEST_TRUE(histogram.quantile(0.0) == 1);
+	TEST_TRUE(histogram.quantile(0.5) == 63);
+	TEST_TRUE(histogram.quantile(1.0) == 127);
+
+	histogram.reset();
+
+	TEST_TRUE(histogram.count() == 0);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
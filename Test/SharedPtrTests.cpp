@@ -6,6 +6,8 @@
 #include "Common.hpp"
 #include <Core/UnitTest.hpp>
 #include <Core/SharedPtr.hpp>
+#include <utility>
+#include <vector>
 #include "PtrTest.hpp"
 
 namespace
@@ -25,6 +27,27 @@ public:
 	int m_value;
 };
 
+class Counted
+{
+public:
+	Counted(int a, const std::string& b, char c)
+		: m_sum(a + static_cast<int>(b.size()) + c)
+	{
+		++s_instances;
+	}
+
+	~Counted()
+	{
+		--s_instances;
+	}
+
+	int m_sum;
+
+	static int s_instances;
+};
+
+int Counted::s_instances = 0;
+
 }
 
 TEST_SET(SharedPtr)
@@ -204,5 +227,154 @@ TEST_CASE("pointer can only be statically or dynamically cast to related types")
 }
 TEST_CASE_END
 
+TEST_CASE("makeShared creates an object from the arguments")
+{
+	TEST_TRUE(Core::makeShared<TestType>().get()->m_value == 0);
+	TEST_TRUE(Core::makeShared<TestType>(42).get()->m_value == 42);
+
+	ImmutableTestTypePtr immutable = Core::makeShared<const TestType>(42);
+
+	TEST_TRUE(immutable->m_value == 42);
+}
+TEST_CASE_END
+
+TEST_CASE("an object created by makeShared is destroyed with the last reference")
+{
+	typedef Core::SharedPtr<Counted> CountedPtr;
+
+	{
+		CountedPtr test1 = Core::makeShared<Counted>(1, std::string("two"), '\x03');
+		CountedPtr test2(test1);
+
+		TEST_TRUE(test1->m_sum == 7);
+		TEST_TRUE(Counted::s_instances == 1);
+
+		test1.reset();
+
+		TEST_TRUE(Counted::s_instances == 1);
+	}
+
+	TEST_TRUE(Counted::s_instances == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("an object created by makeShared can be cast to related types")
+{
+	DerivedPtr derived = Core::makeShared<Derived>();
+	TestPtr    base(derived);
+
+	TEST_TRUE(base.get() == derived.get());
+
+	derived.reset();
+
+	DerivedPtr derived2 = Core::static_ptr_cast<Derived>(base);
+
+	TEST_TRUE(derived2.get() == base.get());
+
+	derived2 = Core::dynamic_ptr_cast<Derived>(base);
+
+	TEST_TRUE(derived2.get() == base.get());
+
+	UnrelatedPtr unrelated = Core::dynamic_ptr_cast<Unrelated>(base);
+
+	TEST_TRUE(unrelated.get() == nullptr);
+}
+TEST_CASE_END
+
+TEST_CASE("an object created by makeLocalShared is destroyed with the last reference")
+{
+	typedef Core::SharedPtr<Counted, Core::LocalCount> LocalCountedPtr;
+
+	{
+		LocalCountedPtr test1 = Core::makeLocalShared<Counted>(1, std::string("two"), '\x03');
+		LocalCountedPtr test2(test1);
+
+		TEST_TRUE(test1->m_sum == 7);
+		TEST_TRUE(Counted::s_instances == 1);
+
+		test1.reset();
+
+		TEST_TRUE(Counted::s_instances == 1);
+	}
+
+	TEST_TRUE(Counted::s_instances == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a thread-confined pointer can be cast to related types")
+{
+	typedef Core::SharedPtr<PtrTest, Core::LocalCount> LocalTestPtr;
+	typedef Core::SharedPtr<Derived, Core::LocalCount> LocalDerivedPtr;
+
+	LocalDerivedPtr derived = Core::makeLocalShared<Derived>();
+	LocalTestPtr    base(derived);
+
+	TEST_TRUE(base.get() == derived.get());
+
+	LocalDerivedPtr derived2 = Core::static_ptr_cast<Derived>(base);
+
+	TEST_TRUE(derived2.get() == base.get());
+
+	derived2 = Core::dynamic_ptr_cast<Derived>(base);
+
+	TEST_TRUE(derived2.get() == base.get());
+
+	LocalTestPtr test(new PtrTest);
+
+	TEST_TRUE(test.get() != nullptr);
+}
+TEST_CASE_END
+
+#ifdef CORE_HAS_RVALUE_REFS
+TEST_CASE("moving a pointer transfers ownership and leaves the source empty")
+{
+	PtrTest*   expected = new PtrTest;
+	DerivedPtr derived(new Derived);
+	TestPtr    source(expected);
+	TestPtr    test(std::move(source));
+
+	TEST_TRUE(test.get() == expected);
+	TEST_TRUE(source.get() == nullptr);
+
+	source = std::move(test);
+
+	TEST_TRUE(source.get() == expected);
+	TEST_TRUE(test.get() == nullptr);
+
+	Derived* expectedDerived = derived.get();
+
+	source = std::move(derived);
+
+	TEST_TRUE(source.get() == expectedDerived);
+	TEST_TRUE(derived.get() == nullptr);
+
+	TestPtr base(std::move(source));
+
+	TEST_TRUE(base.get() == expectedDerived);
+}
+TEST_CASE_END
+
+TEST_CASE("moving a pointer does not change the reference count")
+{
+	typedef Core::SharedPtr<Counted> CountedPtr;
+
+	{
+		std::vector<CountedPtr> pointers;
+
+		for (int i = 0; i != 100; ++i)
+			pointers.push_back(Core::makeShared<Counted>(i, std::string(), '\0'));
+
+		CountedPtr moved(std::move(pointers.front()));
+
+		TEST_TRUE(pointers.front().get() == nullptr);
+		TEST_TRUE(moved->m_sum == 0);
+		TEST_TRUE(Counted::s_instances == 100);
+	}
+
+	TEST_TRUE(Counted::s_instances == 0);
+}
+TEST_CASE_END
+#endif
+
 }
 TEST_SET_END
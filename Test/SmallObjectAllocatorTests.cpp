@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   SmallObjectAllocatorTests.cpp
+//! \brief  The unit tests for the SmallObjectAllocator class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/SmallObjectAllocator.hpp>
+#include <Core/SharedPtr.hpp>
+
+TEST_SET(SmallObjectAllocator)
+{
+	typedef Core::SmallObjectAllocator Allocator;
+
+TEST_CASE("requests are rounded up to the smallest size class that fits")
+{
+	TEST_TRUE(Allocator::sizeClass(1) == 0);
+	TEST_TRUE(Allocator::sizeClass(16) == 0);
+	TEST_TRUE(Allocator::sizeClass(17) == 1);
+	TEST_TRUE(Allocator::sizeClass(Allocator::MAX_SIZE) == (Allocator::SIZE_CLASSES-1));
+
+	Allocator allocator;
+
+	TEST_TRUE(allocator.pool(Allocator::sizeClass(40)).blockSize() == 48);
+}
+TEST_CASE_END
+
+TEST_CASE("no memory is reserved until the first allocation")
+{
+	Allocator allocator;
+
+	TEST_TRUE(allocator.bytesReserved() == 0);
+	TEST_TRUE(allocator.bytesInUse() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("freeing a block makes it available for the next allocation of the same size class")
+{
+	Allocator allocator;
+
+	void* block = allocator.allocate(20);
+
+	TEST_TRUE(allocator.bytesInUse() == 32);
+	TEST_TRUE(allocator.bytesReserved() == Core::BlockPool::SLAB_SIZE);
+
+	allocator.deallocate(block, 20);
+
+	TEST_TRUE(allocator.bytesInUse() == 0);
+	TEST_TRUE(allocator.allocate(32) == block);
+
+	allocator.deallocate(block, 32);
+}
+TEST_CASE_END
+
+TEST_CASE("requests larger than the largest size class are served by the heap")
+{
+	Allocator allocator;
+
+	void* block = allocator.allocate(Allocator::MAX_SIZE+1);
+
+	TEST_TRUE(block != nullptr);
+	TEST_TRUE(allocator.bytesReserved() == 0);
+
+	allocator.deallocate(block, Allocator::MAX_SIZE+1);
+}
+TEST_CASE_END
+
+TEST_CASE("the shared instance is the same object every time")
+{
+	TEST_TRUE(&Allocator::instance() == &Allocator::instance());
+}
+TEST_CASE_END
+
+#ifdef CORE_SMALL_OBJECT_ALLOCATOR
+TEST_CASE("shared pointer control blocks are allocated from the shared instance")
+{
+	Allocator& allocator = Allocator::instance();
+
+	const size_t before = allocator.bytesInUse();
+
+	{
+		Core::SharedPtr<int> ptr(new int(42));
+		Core::SharedPtr<int> obj = Core::makeShared<int>(42);
+
+		TEST_TRUE(allocator.bytesInUse() > before);
+	}
+
+	TEST_TRUE(allocator.bytesInUse() == before);
+}
+TEST_CASE_END
+#endif
+
+}
+TEST_SET_END
@@ -0,0 +1,316 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   SpscRingTests.cpp
+//! \brief  The unit tests for the SpscRing and SpscByteRing classes.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/SpscRing.hpp>
+#include <Core/SpscByteRing.hpp>
+#include <Core/ThreadPool.hpp>
+#include <Core/ThreadUtils.hpp>
+#include <string.h>
+
+namespace
+{
+
+//! A value that counts the live instances.
+struct Counted
+{
+	static int s_instances;
+
+	Counted()
+	{
+		++s_instances;
+	}
+
+	Counted(const Counted&)
+	{
+		++s_instances;
+	}
+
+	~Counted()
+	{
+		--s_instances;
+	}
+};
+
+int Counted::s_instances = 0;
+
+//! The number of values or records streamed by the threaded tests.
+const size_t STREAM_LENGTH = 20000;
+
+//! Get the length of a streamed record, which varies so that records end at
+//! different points relative to the end of the buffer.
+size_t recordLength(size_t index)
+{
+	return 1 + (index % 29);
+}
+
+//! A function object that pushes a sequence of values in batches of varying size.
+struct BatchProducer
+{
+	typedef void result_type;
+
+	explicit BatchProducer(Core::SpscRing<size_t>& ring)
+		: m_ring(&ring)
+	{
+	}
+
+	void operator()() const
+	{
+		size_t values[7];
+		size_t next = 0;
+
+		while (next != STREAM_LENGTH)
+		{
+			size_t count = 1 + (next % 7);
+
+			if (count > (STREAM_LENGTH - next))
+				count = STREAM_LENGTH - next;
+
+			for (size_t i = 0; i != count; ++i)
+				values[i] = next + i;
+
+			const size_t pushed = m_ring->pushBatch(values, count);
+
+			if (pushed == 0)
+				Core::yieldThread();
+
+			next += pushed;
+		}
+	}
+
+	Core::SpscRing<size_t>*	m_ring;
+};
+
+//! A function object that writes a sequence of variable-length records, each
+//! filled with its index, committing them in small groups.
+struct RecordProducer
+{
+	typedef void result_type;
+
+	explicit RecordProducer(Core::SpscByteRing& ring)
+		: m_ring(&ring)
+	{
+	}
+
+	void operator()() const
+	{
+		for (size_t i = 0; i != STREAM_LENGTH; ++i)
+		{
+			void* record = nullptr;
+
+			while ((record = m_ring->tryReserve(recordLength(i))) == nullptr)
+			{
+				m_ring->commit();
+				Core::yieldThread();
+			}
+
+			memset(record, static_cast<int>(i & 0xff), recordLength(i));
+
+			if ((i % 3) == 2)
+				m_ring->commit();
+		}
+
+		m_ring->commit();
+	}
+
+	Core::SpscByteRing*	m_ring;
+};
+
+}
+
+TEST_SET(SpscRing)
+{
+
+TEST_CASE("the capacity must be a power of two")
+{
+	TEST_THROWS(Core::SpscRing<int>(0));
+	TEST_THROWS(Core::SpscRing<int>(3));
+
+	Core::SpscRing<int> ring(4);
+
+	TEST_TRUE(ring.capacity() == 4);
+	TEST_TRUE(ring.empty());
+}
+TEST_CASE_END
+
+TEST_CASE("values are popped in the order they were pushed until the ring is empty")
+{
+	Core::SpscRing<int> ring(2);
+	int value = 0;
+
+	TEST_TRUE(ring.tryPush(1));
+	ring.push(2);
+	TEST_FALSE(ring.tryPush(3));
+	TEST_TRUE(ring.size() == 2);
+
+	TEST_TRUE(ring.tryPop(value) && (value == 1));
+	ring.pop(value);
+	TEST_TRUE(value == 2);
+	TEST_FALSE(ring.tryPop(value));
+}
+TEST_CASE_END
+
+TEST_CASE("a batch transfers as many values as there is space or data for")
+{
+	Core::SpscRing<int> ring(4);
+	const int input[] = { 1, 2, 3, 4, 5, 6 };
+	int output[6] = { 0 };
+
+	TEST_TRUE(ring.pushBatch(input, 6) == 4);
+	TEST_TRUE(ring.popBatch(output, 3) == 3);
+	TEST_TRUE(ring.pushBatch(input+4, 2) == 2);
+	TEST_TRUE(ring.popBatch(output+3, 6) == 3);
+
+	TEST_TRUE((output[0] == 1) && (output[2] == 3) && (output[3] == 4) && (output[5] == 6));
+	TEST_TRUE(ring.empty());
+}
+TEST_CASE_END
+
+TEST_CASE("values streamed in batches between threads arrive in order")
+{
+	Core::ThreadPool pool(1);
+	Core::SpscRing<size_t> ring(16);
+
+	Core::Future<void> producer = pool.submit(BatchProducer(ring));
+
+	size_t values[5];
+	size_t expected = 0;
+	bool   inOrder = true;
+
+	while (expected != STREAM_LENGTH)
+	{
+		const size_t popped = ring.popBatch(values, 5);
+
+		if (popped == 0)
+			Core::yieldThread();
+
+		for (size_t i = 0; i != popped; ++i)
+			inOrder &= (values[i] == expected++);
+	}
+
+	producer.get();
+
+	TEST_TRUE(inOrder);
+	TEST_TRUE(ring.empty());
+}
+TEST_CASE_END
+
+TEST_CASE("values left in the ring are destroyed with it")
+{
+	{
+		Core::SpscRing<Counted> ring(4);
+		Counted value;
+
+		ring.push(value);
+		ring.push(value);
+
+		TEST_TRUE(Counted::s_instances == 3);
+	}
+
+	TEST_TRUE(Counted::s_instances == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("byte ring records are read back in place with their length")
+{
+	Core::SpscByteRing ring(64);
+	size_t bytes = 0;
+
+	TEST_TRUE(ring.tryPeek(bytes) == nullptr);
+
+	TEST_TRUE(ring.tryWrite("hello", 5));
+	TEST_TRUE(ring.tryWrite("world!", 6));
+
+	const void* record = ring.tryPeek(bytes);
+
+	TEST_TRUE((bytes == 5) && (memcmp(record, "hello", 5) == 0));
+	ring.release();
+
+	record = ring.tryPeek(bytes);
+
+	TEST_TRUE((bytes == 6) && (memcmp(record, "world!", 6) == 0));
+	ring.release();
+
+	TEST_TRUE(ring.empty());
+}
+TEST_CASE_END
+
+TEST_CASE("byte ring records are only visible once committed")
+{
+	Core::SpscByteRing ring(64);
+	size_t bytes = 0;
+
+	TEST_TRUE(ring.tryReserve(4) != nullptr);
+	TEST_TRUE(ring.tryReserve(4) != nullptr);
+	TEST_TRUE(ring.tryPeek(bytes) == nullptr);
+
+	ring.commit();
+
+	TEST_TRUE(ring.tryPeek(bytes) != nullptr);
+	ring.release();
+	TEST_TRUE(ring.tryPeek(bytes) != nullptr);
+	ring.release();
+	TEST_TRUE(ring.tryPeek(bytes) == nullptr);
+}
+TEST_CASE_END
+
+TEST_CASE("byte ring records that would straddle the end of the buffer start again at the beginning")
+{
+	Core::SpscByteRing ring(64);
+	char   record[16] = { 0 };
+	size_t bytes = 0;
+	bool   intact = true;
+
+	for (int i = 0; i != 20; ++i)
+	{
+		memset(record, i, sizeof(record));
+
+		intact &= ring.tryWrite(record, sizeof(record));
+
+		const char* read = static_cast<const char*>(ring.tryPeek(bytes));
+
+		intact &= ((bytes == sizeof(record)) && (memcmp(read, record, bytes) == 0));
+		ring.release();
+	}
+
+	TEST_TRUE(intact);
+}
+TEST_CASE_END
+
+TEST_CASE("byte ring records streamed between threads arrive intact and in order")
+{
+	Core::ThreadPool pool(1);
+	Core::SpscByteRing ring(256);
+
+	Core::Future<void> producer = pool.submit(RecordProducer(ring));
+
+	bool intact = true;
+
+	for (size_t i = 0; i != STREAM_LENGTH; ++i)
+	{
+		const char* record = nullptr;
+		size_t      bytes = 0;
+
+		while ((record = static_cast<const char*>(ring.tryPeek(bytes))) == nullptr)
+			Core::yieldThread();
+
+		intact &= (bytes == recordLength(i));
+
+		for (size_t j = 0; j != bytes; ++j)
+			intact &= (record[j] == static_cast<char>(i & 0xff));
+
+		ring.release();
+	}
+
+	producer.get();
+
+	TEST_TRUE(intact);
+	TEST_TRUE(ring.empty());
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
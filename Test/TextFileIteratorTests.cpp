@@ -28,6 +28,16 @@ static void createTestTextFile(const tstring& path)
 	testFile.close();
 }
 
+static void createMultiLineFile(const tstring& path, size_t lines)
+{
+	std::ofstream testFile(T2A(path), std::ios::out | std::ios::binary);
+
+	for (size_t i = 0; i != lines; ++i)
+		testFile << "line " << i << ((i % 2) ? "\r\n" : "\n");
+
+	testFile.close();
+}
+
 TEST_SET(TextFileIterator)
 {
 	tstring testEmptyFile = Core::combinePaths(Core::getTempFolder(), TXT("core_empty_test_file.txt"));
@@ -38,6 +48,11 @@ TEST_SET(TextFileIterator)
 
 	createTestTextFile(testTextFile);
 
+	const size_t numLines = 20000;
+	tstring testLargeFile = Core::combinePaths(Core::getTempFolder(), TXT("core_test_large_file.txt"));
+
+	createMultiLineFile(testLargeFile, numLines);
+
 TEST_CASE("parameterless ctor creates an end iterator")
 {
 	Core::TextFileIterator end;
@@ -129,9 +144,28 @@ TEST_CASE("opening an empty file should set the iterator to the end")
 
 	TEST_TRUE(it == end);
 }
+TEST_CASE_END
+
+TEST_CASE("iterating a file larger than a block returns every line without its terminator")
+{
+	Core::TextFileIterator end;
+	Core::TextFileIterator it(testLargeFile);
+	size_t                 count = 0;
+	bool                   matched = true;
+
+	for (; it != end; ++it, ++count)
+	{
+		if (*it != Core::fmt(TXT("line %u"), static_cast<uint>(count)))
+			matched = false;
+	}
+
+	TEST_TRUE(count == numLines);
+	TEST_TRUE(matched);
+}
 TEST_CASE_END
 
 	Core::deleteFile(testEmptyFile, true);
+	Core::deleteFile(testLargeFile, true);
 	Core::deleteFile(testTextFile, true);
 }
 TEST_SET_END
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   TextLineParserTests.cpp
+//! \brief  The unit tests for the TextLineParser class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/TextLineParser.hpp>
+
+static void append(Core::TextLineParser& parser, const char* text)
+{
+	parser.append(text, text + strlen(text));
+}
+
+TEST_SET(TextLineParser)
+{
+
+TEST_CASE("an empty parser has no lines")
+{
+	Core::TextLineParser parser;
+	std::string          line;
+
+	TEST_FALSE(parser.nextLine(line));
+	TEST_FALSE(parser.finished());
+	TEST_TRUE(parser.pending() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a line is only returned once its terminator has been appended")
+{
+	Core::TextLineParser parser;
+	std::string          line;
+
+	append(parser, "hello ");
+
+	TEST_FALSE(parser.nextLine(line));
+
+	append(parser, "world\nnext");
+
+	TEST_TRUE(parser.nextLine(line) && (line == "hello world"));
+	TEST_FALSE(parser.nextLine(line));
+	TEST_TRUE(parser.pending() == 4);
+}
+TEST_CASE_END
+
+TEST_CASE("both LF and CR/LF line terminators are stripped")
+{
+	Core::TextLineParser parser;
+	std::string          line;
+
+	append(parser, "unix\ndos\r");
+	append(parser, "\n\nlast\r\n");
+
+	TEST_TRUE(parser.nextLine(line) && (line == "unix"));
+	TEST_TRUE(parser.nextLine(line) && (line == "dos"));
+	TEST_TRUE(parser.nextLine(line) && line.empty());
+	TEST_TRUE(parser.nextLine(line) && (line == "last"));
+	TEST_FALSE(parser.nextLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("unterminated trailing text is returned once the end is signalled")
+{
+	Core::TextLineParser parser;
+	std::string          line;
+
+	append(parser, "first\nsecond");
+
+	TEST_TRUE(parser.nextLine(line) && (line == "first"));
+	TEST_FALSE(parser.nextLine(line));
+
+	parser.finish();
+
+	TEST_TRUE(parser.finished());
+	TEST_TRUE(parser.nextLine(line) && (line == "second"));
+	TEST_FALSE(parser.nextLine(line));
+}
+TEST_CASE_END
+
+TEST_CASE("appending after the end has been signalled throws an exception")
+{
+	Core::TextLineParser parser;
+
+	parser.finish();
+
+	TEST_THROWS(append(parser, "text"));
+}
+TEST_CASE_END
+
+TEST_CASE("lines split across many small blocks are reassembled")
+{
+	Core::TextLineParser parser;
+	std::string          line;
+	const char*          text = "alpha\r\nbeta\ngamma\r\n";
+	size_t               count = 0;
+
+	for (const char* it = text; *it != '\0'; ++it)
+	{
+		parser.append(it, it+1);
+
+		while (parser.nextLine(line))
+			++count;
+	}
+
+	TEST_TRUE(count == 3);
+	TEST_TRUE(line == "gamma");
+	TEST_TRUE(parser.pending() == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("reset discards any buffered text")
+{
+	Core::TextLineParser parser;
+	std::string          line;
+
+	append(parser, "partial");
+	parser.finish();
+	parser.reset();
+
+	TEST_FALSE(parser.finished());
+	TEST_TRUE(parser.pending() == 0);
+	TEST_FALSE(parser.nextLine(line));
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,191 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ThreadPoolTests.cpp
+//! \brief  The unit tests for the ThreadPool and Future classes.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/ThreadPool.hpp>
+#include <Core/InvalidArgException.hpp>
+#include <vector>
+
+namespace
+{
+
+//! A function object that returns a fixed value.
+struct Answer
+{
+	typedef int result_type;
+
+	int operator()() const
+	{
+		return 42;
+	}
+};
+
+//! A function object that adds one to a shared counter.
+struct Increment
+{
+	typedef void result_type;
+
+	explicit Increment(long& counter)
+		: m_counter(&counter)
+	{
+	}
+
+	void operator()() const
+	{
+		Core::atomicFetchAdd(*m_counter, 1L);
+	}
+
+	long*	m_counter;
+};
+
+//! A function that throws.
+int throwError()
+{
+	throw Core::InvalidArgException(TXT("Test Exception"));
+}
+
+//! A loop body that counts the visits to each index.
+struct CountVisits
+{
+	explicit CountVisits(std::vector<int>& visits)
+		: m_visits(&visits)
+	{
+	}
+
+	void operator()(size_t first, size_t last) const
+	{
+		for (size_t i = first; i != last; ++i)
+			++(*m_visits)[i];
+	}
+
+	std::vector<int>*	m_visits;
+};
+
+//! A loop body that throws for one index.
+struct ThrowAt
+{
+	void operator()(size_t first, size_t last) const
+	{
+		if ((first <= 500) && (500 < last))
+			throw Core::InvalidArgException(TXT("Test Exception"));
+	}
+};
+
+//! A reduction body that sums the indices.
+size_t sumIndices(size_t first, size_t last)
+{
+	size_t sum = 0;
+
+	for (size_t i = first; i != last; ++i)
+		sum += i;
+
+	return sum;
+}
+
+//! A reduction that adds two results.
+size_t add(size_t lhs, size_t rhs)
+{
+	return lhs + rhs;
+}
+
+}
+
+TEST_SET(ThreadPool)
+{
+
+TEST_CASE("the pool has one thread per processor unless told otherwise")
+{
+	Core::ThreadPool defaultPool;
+
+	TEST_TRUE(defaultPool.threads() != 0);
+
+	Core::ThreadPool pool(3);
+
+	TEST_TRUE(pool.threads() == 3);
+}
+TEST_CASE_END
+
+TEST_CASE("an invalid NUMA node is rejected")
+{
+	TEST_THROWS(Core::ThreadPool(1, Core::ThreadPool::DEFAULT, -2));
+}
+TEST_CASE_END
+
+TEST_CASE("a future returns the result of the submitted function")
+{
+	Core::ThreadPool pool(2);
+
+	Core::Future<int> future = pool.submit(Answer());
+
+	TEST_TRUE(future.valid());
+	TEST_TRUE(future.get() == 42);
+	TEST_TRUE(future.ready());
+}
+TEST_CASE_END
+
+TEST_CASE("a future rethrows the exception thrown by the submitted function")
+{
+	Core::ThreadPool pool(2);
+
+	Core::Future<int> future = pool.submit(throwError);
+
+	TEST_THROWS(future.get());
+}
+TEST_CASE_END
+
+TEST_CASE("the tasks still queued are run before the pool is destroyed")
+{
+	long counter = 0;
+
+	{
+		Core::ThreadPool pool(2);
+
+		for (int i = 0; i != 100; ++i)
+			pool.submit(Increment(counter));
+	}
+
+	TEST_TRUE(counter == 100);
+}
+TEST_CASE_END
+
+TEST_CASE("a parallel loop visits every index exactly once")
+{
+	Core::ThreadPool pool(4);
+	std::vector<int> visits(10000, 0);
+
+	pool.parallelFor(0, visits.size(), CountVisits(visits));
+	pool.parallelFor(0, visits.size(), CountVisits(visits), 7);
+
+	size_t twice = 0;
+
+	for (size_t i = 0; i != visits.size(); ++i)
+		twice += (visits[i] == 2) ? 1 : 0;
+
+	TEST_TRUE(twice == visits.size());
+}
+TEST_CASE_END
+
+TEST_CASE("a parallel loop rethrows the exception thrown by the body")
+{
+	Core::ThreadPool pool(2);
+
+	TEST_THROWS(pool.parallelFor(0, 1000, ThrowAt(), 10));
+}
+TEST_CASE_END
+
+TEST_CASE("a parallel reduction combines the results of every chunk")
+{
+	Core::ThreadPool pool(4);
+
+	const size_t sum = pool.parallelReduce(0, 10001, size_t(0), sumIndices, add);
+
+	TEST_TRUE(sum == 50005000);
+	TEST_TRUE(pool.parallelReduce(5, 5, size_t(7), sumIndices, add) == 7);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ThreadRecordsTests.cpp
+//! \brief  The unit tests for the ThreadRecords class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/ThreadRecords.hpp>
+#include <Core/ThreadPool.hpp>
+#include <Core/Event.hpp>
+
+namespace
+{
+
+//! A loop body that takes the record for each index's thread.
+struct TakeRecords
+{
+	explicit TakeRecords(Core::ThreadRecords& records)
+		: m_records(&records)
+	{
+	}
+
+	void operator()(size_t first, size_t last) const
+	{
+		for (size_t i = first; i != last; ++i)
+			m_records->threadRecord<Core::ThreadRecord>();
+	}
+
+	Core::ThreadRecords*	m_records;
+};
+
+//! A record that counts the number of times it has been reset.
+struct CountingRecord : public Core::ThreadRecord
+{
+	CountingRecord()
+		: m_resets(0)
+	{
+	}
+
+	virtual void reset()
+	{
+		++m_resets;
+	}
+
+	int	m_resets;
+};
+
+//! A function object that takes a counting record for its thread.
+struct TakeCountingRecord
+{
+	typedef void result_type;
+
+	TakeCountingRecord(Core::ThreadRecords& records, Core::Event& done)
+		: m_records(&records)
+		, m_done(&done)
+	{
+	}
+
+	void operator()() const
+	{
+		m_records->threadRecord<CountingRecord>();
+		m_done->set();
+	}
+
+	Core::ThreadRecords*	m_records;
+	Core::Event*			m_done;
+};
+
+}
+
+TEST_SET(ThreadRecords)
+{
+
+TEST_CASE("a thread gets the same record on every call")
+{
+	Core::ThreadRecords records;
+
+	TEST_TRUE(records.count() == 0);
+	TEST_TRUE(records.first<Core::ThreadRecord>() == nullptr);
+
+	Core::ThreadRecord* record = records.threadRecord<Core::ThreadRecord>();
+
+	TEST_TRUE(record != nullptr);
+	TEST_TRUE(records.threadRecord<Core::ThreadRecord>() == record);
+	TEST_TRUE(records.count() == 1);
+	TEST_TRUE(records.first<Core::ThreadRecord>() == record);
+	TEST_TRUE(Core::ThreadRecords::next(record) == nullptr);
+}
+TEST_CASE_END
+
+TEST_CASE("a thread gets a different record from each list")
+{
+	Core::ThreadRecords first;
+	Core::ThreadRecords second;
+
+	Core::ThreadRecord* record = first.threadRecord<Core::ThreadRecord>();
+
+	TEST_TRUE(second.threadRecord<Core::ThreadRecord>() != record);
+	TEST_TRUE(first.threadRecord<Core::ThreadRecord>() == record);
+}
+TEST_CASE_END
+
+TEST_CASE("a record is still found when there are more lists than cached slots")
+{
+	const size_t count = Core::ThreadRecords::MAX_CACHED + 2;
+
+	Core::ThreadRecords* lists = new Core::ThreadRecords[count];
+
+	for (size_t i = 0; i != count; ++i)
+	{
+		Core::ThreadRecord* record = lists[i].threadRecord<Core::ThreadRecord>();
+
+		TEST_TRUE(lists[i].threadRecord<Core::ThreadRecord>() == record);
+		TEST_TRUE(lists[i].count() == 1);
+	}
+
+	delete[] lists;
+}
+TEST_CASE_END
+
+TEST_CASE("the records of threads that have exited are reused")
+{
+	const size_t threads = 2;
+	const size_t rounds = 10;
+
+	Core::ThreadRecords records;
+
+	for (size_t i = 0; i != rounds; ++i)
+	{
+		Core::ThreadPool pool(threads);
+
+		pool.parallelFor(0, 1000, TakeRecords(records), 10);
+	}
+
+	TEST_TRUE(records.count() != 0);
+	TEST_TRUE(records.count() <= threads+1);
+}
+TEST_CASE_END
+
+TEST_CASE("a record is reset before it's handed to another thread")
+{
+	Core::ThreadRecords records;
+	Core::Event done;
+
+	{
+		Core::ThreadPool pool(1);
+
+		pool.submit(TakeCountingRecord(records, done));
+		done.wait();
+	}
+
+	CountingRecord* record = records.first<CountingRecord>();
+
+	TEST_TRUE(records.count() == 1);
+	TEST_TRUE(record->m_resets == 0);
+	TEST_TRUE(records.threadRecord<CountingRecord>() == record);
+	TEST_TRUE(record->m_resets == 1);
+	TEST_TRUE(records.threadRecord<CountingRecord>() == record);
+	TEST_TRUE(record->m_resets == 1);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
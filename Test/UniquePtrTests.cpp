@@ -6,6 +6,8 @@
 #include "Common.hpp"
 #include <Core/UnitTest.hpp>
 #include <Core/UniquePtr.hpp>
+#include <utility>
+#include <vector>
 #include "PtrTest.hpp"
 
 TEST_SET(UniquePtr)
@@ -192,5 +194,35 @@ TEST_CASE("the pointer is not empty when it owns something")
 }
 TEST_CASE_END
 
+#ifdef CORE_HAS_RVALUE_REFS
+TEST_CASE("moving a pointer transfers ownership and leaves the source empty")
+{
+	PtrTest* expected = new PtrTest;
+	TestPtr  source(expected);
+	TestPtr  test(std::move(source));
+
+	TEST_TRUE(test.get() == expected);
+	TEST_TRUE(source.get() == nullptr);
+
+	source = std::move(test);
+
+	TEST_TRUE(source.get() == expected);
+	TEST_TRUE(test.get() == nullptr);
+}
+TEST_CASE_END
+
+TEST_CASE("pointers can be stored in a standard container")
+{
+	std::vector<TestPtr> pointers;
+
+	for (int i = 0; i != 100; ++i)
+		pointers.push_back(TestPtr(new PtrTest));
+
+	TEST_TRUE(pointers.size() == 100);
+	TEST_TRUE(pointers.back()->run());
+}
+TEST_CASE_END
+#endif
+
 }
 TEST_SET_END
@@ -0,0 +1,191 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   UtfTests.cpp
+//! \brief  The unit tests for the UTF transcoding functions.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/Utf.hpp>
+#include <vector>
+
+TEST_SET(Utf)
+{
+	// "Aé€😀" - 1, 2, 3 and 4 byte sequences.
+	const char            utf8[]  = "A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80";
+	const Core::utf16char utf16[] = { 0x0041, 0x00E9, 0x20AC, 0xD83D, 0xDE00 };
+	const Core::utf32char utf32[] = { 0x0041, 0x00E9, 0x20AC, 0x1F600 };
+
+	const char* utf8End = utf8 + strlen(utf8);
+
+TEST_CASE("valid UTF-8 passes validation")
+{
+	const Core::UtfResult result = Core::validateUtf8(utf8, utf8End);
+
+	TEST_TRUE(result.status == Core::UTF_OK);
+	TEST_TRUE(result.consumed == strlen(utf8));
+}
+TEST_CASE_END
+
+TEST_CASE("invalid UTF-8 sequences are reported with their byte position")
+{
+	const char* invalid[] =
+	{
+		"abc\x80",				// Lone continuation byte.
+		"abc\xC0\xAF",			// Overlong encoding.
+		"abc\xED\xA0\x80",		// Encoded surrogate.
+		"abc\xF4\x90\x80\x80",	// Beyond U+10FFFF.
+		"abc\xE2\x28\xA1",		// Bad continuation byte.
+		"abc\xFF",				// Invalid lead byte.
+	};
+
+	for (size_t i = 0; i != ARRAY_SIZE(invalid); ++i)
+	{
+		const Core::UtfResult result = Core::validateUtf8(invalid[i], invalid[i] + strlen(invalid[i]));
+
+		TEST_TRUE(result.status == Core::UTF_INVALID);
+		TEST_TRUE(result.consumed == 3);
+	}
+}
+TEST_CASE_END
+
+TEST_CASE("an invalid sequence after a long run of ASCII is found at the right position")
+{
+	std::string text(100, 'x');
+
+	text += "\xC3\xA9";
+	text += std::string(37, 'y');
+	text += '\x80';
+
+	const Core::UtfResult result = Core::validateUtf8(text.data(), text.data() + text.size());
+
+	TEST_TRUE(result.status == Core::UTF_INVALID);
+	TEST_TRUE(result.consumed == 139);
+}
+TEST_CASE_END
+
+TEST_CASE("a sequence truncated by the end of the input is reported as incomplete")
+{
+	const Core::UtfResult result = Core::validateUtf8(utf8, utf8End - 1);
+
+	TEST_TRUE(result.status == Core::UTF_INCOMPLETE);
+	TEST_TRUE(result.consumed == 6);
+}
+TEST_CASE_END
+
+TEST_CASE("the output size can be calculated before converting")
+{
+	std::string text;
+
+	for (size_t i = 0; i != 10; ++i)
+		text += utf8;
+
+	const char* begin = text.data();
+	const char* end   = begin + text.size();
+
+	TEST_TRUE(Core::utf16Length(utf8, utf8End) == ARRAY_SIZE(utf16));
+	TEST_TRUE(Core::utf32Length(utf8, utf8End) == ARRAY_SIZE(utf32));
+	TEST_TRUE(Core::utf16Length(begin, end) == 10 * ARRAY_SIZE(utf16));
+	TEST_TRUE(Core::utf32Length(begin, end) == 10 * ARRAY_SIZE(utf32));
+	TEST_TRUE(Core::utf8Length(utf16, utf16 + ARRAY_SIZE(utf16)) == strlen(utf8));
+	TEST_TRUE(Core::utf8Length(utf32, utf32 + ARRAY_SIZE(utf32)) == strlen(utf8));
+}
+TEST_CASE_END
+
+TEST_CASE("UTF-8 converts to UTF-16 and UTF-32")
+{
+	Core::utf16char output16[16];
+	Core::utf32char output32[16];
+
+	const Core::UtfResult result16 = Core::utf8ToUtf16(utf8, utf8End, output16, ARRAY_SIZE(output16));
+	const Core::UtfResult result32 = Core::utf8ToUtf32(utf8, utf8End, output32, ARRAY_SIZE(output32));
+
+	TEST_TRUE(result16.status == Core::UTF_OK);
+	TEST_TRUE(result16.written == ARRAY_SIZE(utf16));
+	TEST_TRUE(std::equal(utf16, utf16 + ARRAY_SIZE(utf16), output16));
+	TEST_TRUE(result32.status == Core::UTF_OK);
+	TEST_TRUE(result32.written == ARRAY_SIZE(utf32));
+	TEST_TRUE(std::equal(utf32, utf32 + ARRAY_SIZE(utf32), output32));
+}
+TEST_CASE_END
+
+TEST_CASE("UTF-16 and UTF-32 convert to UTF-8")
+{
+	char output[16];
+
+	const Core::UtfResult result16 = Core::utf16ToUtf8(utf16, utf16 + ARRAY_SIZE(utf16), output, ARRAY_SIZE(output));
+
+	TEST_TRUE(result16.status == Core::UTF_OK);
+	TEST_TRUE(std::string(output, result16.written) == utf8);
+
+	const Core::UtfResult result32 = Core::utf32ToUtf8(utf32, utf32 + ARRAY_SIZE(utf32), output, ARRAY_SIZE(output));
+
+	TEST_TRUE(result32.status == Core::UTF_OK);
+	TEST_TRUE(std::string(output, result32.written) == utf8);
+}
+TEST_CASE_END
+
+TEST_CASE("unpaired surrogates and out of range code points are invalid")
+{
+	const Core::utf16char lone[] = { 0x0041, 0xDE00, 0x0042 };
+	const Core::utf16char lead[] = { 0x0041, 0xD83D };
+	const Core::utf32char high[] = { 0x0041, 0x110000 };
+	char                  output[16];
+
+	const Core::UtfResult loneResult = Core::utf16ToUtf8(lone, lone + ARRAY_SIZE(lone), output, ARRAY_SIZE(output));
+	const Core::UtfResult leadResult = Core::utf16ToUtf8(lead, lead + ARRAY_SIZE(lead), output, ARRAY_SIZE(output));
+	const Core::UtfResult highResult = Core::utf32ToUtf8(high, high + ARRAY_SIZE(high), output, ARRAY_SIZE(output));
+
+	TEST_TRUE((loneResult.status == Core::UTF_INVALID) && (loneResult.consumed == 1) && (loneResult.written == 1));
+	TEST_TRUE((leadResult.status == Core::UTF_INCOMPLETE) && (leadResult.consumed == 1));
+	TEST_TRUE((highResult.status == Core::UTF_INVALID) && (highResult.consumed == 1));
+	TEST_TRUE(Core::validateUtf16(lone, lone + ARRAY_SIZE(lone)).status == Core::UTF_INVALID);
+	TEST_TRUE(Core::validateUtf16(utf16, utf16 + ARRAY_SIZE(utf16)).status == Core::UTF_OK);
+}
+TEST_CASE_END
+
+TEST_CASE("conversion stops before a character that does not fit in the output")
+{
+	Core::utf16char output16[4];
+	char            output8[5];
+
+	const Core::UtfResult result16 = Core::utf8ToUtf16(utf8, utf8End, output16, ARRAY_SIZE(output16));
+
+	TEST_TRUE(result16.status == Core::UTF_OUTPUT_FULL);
+	TEST_TRUE(result16.consumed == 6);
+	TEST_TRUE(result16.written == 3);
+
+	const Core::UtfResult result8 = Core::utf16ToUtf8(utf16, utf16 + ARRAY_SIZE(utf16), output8, ARRAY_SIZE(output8));
+
+	TEST_TRUE(result8.status == Core::UTF_OUTPUT_FULL);
+	TEST_TRUE(result8.consumed == 2);
+	TEST_TRUE(result8.written == 3);
+}
+TEST_CASE_END
+
+TEST_CASE("wide strings round trip through UTF-8")
+{
+	std::string text(50, 'a');
+
+	text += utf8;
+	text += std::string(50, 'b');
+
+	const std::wstring wide = Core::utf8ToWide(text);
+
+	TEST_TRUE(wide.size() == 100 + ((sizeof(wchar_t) == 2) ? ARRAY_SIZE(utf16) : ARRAY_SIZE(utf32)));
+	TEST_TRUE(wide[50] == L'A');
+	TEST_TRUE(wide[51] == static_cast<wchar_t>(0xE9));
+	TEST_TRUE(Core::wideToUtf8(wide) == text);
+	TEST_TRUE(Core::utf8ToWide(std::string()).empty());
+	TEST_TRUE(Core::wideToUtf8(std::wstring()).empty());
+}
+TEST_CASE_END
+
+TEST_CASE("converting invalid UTF-8 to a wide string throws an exception")
+{
+	TEST_THROWS(Core::utf8ToWide(std::string("abc\xFF")));
+	TEST_THROWS(Core::utf8ToWide(std::string("abc\xC3")));
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   WeakPtrTests.cpp
+//! \brief  The unit tests for the WeakPtr class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/WeakPtr.hpp>
+#include "PtrTest.hpp"
+
+namespace
+{
+
+class Node
+{
+public:
+	Node()
+	{
+		++s_instances;
+	}
+
+	~Node()
+	{
+		--s_instances;
+	}
+
+	Core::SharedPtr<Node>	m_child;
+	Core::WeakPtr<Node>		m_parent;
+
+	static int s_instances;
+};
+
+int Node::s_instances = 0;
+
+}
+
+TEST_SET(WeakPtr)
+{
+	typedef Core::SharedPtr<PtrTest> TestPtr;
+	typedef Core::WeakPtr<PtrTest> WeakTestPtr;
+	typedef Core::SharedPtr<Derived> DerivedPtr;
+
+TEST_CASE("initial state is expired")
+{
+	WeakTestPtr test;
+
+	TEST_TRUE(test.expired());
+	TEST_TRUE(test.lock().get() == nullptr);
+}
+TEST_CASE_END
+
+TEST_CASE("lock returns the object whilst a strong reference exists")
+{
+	TestPtr     strong(new PtrTest);
+	WeakTestPtr test(strong);
+
+	TEST_FALSE(test.expired());
+	TEST_TRUE(test.lock().get() == strong.get());
+}
+TEST_CASE_END
+
+TEST_CASE("the pointer expires when the last strong reference is released")
+{
+	TestPtr     strong(new PtrTest);
+	WeakTestPtr test(strong);
+	WeakTestPtr copy(test);
+
+	strong.reset();
+
+	TEST_TRUE(test.expired());
+	TEST_TRUE(copy.expired());
+	TEST_TRUE(test.lock().get() == nullptr);
+}
+TEST_CASE_END
+
+TEST_CASE("a locked pointer keeps the object alive")
+{
+	Core::SharedPtr<Node> strong = Core::makeShared<Node>();
+	Core::WeakPtr<Node>   test(strong);
+	Core::SharedPtr<Node> locked = test.lock();
+
+	strong.reset();
+
+	TEST_FALSE(test.expired());
+	TEST_TRUE(Node::s_instances == 1);
+
+	locked.reset();
+
+	TEST_TRUE(test.expired());
+	TEST_TRUE(Node::s_instances == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a weak back reference does not cause a cycle")
+{
+	{
+		Core::SharedPtr<Node> parent = Core::makeShared<Node>();
+
+		parent->m_child = Core::makeShared<Node>();
+		parent->m_child->m_parent = parent;
+
+		TEST_TRUE(parent->m_child->m_parent.lock().get() == parent.get());
+		TEST_TRUE(Node::s_instances == 2);
+	}
+
+	TEST_TRUE(Node::s_instances == 0);
+}
+TEST_CASE_END
+
+TEST_CASE("a pointer can be converted to a base type")
+{
+	DerivedPtr  derived(new Derived);
+	WeakTestPtr test(derived);
+
+	Core::WeakPtr<Derived> weakDerived(derived);
+	WeakTestPtr            base(weakDerived);
+
+	TEST_TRUE(test.lock().get() == derived.get());
+	TEST_TRUE(base.lock().get() == derived.get());
+
+	test = derived;
+	base = weakDerived;
+
+	TEST_TRUE(test.lock().get() == derived.get());
+	TEST_TRUE(base.lock().get() == derived.get());
+}
+TEST_CASE_END
+
+TEST_CASE("reset stops observing the object")
+{
+	TestPtr     strong(new PtrTest);
+	WeakTestPtr test(strong);
+
+	test = test;
+	test.reset();
+
+	TEST_TRUE(test.expired());
+	TEST_TRUE(strong.get() != nullptr);
+}
+TEST_CASE_END
+
+TEST_CASE("a thread-confined pointer can be observed")
+{
+	Core::SharedPtr<PtrTest, Core::LocalCount> strong = Core::makeLocalShared<PtrTest>();
+	Core::WeakPtr<PtrTest, Core::LocalCount>   test(strong);
+
+	TEST_TRUE(test.lock().get() == strong.get());
+
+	strong.reset();
+
+	TEST_TRUE(test.expired());
+	TEST_TRUE(test.lock().get() == nullptr);
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -0,0 +1,190 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   WorkStealingDequeTests.cpp
+//! \brief  The unit tests for the WorkStealingDeque class.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include <Core/UnitTest.hpp>
+#include <Core/WorkStealingDeque.hpp>
+#include <Core/ThreadPool.hpp>
+#include <Core/ThreadUtils.hpp>
+#include <vector>
+
+namespace
+{
+
+//! The deque of counters, one per item, that are incremented when taken.
+typedef Core::WorkStealingDeque<long> CounterDeque;
+
+//! A function object that steals items until told to stop, returning the
+//! number it took.
+struct Thief
+{
+	typedef size_t result_type;
+
+	Thief(CounterDeque& deque, const long& stop)
+		: m_deque(&deque)
+		, m_stop(&stop)
+	{
+	}
+
+	size_t operator()() const
+	{
+		size_t taken = 0;
+
+		while (Core::atomicLoad(*m_stop) == 0)
+		{
+			long* item = m_deque->steal();
+
+			if (item != nullptr)
+			{
+				Core::atomicFetchAdd(*item, 1L);
+				++taken;
+			}
+			else
+			{
+				Core::yieldThread();
+			}
+		}
+
+		return taken;
+	}
+
+	CounterDeque*	m_deque;
+	const long*		m_stop;
+};
+
+}
+
+TEST_SET(WorkStealingDeque)
+{
+	typedef Core::WorkStealingDeque<int> Deque;
+
+TEST_CASE("the capacity must be a power of two")
+{
+	TEST_THROWS(Deque(0));
+	TEST_THROWS(Deque(12));
+
+	Deque deque;
+
+	TEST_TRUE(deque.empty());
+}
+TEST_CASE_END
+
+TEST_CASE("the owner pops the newest item and a thief steals the oldest")
+{
+	Deque deque;
+	int   items[3] = { 1, 2, 3 };
+
+	deque.push(&items[0]);
+	deque.push(&items[1]);
+	deque.push(&items[2]);
+
+	TEST_TRUE(deque.size() == 3);
+	TEST_TRUE(deque.pop() == &items[2]);
+	TEST_TRUE(deque.steal() == &items[0]);
+	TEST_TRUE(deque.pop() == &items[1]);
+}
+TEST_CASE_END
+
+TEST_CASE("popping or stealing from an empty deque returns null")
+{
+	Deque deque;
+	int   item = 0;
+
+	TEST_TRUE(deque.pop() == nullptr);
+	TEST_TRUE(deque.steal() == nullptr);
+
+	deque.push(&item);
+
+	TEST_TRUE(deque.steal() == &item);
+	TEST_TRUE(deque.pop() == nullptr);
+	TEST_TRUE(deque.empty());
+}
+TEST_CASE_END
+
+TEST_CASE("the deque grows when it's full without losing any items")
+{
+	Deque deque(2);
+	int   items[10] = { 0 };
+	bool  inOrder = true;
+
+	deque.push(&items[0]);
+	TEST_TRUE(deque.steal() == &items[0]);
+
+	for (int i = 0; i != 10; ++i)
+		deque.push(&items[i]);
+
+	TEST_TRUE(deque.size() == 10);
+
+	for (int i = 9; i != -1; --i)
+		inOrder &= (deque.pop() == &items[i]);
+
+	TEST_TRUE(inOrder);
+}
+TEST_CASE_END
+
+TEST_CASE("every item is taken exactly once when the owner competes with thieves")
+{
+	const size_t items = 20000;
+	const size_t thieves = 3;
+
+	std::vector<long> counters(items, 0L);
+	CounterDeque      deque(2);
+	long              stop = 0;
+	size_t            popped = 0;
+	size_t            stolen = 0;
+
+	{
+		Core::ThreadPool pool(thieves);
+		std::vector< Core::Future<size_t> > results;
+
+		for (size_t i = 0; i != thieves; ++i)
+			results.push_back(pool.submit(Thief(deque, stop)));
+
+		for (size_t i = 0; i != items; ++i)
+		{
+			deque.push(&counters[i]);
+
+			// Pop often enough that the deque is regularly down to its last item,
+			// but not so often that it never needs to grow.
+			if ((i % 3) == 0)
+			{
+				long* item = deque.pop();
+
+				if (item != nullptr)
+				{
+					Core::atomicFetchAdd(*item, 1L);
+					++popped;
+				}
+			}
+
+			if ((i % 64) == 0)
+				Core::yieldThread();
+		}
+
+		for (long* item = deque.pop(); item != nullptr; item = deque.pop())
+		{
+			Core::atomicFetchAdd(*item, 1L);
+			++popped;
+		}
+
+		Core::atomicStore(stop, 1L);
+
+		for (size_t i = 0; i != thieves; ++i)
+			stolen += results[i].get();
+	}
+
+	bool once = true;
+
+	for (size_t i = 0; i != items; ++i)
+		once &= (counters[i] == 1);
+
+	TEST_TRUE(once);
+	TEST_TRUE(popped + stolen == items);
+	TEST_TRUE(deque.empty());
+}
+TEST_CASE_END
+
+}
+TEST_SET_END
@@ -19,6 +19,12 @@ namespace Core
 TextFileIterator::TextFileIterator()
 	: m_stream()
 	, m_value()
+	, m_parser()
+	, m_block()
+	, m_line()
+#ifdef UNICODE_BUILD
+	, m_converter()
+#endif
 {
 }
 
@@ -28,13 +34,20 @@ TextFileIterator::TextFileIterator()
 TextFileIterator::TextFileIterator(const tstring& filename)
 	: m_stream()
 	, m_value()
+	, m_parser()
+	, m_block()
+	, m_line()
+#ifdef UNICODE_BUILD
+	, m_converter()
+#endif
 {
-	m_stream.reset(new tifstream(T2A(filename)));
+	m_stream.reset(new std::ifstream(T2A(filename), std::ios::in | std::ios::binary));
 
 	if (!m_stream->is_open())
 		throw FileSystemException(Core::fmt(TXT("Failed to open file '%s'"), filename.c_str()));
 
 	m_value.reset(new tstring);
+	m_block.resize(BLOCK_SIZE);
 
 	increment();
 }
@@ -89,12 +102,83 @@ void TextFileIterator::increment()
 
 	ASSERT(m_value.get() != nullptr);
 
-	std::getline(*m_stream, *m_value);
+	while (!m_parser.nextLine(m_line))
+	{
+		if (m_parser.finished())
+		{
+			reset();
+			return;
+		}
+
+		readBlock();
+	}
+
+#ifdef ANSI_BUILD
+	m_value->swap(m_line);
+#else
+	convertLine();
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Read the next block from the file into the parser. When the end of the
+//! file is reached the parser is told that no more text will follow.
+
+void TextFileIterator::readBlock()
+{
+	ASSERT(m_stream.get() != nullptr);
+	ASSERT(!m_block.empty());
+
+	char* begin = &m_block[0];
+
+	m_stream->read(begin, static_cast<std::streamsize>(m_block.size()));
+
+	const size_t count = static_cast<size_t>(m_stream->gcount());
+
+	if (count != 0)
+		m_parser.append(begin, begin + count);
+
+	if (count != m_block.size())
+	{
+		if (m_stream->bad())
+			throw FileSystemException(TXT("Failed to read from file"));
+
+		m_parser.finish();
+	}
+}
 
-	if (!(*m_stream))
-		reset();
+#ifdef UNICODE_BUILD
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert the last line parsed into the current value. The conversion is done
+//! in place so that the storage of the previous value is reused.
+
+void TextFileIterator::convertLine()
+{
+	ASSERT(m_value.get() != nullptr);
+
+	m_value->resize(m_line.size());
+
+	if (m_line.empty())
+		return;
+
+	const char* begin   = m_line.data();
+	const char* end     = begin + m_line.size();
+	wchar_t*    first   = &(*m_value)[0];
+	wchar_t*    dest    = first;
+	wchar_t*    destEnd = first + m_value->size();
+
+	// A line never produces more characters than it has bytes.
+	bool converted = m_converter.convert(begin, end, dest, destEnd) && m_converter.flush(dest, destEnd);
+
+	ASSERT(converted);
+	DEBUG_USE_ONLY(converted);
+
+	m_value->resize(dest - first);
 }
 
+#endif // UNICODE_BUILD
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Move the iterator to the End.
 
@@ -102,6 +186,8 @@ void TextFileIterator::reset()
 {
 	m_stream.reset();
 	m_value.reset();
+	m_parser.reset();
+	Block().swap(m_block);
 }
 
 //namespace Core
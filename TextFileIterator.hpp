@@ -13,12 +13,17 @@
 
 #include "UniquePtr.hpp"
 #include "tfstream.hpp"
+#include "TextLineParser.hpp"
+#include "AnsiWideConverter.hpp"
+#include <vector>
 
 namespace Core
 {
 
 ////////////////////////////////////////////////////////////////////////////////
-//! The iterator type used to read lines of text from a file.
+//! The iterator type used to read lines of text from a file. The file is read
+//! in large blocks and split into lines by a TextLineParser, rather than a
+//! line at a time via the stream.
 
 class TextFileIterator
 {
@@ -52,17 +57,32 @@ public:
 	//! Compare to another iterator for equivalence.
 	bool equals(const TextFileIterator& rhs) const;
 
+	//
+	// Constants.
+	//
+
+	//! The size of the block read from the file.
+	static const size_t BLOCK_SIZE = 64 * 1024;
+
 private:
 	//! The underlying input file stream.
-	typedef UniquePtr<tifstream> StreamPtr;
+	typedef UniquePtr<std::ifstream> StreamPtr;
 	//! The current value;
 	typedef UniquePtr<tstring> StringPtr;
+	//! The buffer for reading blocks.
+	typedef std::vector<char> Block;
 
 	//
 	// Members.
 	//
-	StreamPtr	m_stream;	//!< The underlying file stream;
-	StringPtr	m_value;	//!< The current iterator value.
+	StreamPtr		m_stream;	//!< The underlying file stream;
+	StringPtr		m_value;	//!< The current iterator value.
+	TextLineParser	m_parser;	//!< The parser used to split blocks into lines.
+	Block			m_block;	//!< The buffer used to read the next block.
+	std::string		m_line;		//!< The last line parsed.
+#ifdef UNICODE_BUILD
+	AnsiToWideConverter	m_converter;	//!< The converter used for each line.
+#endif
 
 	//
 	// Internal methods.
@@ -71,6 +91,14 @@ private:
 	//! Move the iterator forward.
 	void increment();
 
+	//! Read the next block from the file into the parser.
+	void readBlock();
+
+#ifdef UNICODE_BUILD
+	//! Convert the last line parsed into the current value.
+	void convertLine();
+#endif
+
 	//! Move the iterator to the End.
 	void reset();
 };
@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   TextLineParser.cpp
+//! \brief  The TextLineParser class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "TextLineParser.hpp"
+#include "BadLogicException.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+TextLineParser::TextLineParser()
+	: m_buffer()
+	, m_start(0)
+	, m_scanned(0)
+	, m_finished(false)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+TextLineParser::~TextLineParser()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Append the next block of text. The block does not need to start or end on
+//! a line boundary.
+
+void TextLineParser::append(const char* begin, const char* end)
+{
+	if (m_finished)
+		throw BadLogicException(TXT("Attempted to append text after the end was signalled"));
+
+	// Discard the lines already consumed, if they dominate the buffer.
+	if ( (m_start != 0) && (m_start >= (m_buffer.size() / 2)) )
+	{
+		m_buffer.erase(0, m_start);
+		m_scanned -= m_start;
+		m_start = 0;
+	}
+
+	m_buffer.append(begin, end);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Signal that no more text will be appended. Any trailing text that is not
+//! terminated by an EOL will be returned as the final line.
+
+void TextLineParser::finish()
+{
+	m_finished = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Extract the next complete line, if one is available. If the end has not
+//! been signalled and there is no complete line buffered, false is returned
+//! and the caller should append more text.
+
+bool TextLineParser::nextLine(std::string& line)
+{
+	const size_t length = m_buffer.size();
+
+	if (m_start == length)
+		return false;
+
+	const char* buffer = m_buffer.data();
+	const char* eol    = static_cast<const char*>(memchr(buffer + m_scanned, '\n', length - m_scanned));
+	size_t      end    = length;
+	size_t      next   = length;
+
+	if (eol != nullptr)
+	{
+		end  = eol - buffer;
+		next = end + 1;
+	}
+	else if (!m_finished)
+	{
+		m_scanned = length;	// Don't rescan the partial line.
+		return false;
+	}
+
+	// Strip the CR of a CR/LF pair.
+	if ( (eol != nullptr) && (end > m_start) && (buffer[end-1] == '\r') )
+		--end;
+
+	line.assign(buffer + m_start, buffer + end);
+
+	m_start   = next;
+	m_scanned = next;
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Discard all buffered text and return to the initial state.
+
+void TextLineParser::reset()
+{
+	m_buffer.clear();
+	m_start    = 0;
+	m_scanned  = 0;
+	m_finished = false;
+}
+
+//namespace Core
+}
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   TextLineParser.hpp
+//! \brief  The TextLineParser class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_TEXTLINEPARSER_HPP
+#define CORE_TEXTLINEPARSER_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! An incremental parser that splits blocks of raw text into lines. The text
+//! is pushed into the parser in arbitrary sized blocks, such as those returned
+//! by a read-ahead or the completion of an asynchronous read, and the parser
+//! retains any partial line until the rest of it arrives. Lines are terminated
+//! by either "\n" or "\r\n" and the terminator is not returned.
+
+class TextLineParser /*: private NotCopyable*/
+{
+public:
+	//! Default constructor.
+	TextLineParser();
+
+	//! Destructor.
+	~TextLineParser();
+
+	//
+	// Properties.
+	//
+
+	//! Query if the end of the text has been signalled.
+	bool finished() const;
+
+	//! Get the number of bytes buffered but not yet returned as lines.
+	size_t pending() const;
+
+	//
+	// Methods.
+	//
+
+	//! Append the next block of text.
+	void append(const char* begin, const char* end);
+
+	//! Signal that no more text will be appended.
+	void finish();
+
+	//! Extract the next complete line, if one is available.
+	bool nextLine(std::string& line);
+
+	//! Discard all buffered text and return to the initial state.
+	void reset();
+
+private:
+	//
+	// Members.
+	//
+	std::string	m_buffer;	//!< The text not yet returned as lines.
+	size_t		m_start;	//!< The start of the next line in the buffer.
+	size_t		m_scanned;	//!< The point up to which we've searched for EOL.
+	bool		m_finished;	//!< Has the end of the text been signalled?
+
+	// NotCopyable.
+	TextLineParser(const TextLineParser&);
+	TextLineParser& operator=(const TextLineParser&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the end of the text has been signalled.
+
+inline bool TextLineParser::finished() const
+{
+	return m_finished;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of bytes buffered but not yet returned as lines.
+
+inline size_t TextLineParser::pending() const
+{
+	return m_buffer.size() - m_start;
+}
+
+//namespace Core
+}
+
+#endif // CORE_TEXTLINEPARSER_HPP
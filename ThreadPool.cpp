@@ -0,0 +1,471 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ThreadPool.cpp
+//! \brief  The ThreadPool class definition.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "ThreadPool.hpp"
+#include "WorkStealingDeque.hpp"
+#include "InvalidArgException.hpp"
+#include <process.h>
+#include <limits.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Avoid bringing in <windows.h>.
+
+#if (!defined(__GNUC__)) || (defined(__GNUC__) && !defined(_WINBASE_H))
+
+extern "C" void* __stdcall CreateSemaphoreA(void* attributes, long initialCount, long maximumCount, const char* name);
+extern "C" int __stdcall ReleaseSemaphore(void* semaphore, long releaseCount, long* previousCount);
+extern "C" unsigned long __stdcall WaitForSingleObject(void* handle, unsigned long milliseconds);
+extern "C" int __stdcall CloseHandle(void* handle);
+extern "C" unsigned long __stdcall ResumeThread(void* thread);
+extern "C" void* __stdcall GetCurrentProcess();
+extern "C" int __stdcall GetProcessAffinityMask(void* process, size_t* processMask, size_t* systemMask);
+extern "C" size_t __stdcall SetThreadAffinityMask(void* thread, size_t affinityMask);
+extern "C" int __stdcall GetNumaNodeProcessorMask(unsigned char node, ulonglong* processorMask);
+
+#define INFINITE			0xFFFFFFFF
+#define CREATE_SUSPENDED	0x00000004
+
+#endif
+
+namespace Core
+{
+
+namespace
+{
+
+//! The number of times an idle worker looks for work before going to sleep.
+const size_t SPIN_COUNT = 64;
+
+//! The pool worker for the calling thread.
+CORE_THREAD_LOCAL void* t_worker;
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the processors the pool's threads can run on.
+
+size_t availableProcessors(int numaNode)
+{
+	size_t processMask = 0, systemMask = 0;
+
+	if (!::GetProcessAffinityMask(::GetCurrentProcess(), &processMask, &systemMask))
+		processMask = 1;
+
+	if (numaNode != ThreadPool::ANY_NODE)
+	{
+		ulonglong nodeMask = 0;
+
+		if ( (numaNode < 0) || (numaNode > UCHAR_MAX)
+		  || (!::GetNumaNodeProcessorMask(static_cast<uchar>(numaNode), &nodeMask)) )
+			throw InvalidArgException(TXT("Invalid NUMA node"));
+
+		processMask &= static_cast<size_t>(nodeMask);
+
+		if (processMask == 0)
+			throw InvalidArgException(TXT("The NUMA node has no processors available to the process"));
+	}
+
+	return processMask;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of processors in a mask.
+
+size_t countProcessors(size_t mask)
+{
+	size_t count = 0;
+
+	for (; mask != 0; mask &= mask - 1)
+		++count;
+
+	return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the mask for the Nth processor in a mask, wrapping around if required.
+
+size_t nthProcessor(size_t mask, size_t index)
+{
+	index %= countProcessors(mask);
+
+	for (; index != 0; --index)
+		mask &= mask - 1;
+
+	return mask & (0 - mask);
+}
+
+//namespace
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The state of a worker thread.
+
+struct ThreadPool::Worker
+{
+	//! Construction with the pool and the worker's index.
+	Worker(ThreadPool& pool, size_t index)
+		: m_pool(&pool)
+		, m_tasks()
+		, m_thread(nullptr)
+		, m_random(static_cast<uint32>((index + 1) * 2654435761u))
+	{
+	}
+
+	//! Get the next pseudo-random number, for picking a worker to steal from.
+	uint32 nextRandom()
+	{
+		m_random ^= m_random << 13;
+		m_random ^= m_random >> 17;
+		m_random ^= m_random << 5;
+
+		return m_random;
+	}
+
+	//
+	// Members.
+	//
+	ThreadPool*				m_pool;		//!< The pool the worker belongs to.
+	WorkStealingDeque<Task>	m_tasks;	//!< The tasks scheduled by the worker.
+	void*					m_thread;	//!< The thread handle.
+	uint32					m_random;	//!< The state of the random number generator.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the number of threads and where to run them. If the
+//! number of threads is 0 there is one per available processor. The threads
+//! can be pinned to a processor each and restricted to a single NUMA node.
+
+ThreadPool::ThreadPool(size_t threads, uint flags, int numaNode)
+	: m_workers()
+	, m_queue(QUEUE_CAPACITY)
+	, m_wakeup(nullptr)
+	, m_sleepers(0)
+	, m_stopping(0)
+{
+	const size_t processors = availableProcessors(numaNode);
+
+	if (threads == 0)
+		threads = countProcessors(processors);
+
+	m_wakeup = ::CreateSemaphoreA(nullptr, 0, LONG_MAX, nullptr);
+
+	if (m_wakeup == nullptr)
+		throw RuntimeException(TXT("Failed to create the thread pool semaphore"));
+
+	try
+	{
+		// The workers must all exist before any of them start stealing.
+		m_workers.reserve(threads);
+
+		for (size_t i = 0; i != threads; ++i)
+			m_workers.push_back(new Worker(*this, i));
+
+		for (size_t i = 0; i != threads; ++i)
+		{
+			Worker* worker = m_workers[i];
+
+			worker->m_thread = reinterpret_cast<void*>(::_beginthreadex(nullptr, 0, threadMain, worker, CREATE_SUSPENDED, nullptr));
+
+			if (worker->m_thread == nullptr)
+				throw RuntimeException(TXT("Failed to create a thread pool thread"));
+
+			if (flags & PIN_THREADS)
+				::SetThreadAffinityMask(worker->m_thread, nthProcessor(processors, i));
+			else if (numaNode != ANY_NODE)
+				::SetThreadAffinityMask(worker->m_thread, processors);
+
+			::ResumeThread(worker->m_thread);
+		}
+	}
+	catch (...)
+	{
+		stopWorkers();
+		::CloseHandle(m_wakeup);
+		throw;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. Any tasks still queued are run before the threads stop.
+
+ThreadPool::~ThreadPool()
+{
+	stopWorkers();
+	::CloseHandle(m_wakeup);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Queue a task to be run. The pool takes over the caller's reference to the
+//! task, and releases it once the task has been run.
+
+void ThreadPool::schedule(Task* task)
+{
+	ASSERT(task != nullptr);
+
+	Worker* worker = currentWorker();
+
+	if (worker != nullptr)
+		worker->m_tasks.push(task);
+	else
+		m_queue.push(task);
+
+	wakeWorker();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Run a queued task on the calling thread, if there is one. This is used to
+//! make progress whilst waiting for other tasks to finish. Returns false if
+//! there was no task to run.
+
+bool ThreadPool::runPendingTask()
+{
+	Task* task = findTask(currentWorker());
+
+	if (task == nullptr)
+		return false;
+
+	runTask(task);
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the pool's worker for the calling thread, if it is one.
+
+ThreadPool::Worker* ThreadPool::currentWorker() const
+{
+	Worker* worker = static_cast<Worker*>(t_worker);
+
+	return ((worker != nullptr) && (worker->m_pool == this)) ? worker : nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Find a task for a worker, or for a thread outside the pool. The worker's own
+//! tasks come first, then the shared queue, and then another worker's tasks.
+
+Task* ThreadPool::findTask(Worker* worker)
+{
+	Task* task = nullptr;
+
+	if ( (worker != nullptr) && ((task = worker->m_tasks.pop()) != nullptr) )
+		return task;
+
+	if (m_queue.tryPop(task))
+		return task;
+
+	const size_t count = m_workers.size();
+	const size_t first = (worker != nullptr) ? worker->nextRandom() : currentThreadId();
+
+	for (size_t i = 0; i != count; ++i)
+	{
+		Worker* victim = m_workers[(first + i) % count];
+
+		if ( (victim != worker) && ((task = victim->m_tasks.steal()) != nullptr) )
+			return task;
+	}
+
+	return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Run a task and release the pool's reference to it.
+
+void ThreadPool::runTask(Task* task)
+{
+	task->run();
+	task->decRefCount();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wake a sleeping worker, if there is one. Each worker is only woken once, so
+//! scheduling a single task never wakes them all.
+
+void ThreadPool::wakeWorker()
+{
+	// The task must be visible before we look for sleepers, as a worker looks
+	// for tasks after announcing that it's about to sleep.
+	atomicThreadFence(MEMORY_ORDER_SEQ_CST);
+
+	long sleepers = atomicLoad(m_sleepers, MEMORY_ORDER_RELAXED);
+
+	while (sleepers > 0)
+	{
+		if (atomicCompareSwap(m_sleepers, sleepers, sleepers-1))
+		{
+			::ReleaseSemaphore(m_wakeup, 1, nullptr);
+			break;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Run tasks until the pool is stopped. An idle worker keeps looking for tasks
+//! for a short while before going to sleep.
+
+void ThreadPool::workerMain(Worker* worker)
+{
+	t_worker = worker;
+
+	for (;;)
+	{
+		Task* task = findTask(worker);
+
+		for (size_t spin = 0; (task == nullptr) && (spin != SPIN_COUNT); ++spin)
+		{
+			yieldThread();
+			task = findTask(worker);
+		}
+
+		if (task == nullptr)
+		{
+			// Announce we're about to sleep, then look once more, so that a
+			// task scheduled in the meantime isn't missed.
+			atomicFetchAdd(m_sleepers, 1L);
+
+			task = findTask(worker);
+
+			if (task == nullptr)
+			{
+				if (atomicLoad(m_stopping) != 0)
+					break;
+
+				::WaitForSingleObject(m_wakeup, INFINITE);
+				continue;
+			}
+
+			// Withdraw the announcement, unless a wake-up was already sent.
+			long sleepers = atomicLoad(m_sleepers, MEMORY_ORDER_RELAXED);
+
+			while ( (sleepers > 0) && !atomicCompareSwap(m_sleepers, sleepers, sleepers-1) )
+				;
+		}
+
+		runTask(task);
+	}
+
+	t_worker = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Stop and destroy the worker threads. They finish any queued tasks first.
+
+void ThreadPool::stopWorkers()
+{
+	atomicStore(m_stopping, 1L);
+
+	if (!m_workers.empty())
+		::ReleaseSemaphore(m_wakeup, static_cast<long>(m_workers.size()), nullptr);
+
+	// The threads may steal from any worker until they have all stopped.
+	for (Workers::const_iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+	{
+		if ((*it)->m_thread != nullptr)
+			::WaitForSingleObject((*it)->m_thread, INFINITE);
+	}
+
+	for (Workers::const_iterator it = m_workers.begin(); it != m_workers.end(); ++it)
+	{
+		if ((*it)->m_thread != nullptr)
+			::CloseHandle((*it)->m_thread);
+
+		delete *it;
+	}
+
+	m_workers.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The entry point for the worker threads.
+
+unsigned __stdcall ThreadPool::threadMain(void* parameter)
+{
+	Worker* worker = static_cast<Worker*>(parameter);
+
+	worker->m_pool->workerMain(worker);
+
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the chunk size for a parallel loop. If no grain is specified the range
+//! is split into a few chunks per thread, so that the load can be balanced.
+
+size_t ThreadPool::chunkSize(size_t begin, size_t end, size_t grain) const
+{
+	if (grain != 0)
+		return grain;
+
+	const size_t chunk = (end - begin) / (8 * (threads() + 1));
+
+	return (chunk != 0) ? chunk : 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the range, the chunk size and the number of tasks.
+
+ParallelLoop::ParallelLoop(size_t begin, size_t end, size_t chunkSize, size_t tasks)
+	: m_next(begin)
+	, m_end(end)
+	, m_chunkSize(chunkSize)
+	, m_tasks(static_cast<long>(tasks))
+	, m_failed(0)
+	, m_error()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Claim the next chunk of the range. Returns false if there are none left.
+
+bool ParallelLoop::nextChunk(size_t& first, size_t& last)
+{
+	first = atomicFetchAdd(m_next, m_chunkSize, MEMORY_ORDER_RELAXED);
+
+	if (first >= m_end)
+		return false;
+
+	last = ((m_end - first) > m_chunkSize) ? (first + m_chunkSize) : m_end;
+
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Record that a task has finished. The task must not touch the loop again.
+
+void ParallelLoop::finished()
+{
+	atomicFetchSub(m_tasks, 1L, MEMORY_ORDER_RELEASE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Record that a task has failed, and abandon the rest of the range. Only the
+//! first failure is reported.
+
+void ParallelLoop::failed(const tstring& message)
+{
+	if (atomicExchange(m_failed, 1L) == 0)
+		m_error = message;
+
+	atomicStore(m_next, m_end);
+
+	finished();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Wait for the tasks to finish, running other queued tasks in the meantime,
+//! and throw a RuntimeException if any of them failed.
+
+void ParallelLoop::wait(ThreadPool& pool)
+{
+	while (atomicLoad(m_tasks, MEMORY_ORDER_ACQUIRE) != 0)
+	{
+		if (!pool.runPendingTask())
+			yieldThread();
+	}
+
+	if (m_failed != 0)
+		throw RuntimeException(m_error);
+}
+
+//namespace Core
+}
@@ -0,0 +1,446 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ThreadPool.hpp
+//! \brief  The ThreadPool class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_THREADPOOL_HPP
+#define CORE_THREADPOOL_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Task.hpp"
+#include "Future.hpp"
+#include "MpmcQueue.hpp"
+#include "RuntimeException.hpp"
+#include "ThreadUtils.hpp"
+#include <vector>
+
+namespace Core
+{
+
+// Forward declarations.
+class ParallelLoop;
+
+////////////////////////////////////////////////////////////////////////////////
+//! A fixed set of worker threads that run Tasks.
+//!
+//! Each worker has its own work-stealing deque. A task scheduled by a worker
+//! goes on to that worker's deque, and is run in LIFO order. A task scheduled
+//! by any other thread goes on to a shared queue. A worker that runs out of
+//! tasks takes one from the shared queue, or else steals the oldest task from
+//! another worker. Only once there is nothing to steal does it sleep. A sleeping
+//! worker is only woken when a task is scheduled, one worker per task.
+//!
+//! The workers can be pinned to a processor each, and restricted to the
+//! processors of a single NUMA node. Only the first 64 processors, i.e. the
+//! first processor group, are used.
+//!
+//! Any tasks still queued when the pool is destroyed are run first.
+
+class ThreadPool /*: private NotCopyable*/
+{
+public:
+	//! The construction flags.
+	enum Flags
+	{
+		DEFAULT		= 0x0000,	//!< Let the scheduler place the threads.
+		PIN_THREADS	= 0x0001	//!< Pin each thread to its own processor.
+	};
+
+	//! The value for any NUMA node.
+	static const int ANY_NODE = -1;
+
+	//! The number of tasks the shared queue can hold.
+	static const size_t QUEUE_CAPACITY = 4096;
+
+	//! Construction with the number of threads and where to run them.
+	explicit ThreadPool(size_t threads = 0, uint flags = DEFAULT, int numaNode = ANY_NODE);
+
+	//! Destructor.
+	~ThreadPool();
+
+	//
+	// Properties.
+	//
+
+	//! Get the number of worker threads.
+	size_t threads() const;
+
+	//
+	// Methods.
+	//
+
+	//! Queue a task to be run.
+	void schedule(Task* task);
+
+	//! Queue a function object to be run, and get a future for its result.
+	template <typename F>
+	Future<typename F::result_type> submit(const F& function);
+
+	//! Queue a function to be run, and get a future for its result.
+	template <typename R>
+	Future<R> submit(R (*function)());
+
+	//! Call the body for each chunk of a range in parallel.
+	template <typename Body>
+	void parallelFor(size_t begin, size_t end, const Body& body, size_t grain = 0);
+
+	//! Combine the results of calling the body for each chunk of a range in parallel.
+	template <typename R, typename Body, typename Combine>
+	R parallelReduce(size_t begin, size_t end, const R& identity, const Body& body, const Combine& combine, size_t grain = 0);
+
+	//! Run a queued task on the calling thread, if there is one.
+	bool runPendingTask();
+
+private:
+	//! The state of a worker thread.
+	struct Worker;
+
+	//! The worker collection type.
+	typedef std::vector<Worker*> Workers;
+
+	//
+	// Members.
+	//
+	Workers				m_workers;		//!< The worker threads.
+	MpmcQueue<Task*>	m_queue;		//!< Tasks scheduled by other threads.
+	void*				m_wakeup;		//!< The semaphore the idle workers sleep on.
+	long				m_sleepers;		//!< The number of workers about to sleep.
+	long				m_stopping;		//!< Set when the pool is being destroyed.
+
+	//
+	// Internal methods.
+	//
+
+	//! Get the pool's worker for the calling thread, if it is one.
+	Worker* currentWorker() const;
+
+	//! Find a task for a worker, or for a thread outside the pool.
+	Task* findTask(Worker* worker);
+
+	//! Run a task and release the pool's reference to it.
+	static void runTask(Task* task);
+
+	//! Wake a sleeping worker, if there is one.
+	void wakeWorker();
+
+	//! Run tasks until the pool is stopped.
+	void workerMain(Worker* worker);
+
+	//! Stop and destroy the worker threads.
+	void stopWorkers();
+
+	//! The entry point for the worker threads.
+	static unsigned __stdcall threadMain(void* parameter);
+
+	//! Get the chunk size for a parallel loop.
+	size_t chunkSize(size_t begin, size_t end, size_t grain) const;
+
+	// NotCopyable.
+	ThreadPool(const ThreadPool&);
+	ThreadPool& operator=(const ThreadPool&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! The state shared by the tasks that run a parallel loop. The range is split
+//! into chunks that the participants claim one at a time.
+
+class ParallelLoop /*: private NotCopyable*/
+{
+public:
+	//! Construction with the range, the chunk size and the number of tasks.
+	ParallelLoop(size_t begin, size_t end, size_t chunkSize, size_t tasks);
+
+	//
+	// Methods.
+	//
+
+	//! Claim the next chunk of the range.
+	bool nextChunk(size_t& first, size_t& last);
+
+	//! Record that a task has finished.
+	void finished();
+
+	//! Record that a task has failed, and abandon the rest of the range.
+	void failed(const tstring& message);
+
+	//! Wait for the tasks to finish, and throw if any of them failed.
+	void wait(ThreadPool& pool);
+
+private:
+	//
+	// Members.
+	//
+	size_t	m_next;			//!< The start of the next chunk.
+	size_t	m_end;			//!< The end of the range.
+	size_t	m_chunkSize;	//!< The size of a chunk.
+	long	m_tasks;		//!< The number of tasks still running.
+	long	m_failed;		//!< Set when the first task fails.
+	tstring	m_error;		//!< The message of the first failure.
+
+	// NotCopyable.
+	ParallelLoop(const ParallelLoop&);
+	ParallelLoop& operator=(const ParallelLoop&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! A task that runs chunks of a parallel loop.
+
+template <typename Body>
+class ParallelForTask : public Task
+{
+public:
+	//! Construction with the loop and the body.
+	ParallelForTask(ParallelLoop& loop, const Body& body);
+
+protected:
+	//! Do the work.
+	virtual void execute();
+
+	//! Handle the work failing with an exception.
+	virtual void failed(const tstring& message);
+
+private:
+	//
+	// Members.
+	//
+	ParallelLoop&	m_loop;		//!< The shared loop state.
+	const Body&		m_body;		//!< The body of the loop.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! A task that runs chunks of a parallel reduction, and combines their results.
+
+template <typename R, typename Body, typename Combine>
+class ParallelReduceTask : public Task
+{
+public:
+	//! Construction with the loop, the identity value and the functions.
+	ParallelReduceTask(ParallelLoop& loop, const R& identity, const Body& body, const Combine& combine);
+
+	//! Get the combined result of the chunks run by the task.
+	const R& result() const;
+
+protected:
+	//! Do the work.
+	virtual void execute();
+
+	//! Handle the work failing with an exception.
+	virtual void failed(const tstring& message);
+
+private:
+	//
+	// Members.
+	//
+	ParallelLoop&	m_loop;		//!< The shared loop state.
+	R				m_result;	//!< The combined result.
+	const Body&		m_body;		//!< The body of the loop.
+	const Combine&	m_combine;	//!< The function to combine results.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of worker threads.
+
+inline size_t ThreadPool::threads() const
+{
+	return m_workers.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Queue a function object to be run, and get a future for its result. The
+//! function object must define its result_type.
+
+template <typename F>
+inline Future<typename F::result_type> ThreadPool::submit(const F& function)
+{
+	typedef typename F::result_type R;
+
+	FutureTask<R, F>* task = new FutureTask<R, F>(*this, function);
+	Future<R> future(task);
+
+	schedule(task);
+
+	return future;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Queue a function to be run, and get a future for its result.
+
+template <typename R>
+inline Future<R> ThreadPool::submit(R (*function)())
+{
+	typedef R (*F)();
+
+	FutureTask<R, F>* task = new FutureTask<R, F>(*this, function);
+	Future<R> future(task);
+
+	schedule(task);
+
+	return future;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Call the body for each chunk of the range [begin, end) in parallel, where
+//! the body is a function, or function object with a const call operator, that
+//! takes the first and last (exclusive) index of the chunk. The calling thread
+//! runs chunks too, and returns once the whole range has been done.
+//!
+//! If the grain is 0, the range is split into a few chunks per thread,
+//! otherwise each chunk is the grain in size. If the body throws, the rest of
+//! the range is abandoned and a RuntimeException is thrown with the message.
+
+template <typename Body>
+inline void ThreadPool::parallelFor(size_t begin, size_t end, const Body& body, size_t grain)
+{
+	if (begin >= end)
+		return;
+
+	typedef ParallelForTask<Body> LoopTask;
+
+	const size_t chunk = chunkSize(begin, end, grain);
+	const size_t chunks = ((end - begin) + (chunk - 1)) / chunk;
+	const size_t helpers = (chunks - 1 < threads()) ? chunks - 1 : threads();
+
+	ParallelLoop loop(begin, end, chunk, helpers+1);
+	LoopTask*    caller = new LoopTask(loop, body);
+
+	for (size_t i = 0; i != helpers; ++i)
+		schedule(new LoopTask(loop, body));
+
+	runTask(caller);
+	loop.wait(*this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Combine the results of calling the body for each chunk of the range
+//! [begin, end) in parallel. The body takes the first and last (exclusive)
+//! index of a chunk and returns its result. The combine function takes two
+//! results and returns their combination. It must be associative and
+//! commutative, and the identity must not change a result it's combined with.
+//! Both must be functions, or function objects with a const call operator.
+//!
+//! The chunks and failures are handled as for parallelFor().
+
+template <typename R, typename Body, typename Combine>
+inline R ThreadPool::parallelReduce(size_t begin, size_t end, const R& identity, const Body& body, const Combine& combine, size_t grain)
+{
+	if (begin >= end)
+		return identity;
+
+	typedef ParallelReduceTask<R, Body, Combine> ReduceTask;
+	typedef RefCntPtr<ReduceTask> ReduceTaskPtr;
+	typedef std::vector<ReduceTaskPtr> ReduceTasks;
+
+	const size_t chunk = chunkSize(begin, end, grain);
+	const size_t chunks = ((end - begin) + (chunk - 1)) / chunk;
+	const size_t helpers = (chunks - 1 < threads()) ? chunks - 1 : threads();
+
+	ParallelLoop loop(begin, end, chunk, helpers+1);
+	ReduceTasks  tasks;
+
+	tasks.reserve(helpers+1);
+
+	for (size_t i = 0; i != helpers+1; ++i)
+		tasks.push_back(ReduceTaskPtr(new ReduceTask(loop, identity, body, combine)));
+
+	for (size_t i = 1; i != tasks.size(); ++i)
+	{
+		tasks[i]->incRefCount();
+		schedule(tasks[i].get());
+	}
+
+	tasks[0]->run();
+	loop.wait(*this);
+
+	R result = tasks[0]->result();
+
+	for (size_t i = 1; i != tasks.size(); ++i)
+		result = combine(result, tasks[i]->result());
+
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the loop and the body.
+
+template <typename Body>
+inline ParallelForTask<Body>::ParallelForTask(ParallelLoop& loop, const Body& body)
+	: m_loop(loop)
+	, m_body(body)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Do the work.
+
+template <typename Body>
+inline void ParallelForTask<Body>::execute()
+{
+	size_t first, last;
+
+	while (m_loop.nextChunk(first, last))
+		m_body(first, last);
+
+	m_loop.finished();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Handle the work failing with an exception.
+
+template <typename Body>
+inline void ParallelForTask<Body>::failed(const tstring& message)
+{
+	m_loop.failed(message);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the loop, the identity value and the functions.
+
+template <typename R, typename Body, typename Combine>
+inline ParallelReduceTask<R, Body, Combine>::ParallelReduceTask(ParallelLoop& loop, const R& identity, const Body& body, const Combine& combine)
+	: m_loop(loop)
+	, m_result(identity)
+	, m_body(body)
+	, m_combine(combine)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the combined result of the chunks run by the task.
+
+template <typename R, typename Body, typename Combine>
+inline const R& ParallelReduceTask<R, Body, Combine>::result() const
+{
+	return m_result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Do the work.
+
+template <typename R, typename Body, typename Combine>
+inline void ParallelReduceTask<R, Body, Combine>::execute()
+{
+	size_t first, last;
+
+	while (m_loop.nextChunk(first, last))
+		m_result = m_combine(m_result, m_body(first, last));
+
+	m_loop.finished();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Handle the work failing with an exception.
+
+template <typename R, typename Body, typename Combine>
+inline void ParallelReduceTask<R, Body, Combine>::failed(const tstring& message)
+{
+	m_loop.failed(message);
+}
+
+//namespace Core
+}
+
+#endif // CORE_THREADPOOL_HPP
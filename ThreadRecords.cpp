@@ -0,0 +1,201 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ThreadRecords.cpp
+//! \brief  The ThreadRecord struct and ThreadRecords class definitions.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "ThreadRecords.hpp"
+#include "Atomic.hpp"
+#include "ThreadUtils.hpp"
+
+namespace Core
+{
+
+namespace
+{
+
+//! The source of unique IDs for the lists.
+ulong s_nextId = 0;
+
+//! The source of unique tokens for the threads.
+ulong s_nextToken = 0;
+
+//! The flags that mark which thread local slots are allocated to a list.
+long s_slotsInUse[ThreadRecords::MAX_CACHED];
+
+//! The unique token of the calling thread, or 0 if not yet allocated.
+CORE_THREAD_LOCAL ulong t_token;
+
+//! The IDs of the lists whose records are cached for the calling thread.
+CORE_THREAD_LOCAL ulong t_listIds[ThreadRecords::MAX_CACHED];
+
+//! The calling thread's records for the cached lists.
+CORE_THREAD_LOCAL ThreadRecord* t_records[ThreadRecords::MAX_CACHED];
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the unique token of the calling thread. Unlike a thread ID, a token is
+//! never reused by a later thread.
+
+ulong threadToken()
+{
+	if (t_token == 0)
+		t_token = atomicFetchAdd(s_nextToken, 1UL) + 1;
+
+	return t_token;
+}
+
+//namespace
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+ThreadRecord::ThreadRecord()
+	: m_thread(0)
+	, m_token(0)
+	, m_next(nullptr)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+ThreadRecord::~ThreadRecord()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Discard the state left by a thread that has exited, before the record is
+//! handed to a new thread. The default is to keep all the state.
+
+void ThreadRecord::reset()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor. The list is allocated the first free thread local slot,
+//! if there is one.
+
+ThreadRecords::ThreadRecords()
+	: m_id(atomicFetchAdd(s_nextId, 1UL) + 1)
+	, m_slot(MAX_CACHED)
+	, m_head(nullptr)
+	, m_count(0)
+{
+	for (size_t i = 0; (i != MAX_CACHED) && (m_slot == MAX_CACHED); ++i)
+	{
+		long free = 0;
+
+		if (atomicCompareSwap(s_slotsInUse[i], free, 1L))
+			m_slot = i;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. The records are destroyed, so no other thread can be using the
+//! list. The thread local slot is released for reuse by a later list; the IDs
+//! are never reused so a stale cache entry cannot match.
+
+ThreadRecords::~ThreadRecords()
+{
+	ThreadRecord* record = m_head;
+
+	while (record != nullptr)
+	{
+		ThreadRecord* next = record->m_next;
+
+		delete record;
+		record = next;
+	}
+
+	if (m_slot != MAX_CACHED)
+		atomicStore(s_slotsInUse[m_slot], 0L, MEMORY_ORDER_RELEASE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of records. The value may be stale by the time it's used.
+
+size_t ThreadRecords::count() const
+{
+	return atomicLoad(m_count, MEMORY_ORDER_RELAXED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the first record. The records are only ever added at the head, so the
+//! list can be walked while other threads are adding to it.
+
+ThreadRecord* ThreadRecords::head() const
+{
+	return atomicLoad(m_head, MEMORY_ORDER_ACQUIRE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the record for the calling thread, creating it on first use. A record
+//! left by a thread that has exited is reused in preference to creating one.
+
+ThreadRecord* ThreadRecords::threadRecord(Factory factory)
+{
+	if ( (m_slot != MAX_CACHED) && (t_listIds[m_slot] == m_id) )
+		return t_records[m_slot];
+
+	const ulong   token = threadToken();
+	ThreadRecord* record = head();
+
+	while ( (record != nullptr) && (atomicLoad(record->m_token, MEMORY_ORDER_RELAXED) != token) )
+		record = record->m_next;
+
+	if (record == nullptr)
+		record = reuseRecord(currentThreadId(), token);
+
+	if (record == nullptr)
+	{
+		record = factory();
+		record->m_thread = currentThreadId();
+		record->m_token = token;
+
+		ThreadRecord* head = atomicLoad(m_head, MEMORY_ORDER_RELAXED);
+
+		do
+		{
+			record->m_next = head;
+		}
+		while (!atomicCompareSwap(m_head, head, record, MEMORY_ORDER_RELEASE));
+
+		atomicFetchAdd(m_count, static_cast<size_t>(1), MEMORY_ORDER_RELAXED);
+	}
+
+	if (m_slot != MAX_CACHED)
+	{
+		t_listIds[m_slot] = m_id;
+		t_records[m_slot] = record;
+	}
+
+	return record;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Take over the record of a thread that has exited. The thread ID is claimed
+//! first so that only one thread can take over a record, which is then reset.
+//! A record with the calling thread's own ID must have been left by an earlier
+//! thread, as the caller has already looked for its own token.
+
+ThreadRecord* ThreadRecords::reuseRecord(ulong thread, ulong token)
+{
+	for (ThreadRecord* record = head(); record != nullptr; record = record->m_next)
+	{
+		ulong owner = atomicLoad(record->m_thread, MEMORY_ORDER_RELAXED);
+
+		if ( ((owner == thread) || !isThreadRunning(owner))
+		  && atomicCompareSwap(record->m_thread, owner, thread, MEMORY_ORDER_ACQUIRE) )
+		{
+			record->reset();
+			atomicStore(record->m_token, token, MEMORY_ORDER_RELAXED);
+			return record;
+		}
+	}
+
+	return nullptr;
+}
+
+//namespace Core
+}
@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ThreadRecords.hpp
+//! \brief  The ThreadRecord struct and ThreadRecords class declarations.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_THREADRECORDS_HPP
+#define CORE_THREADRECORDS_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! The base class for the state a thread keeps in a ThreadRecords list. The
+//! owner fields are managed by the list.
+
+struct ThreadRecord
+{
+	//! Default constructor.
+	ThreadRecord();
+
+	//! Destructor.
+	virtual ~ThreadRecord();
+
+	//
+	// Methods.
+	//
+
+	//! Discard the state left by a thread that has exited.
+	virtual void reset();
+
+	//
+	// Members.
+	//
+	ulong			m_thread;	//!< The ID of the thread that owns the record.
+	ulong			m_token;	//!< The unique token of the thread that owns the record.
+	ThreadRecord*	m_next;		//!< The next record.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! A lock-free list of per-thread records, such as those used by allocators and
+//! memory reclaimers, with a fast lookup of the calling thread's record.
+//!
+//! Each list is allocated one of a fixed number of slots in a table held in
+//! thread local storage, so finding the calling thread's record is normally
+//! an index and a compare. Slots are recycled when a list is destroyed. Only
+//! when more lists exist at once than there are slots does the lookup fall
+//! back to searching the list.
+//!
+//! Records are pushed on to the list and never removed until it is destroyed.
+//! Instead, a record whose thread has exited is handed to the next thread that
+//! needs one, so the list only grows to the number of threads that were ever
+//! running at the same time. The record is reset before it's handed over, as
+//! the thread may have exited part way through using it.
+
+class ThreadRecords /*: private NotCopyable*/
+{
+public:
+	//! The number of lists whose records can be found without searching. Every
+	//! pool, reclaimer and sharded statistic has a list, so this allows for an
+	//! application with a good number of statistics.
+	static const size_t MAX_CACHED = 256;
+
+	//! Default constructor.
+	ThreadRecords();
+
+	//! Destructor.
+	~ThreadRecords();
+
+	//
+	// Properties.
+	//
+
+	//! Get the number of records.
+	size_t count() const;
+
+	//! Get the first record.
+	template <typename R>
+	R* first() const;
+
+	//
+	// Methods.
+	//
+
+	//! Get the record for the calling thread, creating it if required.
+	template <typename R>
+	R* threadRecord();
+
+	//
+	// Class methods.
+	//
+
+	//! Get the record that follows another.
+	template <typename R>
+	static R* next(const R* record);
+
+private:
+	//! The function used to create a record.
+	typedef ThreadRecord* (*Factory)();
+
+	//
+	// Members.
+	//
+	ulong			m_id;		//!< The unique ID of the list.
+	size_t			m_slot;		//!< The thread local slot, or MAX_CACHED if none.
+	ThreadRecord*	m_head;		//!< The list of records.
+	size_t			m_count;	//!< The number of records.
+
+	//
+	// Internal methods.
+	//
+
+	//! Get the first record.
+	ThreadRecord* head() const;
+
+	//! Get the record for the calling thread, creating it if required.
+	ThreadRecord* threadRecord(Factory factory);
+
+	//! Take over the record of a thread that has exited.
+	ThreadRecord* reuseRecord(ulong thread, ulong token);
+
+	//! Create a record using the default constructor.
+	template <typename R>
+	static ThreadRecord* createRecord();
+
+	// NotCopyable.
+	ThreadRecords(const ThreadRecords&);
+	ThreadRecords& operator=(const ThreadRecords&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the first record.
+
+template <typename R>
+inline R* ThreadRecords::first() const
+{
+	return static_cast<R*>(head());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the record for the calling thread, creating it if required.
+
+template <typename R>
+inline R* ThreadRecords::threadRecord()
+{
+	return static_cast<R*>(threadRecord(&ThreadRecords::createRecord<R>));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the record that follows another.
+
+template <typename R>
+inline R* ThreadRecords::next(const R* record)
+{
+	return static_cast<R*>(record->m_next);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a record using the default constructor.
+
+template <typename R>
+inline ThreadRecord* ThreadRecords::createRecord()
+{
+	return new R;
+}
+
+//namespace Core
+}
+
+#endif // CORE_THREADRECORDS_HPP
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ThreadUtils.cpp
+//! \brief  Thread related utility functions.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "ThreadUtils.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+// Avoid bringing in <windows.h>.
+
+#if (!defined(__GNUC__)) || (defined(__GNUC__) && !defined(_WINBASE_H))
+
+extern "C" unsigned long __stdcall GetCurrentThreadId();
+extern "C" int __stdcall SwitchToThread();
+extern "C" void* __stdcall OpenThread(unsigned long access, int inheritHandle, unsigned long threadId);
+extern "C" unsigned long __stdcall WaitForSingleObject(void* handle, unsigned long milliseconds);
+extern "C" int __stdcall CloseHandle(void* handle);
+
+#define SYNCHRONIZE			0x00100000L
+#define WAIT_TIMEOUT		258L
+
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the identifier of the calling thread. The identifier is unique across
+//! the system whilst the thread is running.
+
+ulong currentThreadId()
+{
+	return ::GetCurrentThreadId();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Give up the rest of the calling thread's time slice to another thread that
+//! is ready to run on the same processor, if there is one.
+
+void yieldThread()
+{
+	::SwitchToThread();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the thread with the identifier is still running. A thread that has
+//! exited may have its identifier reused by a new one, so a false answer is
+//! definitive, but a true one only means that some thread has the identifier.
+
+bool isThreadRunning(ulong threadId)
+{
+	void* thread = ::OpenThread(SYNCHRONIZE, false, threadId);
+
+	if (thread == nullptr)
+		return false;
+
+	const bool running = (::WaitForSingleObject(thread, 0) == WAIT_TIMEOUT);
+
+	::CloseHandle(thread);
+
+	return running;
+}
+
+//namespace Core
+}
@@ -0,0 +1,35 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   ThreadUtils.hpp
+//! \brief  Thread related utility functions.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_THREADUTILS_HPP
+#define CORE_THREADUTILS_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+// Get the identifier of the calling thread.
+
+ulong currentThreadId();
+
+////////////////////////////////////////////////////////////////////////////////
+// Give up the rest of the calling thread's time slice.
+
+void yieldThread();
+
+////////////////////////////////////////////////////////////////////////////////
+// Query if the thread with the identifier is still running.
+
+bool isThreadRunning(ulong threadId);
+
+//namespace Core
+}
+
+#endif // CORE_THREADUTILS_HPP
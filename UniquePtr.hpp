@@ -36,9 +36,23 @@ public:
 	//! Construction from a raw pointer.
 	explicit UniquePtr(T* ptr);
 
+#ifdef CORE_HAS_RVALUE_REFS
+	//! Move constructor.
+	UniquePtr(UniquePtr&& uniquePtr) CORE_NOEXCEPT;
+#endif
+
 	//! Destructor.
 	~UniquePtr();
 
+#ifdef CORE_HAS_RVALUE_REFS
+	//
+	// Operators.
+	//
+
+	//! Move assignment operator.
+	UniquePtr& operator=(UniquePtr&& uniquePtr) CORE_NOEXCEPT;
+#endif
+
 	//
 	// Methods.
 	//
@@ -78,6 +92,21 @@ inline UniquePtr<T>::UniquePtr(T* ptr)
 {
 }
 
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move constructor. Takes over ownership from another pointer, which is left
+//! empty.
+
+template <typename T>
+inline UniquePtr<T>::UniquePtr(UniquePtr&& uniquePtr) CORE_NOEXCEPT
+	: SmartPtr<T>(uniquePtr.m_ptr)
+{
+	uniquePtr.m_ptr = nullptr;
+}
+
+#endif // CORE_HAS_RVALUE_REFS
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Destructor.
 
@@ -87,6 +116,24 @@ inline UniquePtr<T>::~UniquePtr()
 	reset(nullptr);
 }
 
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move assignment operator. Frees the current pointer and takes over
+//! ownership from another pointer, which is left empty.
+
+template <typename T>
+inline UniquePtr<T>& UniquePtr<T>::operator=(UniquePtr&& uniquePtr) CORE_NOEXCEPT
+{
+	// Ignore self-assignment.
+	if (this != &uniquePtr)
+		reset(uniquePtr.detach());
+
+	return *this;
+}
+
+#endif // CORE_HAS_RVALUE_REFS
+
 ////////////////////////////////////////////////////////////////////////////////
 //! Change pointer ownership. Frees the current pointer and takes ownership of
 //! another pointer, if provided.
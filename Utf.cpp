@@ -0,0 +1,701 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Utf.cpp
+//! \brief  UTF-8, UTF-16 and UTF-32 transcoding functions.
+//! \author Chris Oldwood
+
+#include "Common.hpp"
+#include "Utf.hpp"
+#include "ParseException.hpp"
+#include "StringUtils.hpp"
+
+// SSE2 is always available on x64 and can be requested for x86.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define CORE_UTF_SSE2	//!< Use the SSE2 scanning kernels.
+#endif
+
+namespace Core
+{
+
+namespace
+{
+
+//! The result of decoding a single character.
+enum DecodeResult
+{
+	DECODE_INVALID		= -1,	//!< The sequence is invalid.
+	DECODE_INCOMPLETE	=  0,	//!< The input ends part way through the sequence.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Count the number of bits set in a 16-bit mask.
+
+inline size_t countBits(uint mask)
+{
+	mask = mask - ((mask >> 1) & 0x5555);
+	mask = (mask & 0x3333) + ((mask >> 2) & 0x3333);
+	mask = (mask + (mask >> 4)) & 0x0f0f;
+
+	return (mask + (mask >> 8)) & 0x1f;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Find the end of the run of ASCII characters that starts at the beginning of
+//! the UTF-8 string. The SSE2 version tests 16 bytes at a time.
+
+inline const char* skipAscii(const char* begin, const char* end)
+{
+	const char* it = begin;
+
+#ifdef CORE_UTF_SSE2
+	while ((end - it) >= 16)
+	{
+		const int mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(it)));
+
+		if (mask != 0)
+		{
+			int index = 0;
+
+			while ((mask & (1 << index)) == 0)
+				++index;
+
+			return it + index;
+		}
+
+		it += 16;
+	}
+#endif
+
+	while ( (it != end) && (static_cast<uchar>(*it) < 0x80) )
+		++it;
+
+	return it;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Decode a single UTF-8 sequence. This follows the well-formed byte sequence
+//! table from the Unicode standard and so rejects overlong encodings,
+//! surrogates and code points beyond U+10FFFF. Returns the length of the
+//! sequence, DECODE_INCOMPLETE or DECODE_INVALID.
+
+inline int decodeUtf8(const uchar* it, const uchar* end, utf32char& codePoint)
+{
+	const uchar lead = *it;
+
+	if (lead < 0x80)
+	{
+		codePoint = lead;
+		return 1;
+	}
+
+	int   length = 0;
+	uchar lower = 0x80;
+	uchar upper = 0xbf;
+
+	if (lead < 0xc2)
+	{
+		return DECODE_INVALID;
+	}
+	else if (lead < 0xe0)
+	{
+		length = 2;
+		codePoint = lead & 0x1f;
+	}
+	else if (lead < 0xf0)
+	{
+		length = 3;
+		codePoint = lead & 0x0f;
+
+		if (lead == 0xe0)
+			lower = 0xa0;
+		else if (lead == 0xed)
+			upper = 0x9f;
+	}
+	else if (lead < 0xf5)
+	{
+		length = 4;
+		codePoint = lead & 0x07;
+
+		if (lead == 0xf0)
+			lower = 0x90;
+		else if (lead == 0xf4)
+			upper = 0x8f;
+	}
+	else
+	{
+		return DECODE_INVALID;
+	}
+
+	for (int i = 1; i != length; ++i)
+	{
+		if ((it + i) == end)
+			return DECODE_INCOMPLETE;
+
+		const uchar next = it[i];
+
+		if ( (next < lower) || (next > upper) )
+			return DECODE_INVALID;
+
+		lower = 0x80;
+		upper = 0xbf;
+
+		codePoint = (codePoint << 6) | (next & 0x3f);
+	}
+
+	return length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Calculate the number of UTF-8 code units required to encode a code point.
+
+inline size_t utf8Units(utf32char codePoint)
+{
+	if (codePoint < 0x80)
+		return 1;
+	if (codePoint < 0x800)
+		return 2;
+	if (codePoint < 0x10000)
+		return 3;
+
+	return 4;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Encode a valid code point as UTF-8.
+
+inline void encodeUtf8(utf32char codePoint, size_t length, char* dest)
+{
+	switch (length)
+	{
+		case 1:
+			dest[0] = static_cast<char>(codePoint);
+			break;
+
+		case 2:
+			dest[0] = static_cast<char>(0xc0 | (codePoint >> 6));
+			dest[1] = static_cast<char>(0x80 | (codePoint & 0x3f));
+			break;
+
+		case 3:
+			dest[0] = static_cast<char>(0xe0 | (codePoint >> 12));
+			dest[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+			dest[2] = static_cast<char>(0x80 | (codePoint & 0x3f));
+			break;
+
+		default:
+			ASSERT(length == 4);
+			dest[0] = static_cast<char>(0xf0 | (codePoint >> 18));
+			dest[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f));
+			dest[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+			dest[3] = static_cast<char>(0x80 | (codePoint & 0x3f));
+			break;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the code point is a UTF-16 surrogate.
+
+inline bool isSurrogate(utf32char codePoint)
+{
+	return ((codePoint >= 0xd800) && (codePoint <= 0xdfff));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Create a result.
+
+inline UtfResult makeResult(UtfStatus status, size_t consumed, size_t written)
+{
+	UtfResult result = { status, consumed, written };
+
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert UTF-8 to UTF-16 or UTF-32, depending on the number of code units
+//! per character the output type supports.
+
+template<typename UnitT, bool Utf16>
+UtfResult fromUtf8(const char* begin, const char* end, UnitT* dest, size_t destSize)
+{
+	const char* it = begin;
+	size_t      written = 0;
+
+	while (it != end)
+	{
+		// Copy any run of ASCII characters in bulk.
+		const char* ascii = skipAscii(it, end);
+		size_t      count = ascii - it;
+
+		if (count != 0)
+		{
+			if (count > (destSize - written))
+				count = destSize - written;
+
+			for (size_t i = 0; i != count; ++i)
+				dest[written+i] = static_cast<UnitT>(it[i]);
+
+			it += count;
+			written += count;
+
+			if (it == end)
+				break;
+
+			if (written == destSize)
+				return makeResult(UTF_OUTPUT_FULL, it - begin, written);
+		}
+
+		// Decode the multi-byte sequence.
+		utf32char codePoint = 0;
+		const int length = decodeUtf8(reinterpret_cast<const uchar*>(it), reinterpret_cast<const uchar*>(end), codePoint);
+
+		if (length == DECODE_INVALID)
+			return makeResult(UTF_INVALID, it - begin, written);
+
+		if (length == DECODE_INCOMPLETE)
+			return makeResult(UTF_INCOMPLETE, it - begin, written);
+
+		const size_t units = (Utf16 && (codePoint >= 0x10000)) ? 2 : 1;
+
+		if (units > (destSize - written))
+			return makeResult(UTF_OUTPUT_FULL, it - begin, written);
+
+		if (units == 2)
+		{
+			codePoint -= 0x10000;
+
+			dest[written++] = static_cast<UnitT>(0xd800 | (codePoint >> 10));
+			dest[written++] = static_cast<UnitT>(0xdc00 | (codePoint & 0x3ff));
+		}
+		else
+		{
+			dest[written++] = static_cast<UnitT>(codePoint);
+		}
+
+		it += length;
+	}
+
+	return makeResult(UTF_OK, it - begin, written);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Decode a single UTF-16 character. Returns the number of code units,
+//! DECODE_INCOMPLETE or DECODE_INVALID.
+
+template<typename UnitT>
+inline int decodeUtf16(const UnitT* it, const UnitT* end, utf32char& codePoint)
+{
+	const utf32char lead = static_cast<utf16char>(*it);
+
+	if (!isSurrogate(lead))
+	{
+		codePoint = lead;
+		return 1;
+	}
+
+	if (lead >= 0xdc00)
+		return DECODE_INVALID;
+
+	if ((it + 1) == end)
+		return DECODE_INCOMPLETE;
+
+	const utf32char trail = static_cast<utf16char>(it[1]);
+
+	if ( (trail < 0xdc00) || (trail > 0xdfff) )
+		return DECODE_INVALID;
+
+	codePoint = 0x10000 + ((lead - 0xd800) << 10) + (trail - 0xdc00);
+
+	return 2;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Decode a single UTF-32 character. Returns 1 or DECODE_INVALID.
+
+template<typename UnitT>
+inline int decodeUtf32(const UnitT* it, const UnitT* /*end*/, utf32char& codePoint)
+{
+	codePoint = static_cast<utf32char>(*it);
+
+	if ( (codePoint > 0x10ffff) || isSurrogate(codePoint) )
+		return DECODE_INVALID;
+
+	return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert UTF-16 or UTF-32 to UTF-8, depending on the number of code units
+//! per character the input type supports.
+
+template<typename UnitT, bool Utf16>
+UtfResult toUtf8(const UnitT* begin, const UnitT* end, char* dest, size_t destSize)
+{
+	const UnitT* it = begin;
+	size_t       written = 0;
+
+	while (it != end)
+	{
+		// Fast path for ASCII.
+		if (static_cast<utf32char>(*it) < 0x80)
+		{
+			if (written == destSize)
+				return makeResult(UTF_OUTPUT_FULL, it - begin, written);
+
+			dest[written++] = static_cast<char>(*it++);
+			continue;
+		}
+
+		utf32char codePoint = 0;
+		const int units = (Utf16) ? decodeUtf16(it, end, codePoint) : decodeUtf32(it, end, codePoint);
+
+		if (units == DECODE_INVALID)
+			return makeResult(UTF_INVALID, it - begin, written);
+
+		if (units == DECODE_INCOMPLETE)
+			return makeResult(UTF_INCOMPLETE, it - begin, written);
+
+		const size_t length = utf8Units(codePoint);
+
+		if (length > (destSize - written))
+			return makeResult(UTF_OUTPUT_FULL, it - begin, written);
+
+		encodeUtf8(codePoint, length, dest + written);
+
+		written += length;
+		it += units;
+	}
+
+	return makeResult(UTF_OK, it - begin, written);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! The wide string conversions for the size of wchar_t.
+
+template<size_t N>
+struct WideUtf;
+
+////////////////////////////////////////////////////////////////////////////////
+//! The wide string conversions for a 16-bit wchar_t.
+
+template<>
+struct WideUtf<2>
+{
+	//! Convert UTF-8 to UTF-16.
+	static UtfResult fromUtf8(const char* begin, const char* end, wchar_t* dest, size_t destSize)
+	{
+		return Core::fromUtf8<wchar_t, true>(begin, end, dest, destSize);
+	}
+
+	//! Convert UTF-16 to UTF-8.
+	static UtfResult toUtf8(const wchar_t* begin, const wchar_t* end, char* dest, size_t destSize)
+	{
+		return Core::toUtf8<wchar_t, true>(begin, end, dest, destSize);
+	}
+
+	//! The number of wide characters required.
+	static size_t length(const char* begin, const char* end)
+	{
+		return utf16Length(begin, end);
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! The wide string conversions for a 32-bit wchar_t.
+
+template<>
+struct WideUtf<4>
+{
+	//! Convert UTF-8 to UTF-32.
+	static UtfResult fromUtf8(const char* begin, const char* end, wchar_t* dest, size_t destSize)
+	{
+		return Core::fromUtf8<wchar_t, false>(begin, end, dest, destSize);
+	}
+
+	//! Convert UTF-32 to UTF-8.
+	static UtfResult toUtf8(const wchar_t* begin, const wchar_t* end, char* dest, size_t destSize)
+	{
+		return Core::toUtf8<wchar_t, false>(begin, end, dest, destSize);
+	}
+
+	//! The number of wide characters required.
+	static size_t length(const char* begin, const char* end)
+	{
+		return utf32Length(begin, end);
+	}
+};
+
+//! The wide string conversions for this platform.
+typedef WideUtf<sizeof(wchar_t)> Wide;
+
+//namespace
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Validate a UTF-8 string. Runs of ASCII characters are skipped in bulk and
+//! only multi-byte sequences are decoded.
+
+UtfResult validateUtf8(const char* begin, const char* end)
+{
+	const char* it = begin;
+
+	while (it != end)
+	{
+		it = skipAscii(it, end);
+
+		if (it == end)
+			break;
+
+		utf32char codePoint = 0;
+		const int length = decodeUtf8(reinterpret_cast<const uchar*>(it), reinterpret_cast<const uchar*>(end), codePoint);
+
+		if (length == DECODE_INVALID)
+			return makeResult(UTF_INVALID, it - begin, 0);
+
+		if (length == DECODE_INCOMPLETE)
+			return makeResult(UTF_INCOMPLETE, it - begin, 0);
+
+		it += length;
+	}
+
+	return makeResult(UTF_OK, it - begin, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Validate a UTF-16 string.
+
+UtfResult validateUtf16(const utf16char* begin, const utf16char* end)
+{
+	const utf16char* it = begin;
+
+	while (it != end)
+	{
+		utf32char codePoint = 0;
+		const int units = decodeUtf16(it, end, codePoint);
+
+		if (units == DECODE_INVALID)
+			return makeResult(UTF_INVALID, it - begin, 0);
+
+		if (units == DECODE_INCOMPLETE)
+			return makeResult(UTF_INCOMPLETE, it - begin, 0);
+
+		it += units;
+	}
+
+	return makeResult(UTF_OK, it - begin, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Calculate the number of UTF-16 code units required for a valid UTF-8
+//! string. Every byte that is not a continuation byte starts a character and
+//! the 4 byte sequences also require a surrogate.
+
+size_t utf16Length(const char* begin, const char* end)
+{
+	const char* it = begin;
+	size_t      length = 0;
+
+#ifdef CORE_UTF_SSE2
+	const __m128i continuation = _mm_set1_epi8(-65);	// 0xbf
+	const __m128i fourByteLead = _mm_set1_epi8(-17);	// 0xef
+
+	while ((end - it) >= 16)
+	{
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+		const __m128i leads = _mm_cmpgt_epi8(bytes, continuation);
+		const __m128i quads = _mm_and_si128(_mm_cmpgt_epi8(bytes, fourByteLead), _mm_cmpgt_epi8(_mm_setzero_si128(), bytes));
+
+		length += countBits(_mm_movemask_epi8(leads)) + countBits(_mm_movemask_epi8(quads));
+
+		it += 16;
+	}
+#endif
+
+	for (; it != end; ++it)
+	{
+		const uchar c = static_cast<uchar>(*it);
+
+		if ((c & 0xc0) != 0x80)
+			++length;
+
+		if (c >= 0xf0)
+			++length;
+	}
+
+	return length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Calculate the number of UTF-32 code units required for a valid UTF-8
+//! string. Every byte that is not a continuation byte starts a character.
+
+size_t utf32Length(const char* begin, const char* end)
+{
+	const char* it = begin;
+	size_t      length = 0;
+
+#ifdef CORE_UTF_SSE2
+	const __m128i continuation = _mm_set1_epi8(-65);	// 0xbf
+
+	while ((end - it) >= 16)
+	{
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+
+		length += countBits(_mm_movemask_epi8(_mm_cmpgt_epi8(bytes, continuation)));
+
+		it += 16;
+	}
+#endif
+
+	for (; it != end; ++it)
+	{
+		if ((static_cast<uchar>(*it) & 0xc0) != 0x80)
+			++length;
+	}
+
+	return length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Calculate the number of UTF-8 code units required for a valid UTF-16
+//! string. Each half of a surrogate pair contributes half of the 4 bytes.
+
+size_t utf8Length(const utf16char* begin, const utf16char* end)
+{
+	size_t length = 0;
+
+	for (const utf16char* it = begin; it != end; ++it)
+	{
+		const utf32char unit = *it;
+
+		if (isSurrogate(unit))
+			length += 2;
+		else
+			length += utf8Units(unit);
+	}
+
+	return length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Calculate the number of UTF-8 code units required for a valid UTF-32
+//! string.
+
+size_t utf8Length(const utf32char* begin, const utf32char* end)
+{
+	size_t length = 0;
+
+	for (const utf32char* it = begin; it != end; ++it)
+		length += utf8Units(*it);
+
+	return length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert UTF-8 to UTF-16.
+
+UtfResult utf8ToUtf16(const char* begin, const char* end, utf16char* dest, size_t destSize)
+{
+	return fromUtf8<utf16char, true>(begin, end, dest, destSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert UTF-8 to UTF-32.
+
+UtfResult utf8ToUtf32(const char* begin, const char* end, utf32char* dest, size_t destSize)
+{
+	return fromUtf8<utf32char, false>(begin, end, dest, destSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert UTF-16 to UTF-8.
+
+UtfResult utf16ToUtf8(const utf16char* begin, const utf16char* end, char* dest, size_t destSize)
+{
+	return toUtf8<utf16char, true>(begin, end, dest, destSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert UTF-32 to UTF-8.
+
+UtfResult utf32ToUtf8(const utf32char* begin, const utf32char* end, char* dest, size_t destSize)
+{
+	return toUtf8<utf32char, false>(begin, end, dest, destSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert UTF-8 to a wide string.
+
+UtfResult utf8ToWide(const char* begin, const char* end, wchar_t* dest, size_t destSize)
+{
+	return Wide::fromUtf8(begin, end, dest, destSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert a wide string to UTF-8.
+
+UtfResult wideToUtf8(const wchar_t* begin, const wchar_t* end, char* dest, size_t destSize)
+{
+	return Wide::toUtf8(begin, end, dest, destSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert UTF-8 to a wide string. Throws a ParseException that includes the
+//! byte position if the input is not valid UTF-8.
+
+std::wstring utf8ToWide(const char* begin, const char* end)
+{
+	const UtfResult validation = validateUtf8(begin, end);
+
+	if (validation.status == UTF_INVALID)
+		throw ParseException(Core::fmt(TXT("Invalid UTF-8 sequence at byte %u"), static_cast<uint>(validation.consumed)));
+
+	if (validation.status == UTF_INCOMPLETE)
+		throw ParseException(Core::fmt(TXT("Incomplete UTF-8 sequence at byte %u"), static_cast<uint>(validation.consumed)));
+
+	std::wstring string;
+
+	string.resize(Wide::length(begin, end));
+
+	if (!string.empty())
+	{
+		const UtfResult result = Wide::fromUtf8(begin, end, &string[0], string.size());
+
+		ASSERT(result.status == UTF_OK);
+		ASSERT(result.written == string.size());
+		DEBUG_USE_ONLY(result);
+	}
+
+	return string;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert a wide string to UTF-8. Throws a ParseException that includes the
+//! character position if the input is not valid UTF-16 or UTF-32.
+
+std::string wideToUtf8(const wchar_t* begin, const wchar_t* end)
+{
+	std::string string;
+
+	// Every wide character requires at most 3 bytes for UTF-16, as a 4 byte
+	// sequence consumes a surrogate pair, and 4 bytes for UTF-32.
+	string.resize((end - begin) * ((sizeof(wchar_t) == 2) ? 3 : 4));
+
+	if (string.empty())
+		return string;
+
+	const UtfResult result = Wide::toUtf8(begin, end, &string[0], string.size());
+
+	if (result.status == UTF_INVALID)
+		throw ParseException(Core::fmt(TXT("Invalid UTF-%u sequence at character %u"), static_cast<uint>(sizeof(wchar_t) * 8), static_cast<uint>(result.consumed)));
+
+	if (result.status == UTF_INCOMPLETE)
+		throw ParseException(Core::fmt(TXT("Incomplete UTF-%u sequence at character %u"), static_cast<uint>(sizeof(wchar_t) * 8), static_cast<uint>(result.consumed)));
+
+	ASSERT(result.status == UTF_OK);
+
+	string.resize(result.written);
+
+	return string;
+}
+
+//namespace Core
+}
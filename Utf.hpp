@@ -0,0 +1,131 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   Utf.hpp
+//! \brief  UTF-8, UTF-16 and UTF-32 transcoding functions.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_UTF_HPP
+#define CORE_UTF_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+// Types.
+
+typedef ushort	utf16char;	//!< A UTF-16 code unit.
+typedef uint	utf32char;	//!< A UTF-32 code unit.
+
+////////////////////////////////////////////////////////////////////////////////
+//! The outcome of a transcoding or validation function.
+
+enum UtfStatus
+{
+	UTF_OK			= 0,	//!< All the input was processed.
+	UTF_INVALID		= 1,	//!< An invalid sequence was found.
+	UTF_INCOMPLETE	= 2,	//!< The input ends part way through a sequence.
+	UTF_OUTPUT_FULL	= 3,	//!< The output buffer is too small for the next character.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! The result of a transcoding or validation function. When the status is not
+//! UTF_OK the number of input units consumed is the position of the invalid,
+//! incomplete or unwritten character.
+
+struct UtfResult
+{
+	UtfStatus	status;		//!< The outcome.
+	size_t		consumed;	//!< The number of input code units consumed.
+	size_t		written;	//!< The number of output code units written.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Validation.
+
+// Validate a UTF-8 string.
+UtfResult validateUtf8(const char* begin, const char* end);
+
+// Validate a UTF-16 string.
+UtfResult validateUtf16(const utf16char* begin, const utf16char* end);
+
+////////////////////////////////////////////////////////////////////////////////
+// Sizing. These assume the input has already been validated.
+
+// Calculate the number of UTF-16 code units required for a valid UTF-8 string.
+size_t utf16Length(const char* begin, const char* end);
+
+// Calculate the number of UTF-32 code units required for a valid UTF-8 string.
+size_t utf32Length(const char* begin, const char* end);
+
+// Calculate the number of UTF-8 code units required for a valid UTF-16 string.
+size_t utf8Length(const utf16char* begin, const utf16char* end);
+
+// Calculate the number of UTF-8 code units required for a valid UTF-32 string.
+size_t utf8Length(const utf32char* begin, const utf32char* end);
+
+////////////////////////////////////////////////////////////////////////////////
+// Buffer-to-buffer conversions. These validate the input as they go and stop
+// at the first problem. A truncated sequence at the end of the input is
+// reported as UTF_INCOMPLETE so that streaming callers can retry it once the
+// rest of the sequence has arrived.
+
+// Convert UTF-8 to UTF-16.
+UtfResult utf8ToUtf16(const char* begin, const char* end, utf16char* dest, size_t destSize);
+
+// Convert UTF-8 to UTF-32.
+UtfResult utf8ToUtf32(const char* begin, const char* end, utf32char* dest, size_t destSize);
+
+// Convert UTF-16 to UTF-8.
+UtfResult utf16ToUtf8(const utf16char* begin, const utf16char* end, char* dest, size_t destSize);
+
+// Convert UTF-32 to UTF-8.
+UtfResult utf32ToUtf8(const utf32char* begin, const utf32char* end, char* dest, size_t destSize);
+
+////////////////////////////////////////////////////////////////////////////////
+// Wide string conversions. A wchar_t string is treated as UTF-16 or UTF-32
+// depending on the size of wchar_t.
+
+// Convert UTF-8 to a wide string.
+UtfResult utf8ToWide(const char* begin, const char* end, wchar_t* dest, size_t destSize);
+
+// Convert a wide string to UTF-8.
+UtfResult wideToUtf8(const wchar_t* begin, const wchar_t* end, char* dest, size_t destSize);
+
+// Convert UTF-8 to a wide string.
+std::wstring utf8ToWide(const char* begin, const char* end); // throw(ParseException)
+
+// Convert a wide string to UTF-8.
+std::string wideToUtf8(const wchar_t* begin, const wchar_t* end); // throw(ParseException)
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert UTF-8 to a wide string. Throws a ParseException that includes the
+//! byte position if the input is not valid UTF-8.
+
+inline std::wstring utf8ToWide(const std::string& string)
+{
+	const char* begin = string.data();
+	const char* end   = begin + string.size();
+
+	return utf8ToWide(begin, end);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Convert a wide string to UTF-8. Throws a ParseException that includes the
+//! character position if the input is not valid UTF-16 or UTF-32.
+
+inline std::string wideToUtf8(const std::wstring& string)
+{
+	const wchar_t* begin = string.data();
+	const wchar_t* end   = begin + string.size();
+
+	return wideToUtf8(begin, end);
+}
+
+//namespace Core
+}
+
+#endif // CORE_UTF_HPP
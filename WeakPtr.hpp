@@ -0,0 +1,321 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   WeakPtr.hpp
+//! \brief  The WeakPtr template class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_WEAKPTR_HPP
+#define CORE_WEAKPTR_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "SharedPtr.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A non-owning observer of an object owned by one or more SharedPtrs. It does
+//! not keep the object alive and so can be used to break reference cycles or
+//! by caches that must not pin the objects they hold. The object can only be
+//! accessed by calling lock() to obtain a SharedPtr, which is empty if the
+//! object has since been destroyed. Both expired() and lock() are lock-free.
+//! The counting policy must match that of the SharedPtrs being observed.
+
+template <typename T, typename C = AtomicCount>
+class WeakPtr
+{
+public:
+	//! Default constructor.
+	WeakPtr();
+
+	//! Construction from a SharedPtr.
+	WeakPtr(const SharedPtr<T, C>& sharedPtr);
+
+	//! Construction from a SharedPtr of a sub-type of T.
+	template <typename U>
+	WeakPtr(const SharedPtr<U, C>& sharedPtr);
+
+	//! Copy constructor.
+	WeakPtr(const WeakPtr& weakPtr);
+
+	//! Copy constructor for sub-types of T.
+	template <typename U>
+	WeakPtr(const WeakPtr<U, C>& weakPtr);
+
+#ifdef CORE_HAS_RVALUE_REFS
+	//! Move constructor.
+	WeakPtr(WeakPtr&& weakPtr) CORE_NOEXCEPT;
+#endif
+
+	//! Destructor.
+	~WeakPtr();
+
+	//
+	// Operators.
+	//
+
+	//! Assignment operator.
+	WeakPtr& operator=(const WeakPtr& weakPtr);
+
+	//! Assignment operator for sub-types of T.
+	template <typename U>
+	WeakPtr& operator=(const WeakPtr<U, C>& weakPtr);
+
+	//! Assignment operator from a SharedPtr.
+	template <typename U>
+	WeakPtr& operator=(const SharedPtr<U, C>& sharedPtr);
+
+#ifdef CORE_HAS_RVALUE_REFS
+	//! Move assignment operator.
+	WeakPtr& operator=(WeakPtr&& weakPtr) CORE_NOEXCEPT;
+#endif
+
+	//
+	// Methods.
+	//
+
+	//! Query if the object has been destroyed, or was never set.
+	bool expired() const;
+
+	//! Obtain a strong reference to the object, if it still exists.
+	SharedPtr<T, C> lock() const;
+
+	//! Stop observing the object.
+	void reset();
+
+private:
+	//
+	// Members.
+	//
+	T*				m_ptr;			//!< The object being observed.
+	SharedCount<C>*	m_refCount;		//!< The object's control block.
+
+	//! Observe the object with the given control block.
+	void assign(T* ptr, SharedCount<C>* refCount);
+
+	//
+	// Friends.
+	//
+
+	//! Allow member access for WeakPtrs of sub-types.
+	template<typename U, typename D>
+	friend class WeakPtr;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Default constructor.
+
+template <typename T, typename C>
+inline WeakPtr<T, C>::WeakPtr()
+	: m_ptr(nullptr)
+	, m_refCount(nullptr)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a SharedPtr.
+
+template <typename T, typename C>
+inline WeakPtr<T, C>::WeakPtr(const SharedPtr<T, C>& sharedPtr)
+	: m_ptr(sharedPtr.m_ptr)
+	, m_refCount(sharedPtr.m_refCount)
+{
+	if (m_refCount != nullptr)
+		m_refCount->addWeakRef();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction from a SharedPtr of a sub-type of T.
+
+template <typename T, typename C>
+template <typename U>
+inline WeakPtr<T, C>::WeakPtr(const SharedPtr<U, C>& sharedPtr)
+	: m_ptr(sharedPtr.m_ptr)
+	, m_refCount(sharedPtr.m_refCount)
+{
+	if (m_refCount != nullptr)
+		m_refCount->addWeakRef();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Copy constructor.
+
+template <typename T, typename C>
+inline WeakPtr<T, C>::WeakPtr(const WeakPtr& weakPtr)
+	: m_ptr(weakPtr.m_ptr)
+	, m_refCount(weakPtr.m_refCount)
+{
+	if (m_refCount != nullptr)
+		m_refCount->addWeakRef();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Copy constructor for sub-types of T. The pointer is only converted via
+//! lock() as the object may already have been destroyed, which could make a
+//! conversion involving a virtual base class unsafe.
+
+template <typename T, typename C>
+template <typename U>
+inline WeakPtr<T, C>::WeakPtr(const WeakPtr<U, C>& weakPtr)
+	: m_ptr(nullptr)
+	, m_refCount(nullptr)
+{
+	const SharedPtr<U, C> sharedPtr = weakPtr.lock();
+
+	assign(sharedPtr.get(), sharedPtr.m_refCount);
+}
+
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move constructor. Takes over the weak reference of another pointer, which
+//! is left empty.
+
+template <typename T, typename C>
+inline WeakPtr<T, C>::WeakPtr(WeakPtr&& weakPtr) CORE_NOEXCEPT
+	: m_ptr(weakPtr.m_ptr)
+	, m_refCount(weakPtr.m_refCount)
+{
+	weakPtr.m_ptr = nullptr;
+	weakPtr.m_refCount = nullptr;
+}
+
+#endif // CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+template <typename T, typename C>
+inline WeakPtr<T, C>::~WeakPtr()
+{
+	reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Assignment operator.
+
+template <typename T, typename C>
+inline WeakPtr<T, C>& WeakPtr<T, C>::operator=(const WeakPtr& weakPtr)
+{
+	assign(weakPtr.m_ptr, weakPtr.m_refCount);
+
+	return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Assignment operator for sub-types of T.
+
+template <typename T, typename C>
+template <typename U>
+inline WeakPtr<T, C>& WeakPtr<T, C>::operator=(const WeakPtr<U, C>& weakPtr)
+{
+	const SharedPtr<U, C> sharedPtr = weakPtr.lock();
+
+	assign(sharedPtr.get(), sharedPtr.m_refCount);
+
+	return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Assignment operator from a SharedPtr, which may be of a sub-type of T.
+
+template <typename T, typename C>
+template <typename U>
+inline WeakPtr<T, C>& WeakPtr<T, C>::operator=(const SharedPtr<U, C>& sharedPtr)
+{
+	assign(sharedPtr.m_ptr, sharedPtr.m_refCount);
+
+	return *this;
+}
+
+#ifdef CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Move assignment operator. Releases the current weak reference and takes
+//! over the one from another pointer, which is left empty.
+
+template <typename T, typename C>
+inline WeakPtr<T, C>& WeakPtr<T, C>::operator=(WeakPtr&& weakPtr) CORE_NOEXCEPT
+{
+	// Ignore self-assignment.
+	if (this != &weakPtr)
+	{
+		SharedCount<C>* oldCnt = m_refCount;
+
+		m_ptr = weakPtr.m_ptr;
+		m_refCount = weakPtr.m_refCount;
+
+		weakPtr.m_ptr = nullptr;
+		weakPtr.m_refCount = nullptr;
+
+		if (oldCnt != nullptr)
+			oldCnt->releaseWeak();
+	}
+
+	return *this;
+}
+
+#endif // CORE_HAS_RVALUE_REFS
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the object has been destroyed, or was never set. The answer may be
+//! stale by the time it's used if other threads hold references, so use lock()
+//! to access the object.
+
+template <typename T, typename C>
+inline bool WeakPtr<T, C>::expired() const
+{
+	return ((m_refCount == nullptr) || m_refCount->expired());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Obtain a strong reference to the object. If it has already been destroyed
+//! an empty SharedPtr is returned.
+
+template <typename T, typename C>
+inline SharedPtr<T, C> WeakPtr<T, C>::lock() const
+{
+	SharedPtr<T, C> sharedPtr;
+
+	if ( (m_refCount != nullptr) && m_refCount->tryAddRef() )
+	{
+		sharedPtr.m_ptr = m_ptr;
+		sharedPtr.m_refCount = m_refCount;
+	}
+
+	return sharedPtr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Stop observing the object.
+
+template <typename T, typename C>
+inline void WeakPtr<T, C>::reset()
+{
+	assign(nullptr, nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Observe the object with the given control block. The new weak reference is
+//! added before the old one is released to handle self-assignment.
+
+template <typename T, typename C>
+inline void WeakPtr<T, C>::assign(T* ptr, SharedCount<C>* refCount)
+{
+	if (refCount != nullptr)
+		refCount->addWeakRef();
+
+	if (m_refCount != nullptr)
+		m_refCount->releaseWeak();
+
+	m_ptr = ptr;
+	m_refCount = refCount;
+}
+
+//namespace Core
+}
+
+#endif // CORE_WEAKPTR_HPP
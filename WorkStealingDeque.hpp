@@ -0,0 +1,293 @@
+////////////////////////////////////////////////////////////////////////////////
+//! \file   WorkStealingDeque.hpp
+//! \brief  The WorkStealingDeque class declaration.
+//! \author Chris Oldwood
+
+// Check for previous inclusion
+#ifndef CORE_WORKSTEALINGDEQUE_HPP
+#define CORE_WORKSTEALINGDEQUE_HPP
+
+#if _MSC_VER > 1000
+#pragma once
+#endif
+
+#include "Atomic.hpp"
+#include "CacheLine.hpp"
+#include "InvalidArgException.hpp"
+
+namespace Core
+{
+
+////////////////////////////////////////////////////////////////////////////////
+//! A Chase-Lev work-stealing deque of pointers. The thread that owns the deque
+//! pushes and pops items at the bottom, in LIFO order, without any locked
+//! instructions unless it's competing for the last item. Any other thread can
+//! steal items from the top, in FIFO order, with a single compare-exchange.
+//!
+//! The buffer grows when it's full. The old buffers may still be being read by
+//! thieves, so they are kept until the deque is destroyed. The deque does not
+//! own the items.
+
+template <typename T>
+class WorkStealingDeque /*: private NotCopyable*/
+{
+public:
+	//! The default initial capacity.
+	static const size_t DEFAULT_CAPACITY = 256;
+
+	//! Construction with the initial capacity, which must be a power of two.
+	explicit WorkStealingDeque(size_t capacity = DEFAULT_CAPACITY);
+
+	//! Destructor.
+	~WorkStealingDeque();
+
+	//
+	// Properties.
+	//
+
+	//! Get the number of items in the deque.
+	size_t size() const;
+
+	//! Query if the deque is empty.
+	bool empty() const;
+
+	//
+	// Methods.
+	//
+
+	//! Push an item on to the bottom. Only called by the owning thread.
+	void push(T* item);
+
+	//! Pop an item from the bottom. Only called by the owning thread.
+	T* pop();
+
+	//! Steal an item from the top. Can be called by any thread.
+	T* steal();
+
+private:
+	//! A circular buffer of items.
+	struct Buffer
+	{
+		//! Construction with the capacity and the buffer it replaces.
+		Buffer(size_t capacity, Buffer* previous);
+
+		//! Destructor.
+		~Buffer();
+
+		//! Get the item at an index.
+		T* get(ptrdiff_t index) const;
+
+		//! Set the item at an index.
+		void set(ptrdiff_t index, T* item);
+
+		//
+		// Members.
+		//
+		ptrdiff_t	m_mask;			//!< The mask to map an index to a slot.
+		T**			m_items;		//!< The slots.
+		Buffer*		m_previous;		//!< The buffer this one replaced.
+	};
+
+	//
+	// Members.
+	//
+	ptrdiff_t		m_top;			//!< The index of the next item to steal.
+	CachePadding<>	m_padding1;		//!< Keep the owner off the top.
+	ptrdiff_t		m_bottom;		//!< The index of the next item to push.
+	Buffer*			m_buffer;		//!< The current buffer.
+	CachePadding<>	m_padding2;		//!< Keep the owner off whatever follows.
+
+	//
+	// Internal methods.
+	//
+
+	//! Replace the buffer with one twice the size.
+	Buffer* grow(Buffer* buffer, ptrdiff_t top, ptrdiff_t bottom);
+
+	// NotCopyable.
+	WorkStealingDeque(const WorkStealingDeque&);
+	WorkStealingDeque& operator=(const WorkStealingDeque&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the capacity and the buffer it replaces.
+
+template <typename T>
+inline WorkStealingDeque<T>::Buffer::Buffer(size_t capacity, Buffer* previous)
+	: m_mask(static_cast<ptrdiff_t>(capacity - 1))
+	, m_items(new T*[capacity])
+	, m_previous(previous)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor. The buffers it replaced are destroyed too.
+
+template <typename T>
+inline WorkStealingDeque<T>::Buffer::~Buffer()
+{
+	delete[] m_items;
+	delete m_previous;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the item at an index.
+
+template <typename T>
+inline T* WorkStealingDeque<T>::Buffer::get(ptrdiff_t index) const
+{
+	return atomicLoad(m_items[index & m_mask], MEMORY_ORDER_RELAXED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Set the item at an index.
+
+template <typename T>
+inline void WorkStealingDeque<T>::Buffer::set(ptrdiff_t index, T* item)
+{
+	atomicStore(m_items[index & m_mask], item, MEMORY_ORDER_RELAXED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Construction with the initial capacity, which must be a power of two.
+
+template <typename T>
+inline WorkStealingDeque<T>::WorkStealingDeque(size_t capacity)
+	: m_top(0)
+	, m_bottom(0)
+	, m_buffer(nullptr)
+{
+	if ( (capacity == 0) || ((capacity & (capacity - 1)) != 0) )
+		throw InvalidArgException(TXT("The deque capacity must be a power of two"));
+
+	m_buffer = new Buffer(capacity, nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Destructor.
+
+template <typename T>
+inline WorkStealingDeque<T>::~WorkStealingDeque()
+{
+	delete m_buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Get the number of items in the deque. The value may be stale by the time
+//! it's used.
+
+template <typename T>
+inline size_t WorkStealingDeque<T>::size() const
+{
+	const ptrdiff_t top = atomicLoad(m_top, MEMORY_ORDER_ACQUIRE);
+	const ptrdiff_t bottom = atomicLoad(m_bottom, MEMORY_ORDER_ACQUIRE);
+
+	return (bottom > top) ? static_cast<size_t>(bottom - top) : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Query if the deque is empty. The value may be stale by the time it's used.
+
+template <typename T>
+inline bool WorkStealingDeque<T>::empty() const
+{
+	return (size() == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Push an item on to the bottom. Only called by the owning thread.
+
+template <typename T>
+inline void WorkStealingDeque<T>::push(T* item)
+{
+	const ptrdiff_t bottom = atomicLoad(m_bottom, MEMORY_ORDER_RELAXED);
+	const ptrdiff_t top = atomicLoad(m_top, MEMORY_ORDER_ACQUIRE);
+	Buffer*         buffer = atomicLoad(m_buffer, MEMORY_ORDER_RELAXED);
+
+	if ((bottom - top) > buffer->m_mask)
+		buffer = grow(buffer, top, bottom);
+
+	buffer->set(bottom, item);
+	atomicThreadFence(MEMORY_ORDER_RELEASE);
+	atomicStore(m_bottom, bottom+1, MEMORY_ORDER_RELAXED);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Pop an item from the bottom. Only called by the owning thread. Returns null
+//! if the deque is empty.
+
+template <typename T>
+inline T* WorkStealingDeque<T>::pop()
+{
+	const ptrdiff_t bottom = atomicLoad(m_bottom, MEMORY_ORDER_RELAXED) - 1;
+	Buffer*         buffer = atomicLoad(m_buffer, MEMORY_ORDER_RELAXED);
+
+	// Claim the bottom item before looking at what the thieves have taken.
+	atomicStore(m_bottom, bottom, MEMORY_ORDER_RELAXED);
+	atomicThreadFence(MEMORY_ORDER_SEQ_CST);
+
+	ptrdiff_t top = atomicLoad(m_top, MEMORY_ORDER_RELAXED);
+
+	if (top > bottom)
+	{
+		atomicStore(m_bottom, bottom+1, MEMORY_ORDER_RELAXED);
+		return nullptr;
+	}
+
+	T* item = buffer->get(bottom);
+
+	// Race any thieves for the last item.
+	if (top == bottom)
+	{
+		if (!atomicCompareSwap(m_top, top, top+1, MEMORY_ORDER_SEQ_CST))
+			item = nullptr;
+
+		atomicStore(m_bottom, bottom+1, MEMORY_ORDER_RELAXED);
+	}
+
+	return item;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Steal an item from the top. Can be called by any thread. Returns null if the
+//! deque is empty or another thread took the item first.
+
+template <typename T>
+inline T* WorkStealingDeque<T>::steal()
+{
+	ptrdiff_t top = atomicLoad(m_top, MEMORY_ORDER_ACQUIRE);
+	atomicThreadFence(MEMORY_ORDER_SEQ_CST);
+	const ptrdiff_t bottom = atomicLoad(m_bottom, MEMORY_ORDER_ACQUIRE);
+
+	if (top >= bottom)
+		return nullptr;
+
+	Buffer* buffer = atomicLoad(m_buffer, MEMORY_ORDER_ACQUIRE);
+	T*      item = buffer->get(top);
+
+	if (!atomicCompareSwap(m_top, top, top+1, MEMORY_ORDER_SEQ_CST))
+		return nullptr;
+
+	return item;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//! Replace the buffer with one twice the size.
+
+template <typename T>
+inline typename WorkStealingDeque<T>::Buffer* WorkStealingDeque<T>::grow(Buffer* buffer, ptrdiff_t top, ptrdiff_t bottom)
+{
+	Buffer* bigger = new Buffer(2 * (buffer->m_mask + 1), buffer);
+
+	for (ptrdiff_t index = top; index != bottom; ++index)
+		bigger->set(index, buffer->get(index));
+
+	atomicStore(m_buffer, bigger, MEMORY_ORDER_RELEASE);
+
+	return bigger;
+}
+
+//namespace Core
+}
+
+#endif // CORE_WORKSTEALINGDEQUE_HPP